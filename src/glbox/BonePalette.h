@@ -0,0 +1,177 @@
+#ifndef BONEPALETTE_H
+#define BONEPALETTE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+// GLSL strana palety - vlozit za #version; bone(i) = matice kosti i aktualniho modelu
+#define BONE_PALETTE_GLSL                                                 \
+    "uniform samplerBuffer uBonePalette;\n"                               \
+    "uniform int uBoneBase;\n"  /* -1 = model bez useku (plna paleta), kresli se bez skinningu */ \
+    "mat4 bone(int i) {\n"                                                \
+    "    if (uBoneBase < 0) return mat4(1.0);\n"                         \
+    "    int t = (uBoneBase + i) * 4;\n"                                  \
+    "    return mat4(texelFetch(uBonePalette, t), texelFetch(uBonePalette, t + 1),\n" \
+    "                texelFetch(uBonePalette, t + 2), texelFetch(uBonePalette, t + 3));\n" \
+    "}\n"
+
+// =========================================================================================
+// Paleta kosti vsech skinovanych modelu v jednom texture bufferu (GL_RGBA32F, 4 texely
+// = sloupce mat4). Kazdy model ma vlastni souvisly usek (Allocate), matice zapisuje jednou
+// za frame do CPU kopie a shader ji cte pres uBoneBase - shadow i barevny pruchod ctou
+// stejna data. Zmeneny rozsah se nahraje jednim glBufferSubData pri prvnim Bind(),
+// takze 100 postav = jeden update bufferu misto stovek glUniformMatrix4fv.
+// =========================================================================================
+class BonePalette {
+
+public:
+    static constexpr int TEXTURE_UNIT = 15;   // mimo jednotky materialu (PbrMaterial 0-6, ModelFBX 0-3)
+
+    struct Stats {
+        unsigned int uploads = 0;     // glBufferSubData / glBufferData volani
+        size_t uploadedBytes = 0;
+    };
+
+    static BonePalette& Get() {
+        static BonePalette instance;
+        return instance;
+    }
+
+    BonePalette(const BonePalette&) = delete;
+    BonePalette& operator=(const BonePalette&) = delete;
+
+    // Usek pro count kosti; vraci index prvni kosti (uBoneBase), -1 = pres limit GL
+    // (model se pak kresli bez skinningu, hlasi se jen prvni selhani do dalsiho Free)
+    GLint Allocate(size_t count) {
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+            if (it->count < count) continue;
+            GLint base = it->base;
+            it->base += static_cast<GLint>(count);
+            it->count -= count;
+            if (it->count == 0) freeRanges.erase(it);
+            return base;
+        }
+        size_t base = bones.size();
+        if ((base + count) * 4 > MaxTexels()) {
+            if (!overflowReported) {
+                std::cerr << "BonePalette: prekrocen GL_MAX_TEXTURE_BUFFER_SIZE (" << base + count
+                          << " kosti), model se kresli bez skinningu" << std::endl;
+                overflowReported = true;
+            }
+            return -1;
+        }
+        bones.resize(base + count, glm::mat4(1.0f));
+        return static_cast<GLint>(base);
+    }
+
+    // Vrati usek; sousedni volne useky se slouci a volny konec palety se zkrati
+    void Free(GLint base, size_t count) {
+        if (base < 0 || count == 0) return;
+        auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), base,
+                                     [](const Range& r, GLint b) { return r.base < b; });
+        if (next != freeRanges.end() && base + static_cast<GLint>(count) == next->base) {
+            count += next->count;
+            next = freeRanges.erase(next);
+        }
+        if (next != freeRanges.begin() && std::prev(next)->base + static_cast<GLint>(std::prev(next)->count) == base) {
+            std::prev(next)->count += count;
+        } else {
+            freeRanges.insert(next, {base, count});
+        }
+        if (!freeRanges.empty() && freeRanges.back().base + freeRanges.back().count == bones.size()) {
+            bones.resize(static_cast<size_t>(freeRanges.back().base));
+            freeRanges.pop_back();
+        }
+        overflowReported = false;
+    }
+
+    // Zapis matic modelu (CPU kopie); nahraje se az pri Bind
+    void Write(GLint base, size_t index, const glm::mat4& matrix) {
+        size_t i = static_cast<size_t>(base) + index;
+        bones[i] = matrix;
+        dirtyBegin = std::min(dirtyBegin, i);
+        dirtyEnd = std::max(dirtyEnd, i + 1);
+    }
+
+    // Nahraje zmeny a navaze texture buffer na TEXTURE_UNIT; aktivni jednotku necha na 0
+    void Bind() {
+        if (!texture) Create();
+        Upload();
+        glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    const Stats& GetStats() const { return stats; }
+    size_t Size() const { return bones.size(); }
+    void ResetStats() { stats = Stats(); }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        if (texture) glDeleteTextures(1, &texture);
+        if (buffer) glDeleteBuffers(1, &buffer);
+        texture = buffer = 0;
+        capacity = 0;
+        dirtyBegin = 0;
+        dirtyEnd = bones.size();
+    }
+
+private:
+    struct Range {
+        GLint base;
+        size_t count;
+    };
+
+    std::vector<glm::mat4> bones;
+    std::vector<Range> freeRanges;    // serazene podle base, bez sousedicich useku
+    bool overflowReported = false;
+    size_t dirtyBegin = SIZE_MAX, dirtyEnd = 0;
+    GLuint buffer = 0, texture = 0;
+    size_t capacity = 0;          // v kostech
+    Stats stats;
+
+    BonePalette() = default;
+
+    static size_t MaxTexels() {
+        GLint texels = 65536;     // minimum dle specifikace
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+        return static_cast<size_t>(texels);
+    }
+
+    void Create() {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &texture);
+    }
+
+    void Upload() {
+        dirtyEnd = std::min(dirtyEnd, bones.size());
+        if (bones.empty() || dirtyBegin >= dirtyEnd) return;
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        if (bones.size() > capacity) {
+            // novy buffer (i pro nove useky) - nahraje se cely
+            capacity = bones.size() + bones.size() / 2;
+            glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, bones.size() * sizeof(glm::mat4), bones.data());
+            glBindTexture(GL_TEXTURE_BUFFER, texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+            stats.uploadedBytes += bones.size() * sizeof(glm::mat4);
+        } else {
+            size_t count = dirtyEnd - dirtyBegin;
+            glBufferSubData(GL_TEXTURE_BUFFER, dirtyBegin * sizeof(glm::mat4), count * sizeof(glm::mat4),
+                            bones.data() + dirtyBegin);
+            stats.uploadedBytes += count * sizeof(glm::mat4);
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        stats.uploads++;
+        dirtyBegin = SIZE_MAX;
+        dirtyEnd = 0;
+    }
+};
+
+#endif // BONEPALETTE_H
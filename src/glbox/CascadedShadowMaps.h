@@ -0,0 +1,211 @@
+#ifndef CASCADEDSHADOWMAPS_H
+#define CASCADEDSHADOWMAPS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include "FrameUniforms.h"
+#include "IndirectDraw.h"
+
+// =========================================================================================
+// Cascaded shadow maps pro smerove svetlo. Frustum kamery (do maxDistance) se rozdeli
+// "practical" schematem (mix logaritmickych a rovnomernych hranic, splitLambda) na az
+// MAX_CASCADES useku; kazdy usek ma vlastni ortho projekci ve vrstve jedne
+// GL_TEXTURE_2D_ARRAY. Projekce se stavi z obalove koule useku (polomer nezavisi na
+// natoceni kamery) a stred se zaokrouhli na texel - stiny pri pohybu kamery neblikaji.
+// 4 x 2048^2 = stejna pamet jako jedna 4096^2 mapa.
+// Matice, hranice (vzdalenost v prostoru kamery) a pocet kaskad jdou do FrameData
+// (cascadeMatrices, cascadeSplits, shadowParams.x), depth shadery je ctou pres
+// SHADOW_CASTER_GLSL a uniform shadowCascade. CascadeMask urci kaskady, do kterych
+// caster zasahuje (RenderQueue::SubmitShadowCascades kresli jen tam).
+// Vrstvy muzou jit jednim pruchodem (layered): indirect depth program zapisuje gl_Layer
+// z vertex shaderu (ARB_shader_viewport_layer_array), bez geometry shaderu.
+// =========================================================================================
+class CascadedShadowMaps {
+
+public:
+    static constexpr int MAX_CASCADES = FrameData::MAX_CASCADES;
+    static constexpr int TEXTURE_UNIT = 7;    // za jednotkami materialu (PbrMaterial 0-6)
+
+    bool enabled = true;
+    bool layered = true;          // vsechny kaskady jednim multi-draw (je-li LayeredSupported)
+    int cascadeCount = MAX_CASCADES;
+    float splitLambda = 0.75f;    // 0 = rovnomerne, 1 = logaritmicke hranice
+    float maxDistance = 60.0f;    // stiny jen do teto vzdalenosti od kamery
+    float casterMargin = 50.0f;   // prodlouzeni boxu smerem ke svetlu (castery mimo zaber)
+
+    static CascadedShadowMaps& Get() {
+        static CascadedShadowMaps instance;
+        return instance;
+    }
+
+    CascadedShadowMaps(const CascadedShadowMaps&) = delete;
+    CascadedShadowMaps& operator=(const CascadedShadowMaps&) = delete;
+
+    // gl_Layer z vertex shaderu + indirect depth program
+    static bool LayeredSupported() {
+        return IndirectDraw::Supported() &&
+               (GLAD_GL_ARB_shader_viewport_layer_array || GLAD_GL_AMD_vertex_shader_layer);
+    }
+
+    bool Create(int resolution = 2048, int count = MAX_CASCADES) {
+        Release();
+        size = resolution;
+        layers = std::clamp(count, 1, MAX_CASCADES);
+        cascadeCount = layers;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, size, size, layers, 0,
+                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        const float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+        // sampler2DArrayShadow: bilinearni compare v hardware (ShadowFilter), PCSS cte surovou hloubku
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "CascadedShadowMaps: framebuffer neni kompletni (0x" << std::hex << status
+                      << std::dec << ")" << std::endl;
+            Release();
+            return false;
+        }
+        return true;
+    }
+
+    // Kaskady pro aktualni kameru; lightDir = smer, kterym svetlo sviti (od svetla ke scene).
+    // Zapise matice, hranice a pocet do frame (pred FrameUniforms::Upload).
+    void Update(const glm::mat4& view, float fovY, float aspect, float nearPlane, float farPlane,
+                const glm::vec3& lightDir, FrameData& frame) {
+        if (!Active()) {
+            count = 0;
+            frame.shadowParams.x = 0.0f;
+            return;
+        }
+        count = std::clamp(cascadeCount, 1, layers);
+
+        const glm::vec3 dir = glm::normalize(lightDir);
+        const glm::vec3 up = std::abs(dir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        lightView = glm::lookAt(glm::vec3(0.0f), dir, up);
+
+        const glm::mat4 invView = glm::inverse(view);
+        const float farShadow = std::max(std::min(farPlane, maxDistance), nearPlane * 2.0f);
+        const float tanY = std::tan(fovY * 0.5f);
+        const float tanX = tanY * aspect;
+
+        float sliceNear = nearPlane;
+        for (int c = 0; c < count; ++c) {
+            const float t = static_cast<float>(c + 1) / static_cast<float>(count);
+            const float logSplit = nearPlane * std::pow(farShadow / nearPlane, t);
+            const float uniformSplit = nearPlane + (farShadow - nearPlane) * t;
+            const float sliceFar = splitLambda * logSplit + (1.0f - splitLambda) * uniformSplit;
+
+            // obalova koule useku: stred na ose kamery, polomer = nejvzdalenejsi roh
+            const float centerDepth = 0.5f * (sliceNear + sliceFar);
+            float radius = 0.0f;
+            for (float d : {sliceNear, sliceFar}) {
+                const glm::vec2 corner(d * tanX, d * tanY);
+                radius = std::max(radius, glm::length(glm::vec3(corner, d - centerDepth)));
+            }
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            glm::vec3 center = glm::vec3(lightView * invView * glm::vec4(0.0f, 0.0f, -centerDepth, 1.0f));
+            const float texel = 2.0f * radius / static_cast<float>(size);
+            center.x = std::floor(center.x / texel) * texel;
+            center.y = std::floor(center.y / texel) * texel;
+
+            // svetlo se diva po -z: blizko svetla = vetsi z (+ casterMargin pro stinici objekty)
+            boxMin[c] = glm::vec3(center.x - radius, center.y - radius, center.z - radius);
+            boxMax[c] = glm::vec3(center.x + radius, center.y + radius, center.z + radius + casterMargin);
+            const glm::mat4 projection = glm::ortho(boxMin[c].x, boxMax[c].x, boxMin[c].y, boxMax[c].y,
+                                                    -boxMax[c].z, -boxMin[c].z);
+            matrices[c] = projection * lightView;
+            frame.cascadeMatrices[c] = matrices[c];
+            frame.cascadeSplits[c] = sliceFar;
+            sliceNear = sliceFar;
+        }
+        for (int c = count; c < MAX_CASCADES; ++c) frame.cascadeSplits[c] = 0.0f;
+        frame.shadowParams.x = static_cast<float>(count);
+    }
+
+    // Bitova maska kaskad, jejichz box protina AABB ve svete
+    uint32_t CascadeMask(const glm::vec3& worldMin, const glm::vec3& worldMax) const {
+        const glm::vec3 center = glm::vec3(lightView * glm::vec4(0.5f * (worldMin + worldMax), 1.0f));
+        const glm::vec3 half = 0.5f * (worldMax - worldMin);
+        glm::vec3 extent(0.0f);
+        for (int col = 0; col < 3; ++col)
+            extent += glm::abs(glm::vec3(lightView[col])) * half[col];
+
+        const glm::vec3 lo = center - extent, hi = center + extent;
+        uint32_t mask = 0;
+        for (int c = 0; c < count; ++c) {
+            if (glm::all(glm::lessThanEqual(lo, boxMax[c])) && glm::all(glm::greaterThanEqual(hi, boxMin[c])))
+                mask |= 1u << c;
+        }
+        return mask;
+    }
+
+    uint32_t AllCascades() const { return (1u << count) - 1u; }
+
+    // Jedna vrstva jako depth cil (clear = vycistit pred kreslenim)
+    void BeginCascade(int cascade, bool clear = true) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, cascade);
+        glViewport(0, 0, size, size);
+        if (clear) glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Vsechny vrstvy najednou (vrstvu vybira gl_Layer); clear = vycistit celou texturu
+    void BeginLayered(bool clear = true) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0);
+        glViewport(0, 0, size, size);
+        if (clear) glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    bool Active() const { return enabled && texture != 0; }
+    bool Layered() const { return layered && LayeredSupported(); }
+    int Count() const { return count; }
+    const glm::mat4& Matrix(int cascade) const { return matrices[cascade]; }
+    int Resolution() const { return size; }
+    GLuint Texture() const { return texture; }
+    size_t MemoryBytes() const { return static_cast<size_t>(size) * size * layers * 4; }   // DEPTH24 = 4 B/texel
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (texture) glDeleteTextures(1, &texture);
+        fbo = texture = 0;
+        count = 0;
+    }
+
+private:
+    GLuint texture = 0, fbo = 0;
+    int size = 0;
+    int layers = 0;
+    int count = 0;                            // kaskady v poslednim Update
+    glm::mat4 lightView = glm::mat4(1.0f);
+    glm::mat4 matrices[MAX_CASCADES];         // projekce * lightView (kopie FrameData::cascadeMatrices)
+    glm::vec3 boxMin[MAX_CASCADES], boxMax[MAX_CASCADES];   // ortho boxy v prostoru svetla
+
+    CascadedShadowMaps() = default;
+};
+
+#endif // CASCADEDSHADOWMAPS_H
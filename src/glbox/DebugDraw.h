@@ -6,6 +6,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glad/glad.h>
 #include <iostream>
+#include <chrono>
+#include "ShaderReflection.h"
+#include "ProgramBinaryCache.h"
 
 
 const char* debugVertexShaderSource = R"(
@@ -32,6 +35,10 @@ private:
     unsigned int shaderProgram;
     unsigned int VBO, VAO;
 
+    ProgramReflection* reflection = nullptr;
+    UniformHandle<glm::mat4> uView, uProjection;
+    UniformHandle<glm::vec3> uColor;
+
     void checkShaderCompileErrors(unsigned int shader, std::string type) {
         int success;
         char infoLog[1024];
@@ -52,25 +59,37 @@ private:
 
 public:
     DebugDraw() {
-        // Kompilace a Linkování
-        unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &debugVertexShaderSource, NULL);
-        glCompileShader(vertex);
-        checkShaderCompileErrors(vertex, "VERTEX");
-
-        unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &debugFragmentShaderSource, NULL);
-        glCompileShader(fragment);
-        checkShaderCompileErrors(fragment, "FRAGMENT");
-
-        shaderProgram = glCreateProgram();
-        glAttachShader(shaderProgram, vertex);
-        glAttachShader(shaderProgram, fragment);
-        glLinkProgram(shaderProgram);
-        checkShaderCompileErrors(shaderProgram, "PROGRAM");
-
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        // Kompilace a Linkování (pri warm startu binarka z disku)
+        shaderProgram = ProgramBinaryCache::Get().Load(debugVertexShaderSource, debugFragmentShaderSource);
+        if (!shaderProgram) {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+            glShaderSource(vertex, 1, &debugVertexShaderSource, NULL);
+            glCompileShader(vertex);
+            checkShaderCompileErrors(vertex, "VERTEX");
+
+            unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
+            glShaderSource(fragment, 1, &debugFragmentShaderSource, NULL);
+            glCompileShader(fragment);
+            checkShaderCompileErrors(fragment, "FRAGMENT");
+
+            shaderProgram = glCreateProgram();
+            glAttachShader(shaderProgram, vertex);
+            glAttachShader(shaderProgram, fragment);
+            ProgramBinaryCache::Get().PrepareLink(shaderProgram);
+            glLinkProgram(shaderProgram);
+            checkShaderCompileErrors(shaderProgram, "PROGRAM");
+
+            glDeleteShader(vertex);
+            glDeleteShader(fragment);
+            ProgramBinaryCache::Get().Store(debugVertexShaderSource, debugFragmentShaderSource, shaderProgram,
+                std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count());
+        }
+
+        reflection = &ProgramReflection::For(shaderProgram);
+        uView = reflection->Handle<glm::mat4>("view"_u);
+        uProjection = reflection->Handle<glm::mat4>("projection"_u);
+        uColor = reflection->Handle<glm::vec3>("color"_u);
 
         // Nastavení VAO/VBO pro dynamické kreslení čar
         glGenVertexArrays(1, &VAO);
@@ -90,6 +109,7 @@ public:
     }
 
     ~DebugDraw() {
+        ProgramReflection::Forget(shaderProgram);
         glDeleteProgram(shaderProgram);
         glDeleteBuffers(1, &VBO);
         glDeleteVertexArrays(1, &VAO);
@@ -100,9 +120,9 @@ public:
         glUseProgram(shaderProgram);
 
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "color"), 1, glm::value_ptr(color));
+        reflection->Set(uView, view);
+        reflection->Set(uProjection, projection);
+        reflection->Set(uColor, color);
 
         // Nahraj data čáry (jen 2 body)
         glm::vec3 vertices[] = { start, end };
@@ -0,0 +1,112 @@
+#ifndef DEPTHPREPASS_H
+#define DEPTHPREPASS_H
+
+#include <glad/glad.h>
+
+// =========================================================================================
+// Depth pre-pass: opaque geometrie se nejdriv vykresli jen do depth (pozicni depth program
+// jako shadow pruchod), barevny pruchod pak bezi s GL_EQUAL a bez zapisu depth, takze
+// drahy PBR fragment shader (GGX, IBL, PCF) bezi pro kazdy pixel jen jednou.
+// Vyplati se jen pri velkem prekryvu - overdraw se meri GL_SAMPLES_PASSED
+// (fragmenty prosle depth testem bez pre-passu / pixely viewportu) a s autoToggle se
+// pre-pass zapina/vypina s hysterezi. Vysledky se ctou az po RING_SIZE framech.
+// =========================================================================================
+class DepthPrePass {
+
+public:
+    static constexpr int RING_SIZE = 3;
+
+    struct Stats {
+        double overdraw = 0.0;            // klouzavy prumer: stinovane fragmenty / pixel
+        double fragments = 0.0;           // posledni zmereny pocet fragmentu
+        unsigned int toggles = 0;         // automaticka prepnuti
+    };
+
+    bool enabled = false;
+    bool autoToggle = false;
+    float enableAbove = 1.5f;             // autoToggle: zapnout nad timto overdraw
+    float disableBelow = 1.2f;            // ... vypnout pod timto
+
+    static DepthPrePass& Get() {
+        static DepthPrePass instance;
+        return instance;
+    }
+
+    DepthPrePass(const DepthPrePass&) = delete;
+    DepthPrePass& operator=(const DepthPrePass&) = delete;
+
+    // Kolem pruchodu, jehoz fragmenty by se stinovaly bez pre-passu
+    // (s pre-passem depth pruchod s GL_LESS, jinak barevny opaque pruchod)
+    void BeginMeasure() {
+        Slot& s = slots[current];
+        if (active || s.used) return;
+        if (!s.query) glGenQueries(1, &s.query);
+        GLint viewport[4] = {0, 0, 0, 0};
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        s.pixels = static_cast<double>(viewport[2]) * viewport[3];
+        glBeginQuery(GL_SAMPLES_PASSED, s.query);
+        active = true;
+    }
+
+    void EndMeasure() {
+        if (!active) return;
+        glEndQuery(GL_SAMPLES_PASSED);
+        slots[current].used = true;
+        active = false;
+    }
+
+    // Na konci framu: precte nejstarsi mereni a pripadne prepne pre-pass
+    void EndFrame() {
+        current = (current + 1) % RING_SIZE;
+        Slot& s = slots[current];
+        if (!s.used) return;
+        s.used = false;
+
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(s.query, GL_QUERY_RESULT, &samples);
+        stats.fragments = static_cast<double>(samples);
+        double overdraw = s.pixels > 0.0 ? stats.fragments / s.pixels : 0.0;
+        stats.overdraw = measured ? stats.overdraw + (overdraw - stats.overdraw) * SMOOTHING : overdraw;
+        measured = true;
+
+        if (!autoToggle) return;
+        if (!enabled && stats.overdraw > enableAbove) {
+            enabled = true;
+            stats.toggles++;
+        } else if (enabled && stats.overdraw < disableBelow) {
+            enabled = false;
+            stats.toggles++;
+        }
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        for (Slot& s : slots) {
+            if (s.query) glDeleteQueries(1, &s.query);
+            s = Slot();
+        }
+        active = false;
+        measured = false;
+    }
+
+private:
+    static constexpr double SMOOTHING = 0.1;
+
+    struct Slot {
+        GLuint query = 0;
+        double pixels = 0.0;
+        bool used = false;
+    };
+
+    Slot slots[RING_SIZE];
+    int current = 0;
+    bool active = false;
+    bool measured = false;
+    Stats stats;
+
+    DepthPrePass() = default;
+};
+
+#endif // DEPTHPREPASS_H
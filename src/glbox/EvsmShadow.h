@@ -0,0 +1,354 @@
+#ifndef EVSMSHADOW_H
+#define EVSMSHADOW_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GLStateCache.h"
+#include "ProgramCache.h"
+#include "ShaderReflection.h"
+
+// Warp hloubky a vyhodnoceni momentu - sdili filtracni pruchody i materialy.
+// 32F momenty: e^(2 * 40) je jeste v rozsahu floatu.
+#define EVSM_GLSL                                                                           \
+    "const vec2 EVSM_EXPONENTS = vec2(40.0, 5.0);\n"                                        \
+    "const float EVSM_BLEED_REDUCTION = 0.25;\n"                                            \
+    "vec2 EvsmWarp(float depth) {\n"                                                        \
+    "    depth = 2.0 * depth - 1.0;\n"                                                      \
+    "    return vec2(exp(EVSM_EXPONENTS.x * depth), -exp(-EVSM_EXPONENTS.y * depth));\n"     \
+    "}\n"                                                                                   \
+    "vec4 EvsmMoments(float depth) {\n"                                                     \
+    "    vec2 w = EvsmWarp(depth);\n"                                                       \
+    "    return vec4(w.x, w.x * w.x, w.y, w.y * w.y);\n"                                    \
+    "}\n"                                                                                   \
+    "float EvsmChebyshev(vec2 moments, float mean, float minVariance) {\n"                  \
+    "    if (mean <= moments.x) return 1.0;\n"                                              \
+    "    float variance = max(moments.y - moments.x * moments.x, minVariance);\n"           \
+    "    float d = mean - moments.x;\n"                                                     \
+    "    return variance / (variance + d * d);\n"                                           \
+    "}\n"                                                                                   \
+    "float EvsmVisibility(vec4 moments, float depth) {\n"                                   \
+    "    vec2 w = EvsmWarp(depth);\n"                                                       \
+    "    vec2 scale = 0.0001 * EVSM_EXPONENTS * abs(w);\n"                                  \
+    "    float lit = min(EvsmChebyshev(moments.xy, w.x, scale.x * scale.x),\n"              \
+    "                    EvsmChebyshev(moments.zw, w.y, scale.y * scale.y));\n"             \
+    "    return clamp((lit - EVSM_BLEED_REDUCTION) / (1.0 - EVSM_BLEED_REDUCTION), 0.0, 1.0);\n" \
+    "}\n"                                                                                   \
+    "float ShadowEvsm(sampler2D moments, vec3 coord, vec2 dx, vec2 dy) {\n"                 \
+    "    return 1.0 - EvsmVisibility(textureGrad(moments, coord.xy, dx, dy), coord.z);\n"   \
+    "}\n"                                                                                   \
+    "float ShadowEvsm(sampler2DArray moments, vec3 coord, vec2 dx, vec2 dy, float layer) {\n" \
+    "    return 1.0 - EvsmVisibility(textureGrad(moments, vec3(coord.xy, layer), dx, dy), coord.z);\n" \
+    "}\n"
+
+// =========================================================================================
+// Exponential variance shadow maps (Lauritzen). Depth z existujici shadow mapy (jednoducha
+// 2D i pole CascadedShadowMaps) se po depth pruchodu prevede na momenty
+// (e^(c+ d), e^(2c+ d), -e^(-c- d), e^(-2c- d)) v RGBA32F v rozliseni / downsample -
+// prumer bloku texelu je spravne zfiltrovany moment. Pak separabilni Gauss (H do pomocne
+// textury, V zpet) a glGenerateMipmap, takze material bere jeden trilinearni/anizotropni
+// fetch (ShadowEvsm) misto PCF jadra - siroky mekky stin se filtruje jednou za frame,
+// ne za pixel. Castery, depth programy i ShadowCache zustavaji beze zmeny.
+// Rezim svetla: ShadowFilter::Kernel::Evsm (FrameData.shadowParams.y), po shadow pruchodu
+// zavolat Filter. Pamet: 16 B/texel + mipmapy.
+// =========================================================================================
+class EvsmShadow {
+
+public:
+    static constexpr int TEXTURE_UNIT = 10;            // momenty jednoduche mapy (sampler2D)
+    static constexpr int CASCADE_TEXTURE_UNIT = 11;    // momenty kaskad (sampler2DArray)
+
+    int downsample = 2;       // 1 = plne rozliseni shadow mapy, 2 = polovina, 4 = ctvrtina
+    int blurRadius = 3;       // polomer Gaussu v texelech momentu, 0 = bez rozmazani
+    bool anisotropic = true;
+
+    struct Stats {
+        unsigned int layers = 0;      // vrstvy prefiltrovane v poslednim Filter
+        double filterMs = 0.0;        // CPU cas zadani pruchodu
+    };
+
+    static EvsmShadow& Get() {
+        static EvsmShadow instance;
+        return instance;
+    }
+
+    EvsmShadow(const EvsmShadow&) = delete;
+    EvsmShadow& operator=(const EvsmShadow&) = delete;
+
+    static bool AnisotropySupported() {
+        return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_texture_filter_anisotropic || GLAD_GL_EXT_texture_filter_anisotropic;
+    }
+
+    // Depth textura (GL_TEXTURE_2D nebo GL_TEXTURE_2D_ARRAY) -> momenty prvnich layers vrstev.
+    // Meni framebuffer a viewport (volat mezi shadow a barevnym pruchodem).
+    void Filter(GLuint depthTexture, GLenum target, int layers = 1) {
+        auto start = std::chrono::high_resolution_clock::now();
+        stats.layers = 0;
+        Target& t = target == GL_TEXTURE_2D_ARRAY ? cascadeTarget : singleTarget;
+        if (!EnsureTarget(t, depthTexture, target)) return;
+        layers = std::clamp(layers, 0, t.layers);
+        const bool array = target == GL_TEXTURE_2D_ARRAY;
+
+        GLStateCache& cache = GLStateCache::Get();
+        cache.Invalidate();
+        cache.SetBlend(false);
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, t.width, t.height);
+        cache.BindVertexArray(emptyVAO);
+        // texelFetch z depth textury s compare mode je nedefinovany - sampler bez compare
+        glBindSampler(SOURCE_UNIT, sourceSampler);
+
+        const int radius = std::max(blurRadius, 0);
+        for (int layer = 0; layer < layers; ++layer) {
+            // 1) depth -> momenty (prumer bloku downsample x downsample)
+            AttachLayer(t, layer);
+            GLuint resolve = array ? Program(resolveArrayProgram, true, true) : Program(resolveProgram, true, false);
+            Draw(cache, resolve, target, depthTexture, layer, t, 0);
+            if (radius > 0) {
+                // 2) horizontalne do pomocne textury, 3) vertikalne zpet do vrstvy
+                glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, blurTexture, 0);
+                GLuint blurH = array ? Program(blurArrayProgram, false, true) : Program(blurProgram, false, false);
+                Draw(cache, blurH, target, t.texture, layer, t, radius, 1, 0);
+                AttachLayer(t, layer);
+                Draw(cache, Program(blurProgram, false, false), GL_TEXTURE_2D, blurTexture, 0, t, radius, 0, 1);
+            }
+            stats.layers++;
+        }
+
+        glBindSampler(SOURCE_UNIT, 0);
+        cache.BindTexture(SOURCE_UNIT, target, 0);
+        cache.BindTexture(SOURCE_UNIT, GL_TEXTURE_2D, 0);
+        cache.BindVertexArray(0);
+        cache.UseProgram(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
+
+        // 4) mipmapy pro trilinearni / anizotropni cteni
+        glBindTexture(target, t.texture);
+        glGenerateMipmap(target);
+        glBindTexture(target, 0);
+        cache.Invalidate();
+        stats.filterMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // Momenty pro material (0 = zatim nefiltrovano - sampler vrati nuly, rezim se nepouziva)
+    GLuint Texture() const { return singleTarget.texture; }
+    GLuint CascadeTexture() const { return cascadeTarget.texture; }
+
+    const Stats& GetStats() const { return stats; }
+
+    size_t MemoryBytes() const {
+        size_t bytes = 0;
+        for (const Target* t : {&singleTarget, &cascadeTarget})
+            bytes += static_cast<size_t>(t->width) * t->height * t->layers * 16 * 4 / 3;   // + mipmapy
+        return bytes + static_cast<size_t>(blurWidth) * blurHeight * 16;
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        ReleaseTarget(singleTarget);
+        ReleaseTarget(cascadeTarget);
+        if (blurTexture) glDeleteTextures(1, &blurTexture);
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (emptyVAO) glDeleteVertexArrays(1, &emptyVAO);
+        if (sourceSampler) glDeleteSamplers(1, &sourceSampler);
+        blurTexture = fbo = emptyVAO = sourceSampler = 0;
+        blurWidth = blurHeight = 0;
+        resolveProgram.reset();
+        resolveArrayProgram.reset();
+        blurProgram.reset();
+        blurArrayProgram.reset();
+    }
+
+private:
+    static constexpr int SOURCE_UNIT = 12;             // zdroj filtracnich pruchodu
+
+    struct Target {
+        GLuint texture = 0;
+        GLenum target = GL_TEXTURE_2D;
+        GLsizei width = 0, height = 0, layers = 0;
+        int downsample = 0;
+    };
+
+    Target singleTarget, cascadeTarget;
+    GLuint blurTexture = 0, fbo = 0, emptyVAO = 0, sourceSampler = 0;
+    GLsizei blurWidth = 0, blurHeight = 0;
+    ProgramHandle resolveProgram, resolveArrayProgram, blurProgram, blurArrayProgram;
+    Stats stats;
+
+    EvsmShadow() = default;
+
+    // Cil s rozmery podle zdroje / downsample; pri zmene se znovu vytvori
+    bool EnsureTarget(Target& t, GLuint depthTexture, GLenum target) {
+        GLint width = 0, height = 0, layers = 1;
+        glBindTexture(target, depthTexture);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_HEIGHT, &height);
+        if (target == GL_TEXTURE_2D_ARRAY) glGetTexLevelParameteriv(target, 0, GL_TEXTURE_DEPTH, &layers);
+        glBindTexture(target, 0);
+        if (width <= 0 || height <= 0) return false;
+
+        const int scale = std::clamp(downsample, 1, 4);
+        const GLsizei w = std::max(width / scale, 1), h = std::max(height / scale, 1);
+        if (!fbo) {
+            glGenFramebuffers(1, &fbo);
+            glGenVertexArrays(1, &emptyVAO);
+            glGenSamplers(1, &sourceSampler);
+            glSamplerParameteri(sourceSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glSamplerParameteri(sourceSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glSamplerParameteri(sourceSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+        }
+        if (w != blurWidth || h != blurHeight) {
+            if (blurTexture) glDeleteTextures(1, &blurTexture);
+            glGenTextures(1, &blurTexture);
+            glBindTexture(GL_TEXTURE_2D, blurTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, w, h, 0, GL_RGBA, GL_FLOAT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            blurWidth = w;
+            blurHeight = h;
+        }
+        if (t.texture && t.width == w && t.height == h && t.layers == layers && t.downsample == scale)
+            return true;
+
+        ReleaseTarget(t);
+        t.target = target;
+        t.width = w;
+        t.height = h;
+        t.layers = layers;
+        t.downsample = scale;
+        const GLsizei levels = 1 + static_cast<GLsizei>(std::floor(std::log2(static_cast<float>(std::max(w, h)))));
+        glGenTextures(1, &t.texture);
+        glBindTexture(target, t.texture);
+        for (GLsizei level = 0; level < levels; ++level) {
+            const GLsizei lw = std::max(w >> level, 1), lh = std::max(h >> level, 1);
+            if (target == GL_TEXTURE_2D_ARRAY)
+                glTexImage3D(target, level, GL_RGBA32F, lw, lh, layers, 0, GL_RGBA, GL_FLOAT, nullptr);
+            else
+                glTexImage2D(target, level, GL_RGBA32F, lw, lh, 0, GL_RGBA, GL_FLOAT, nullptr);
+        }
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        // mimo mapu = momenty hloubky 1.0 (nic nestini)
+        const float borderColor[] = { std::exp(40.0f), std::exp(80.0f), -std::exp(-5.0f), std::exp(-10.0f) };
+        glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, borderColor);
+        if (anisotropic && AnisotropySupported()) {
+            GLfloat maxAnisotropy = 1.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+            glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY, std::min(maxAnisotropy, 8.0f));
+        }
+        glBindTexture(target, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        AttachLayer(t, 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "EvsmShadow: framebuffer neni kompletni (0x" << std::hex << status << std::dec << ")" << std::endl;
+            ReleaseTarget(t);
+            return false;
+        }
+        return true;
+    }
+
+    void ReleaseTarget(Target& t) {
+        if (t.texture) glDeleteTextures(1, &t.texture);
+        t = Target();
+    }
+
+    void AttachLayer(const Target& t, int layer) {
+        if (t.target == GL_TEXTURE_2D_ARRAY)
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, t.texture, 0, layer);
+        else
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, t.texture, 0);
+    }
+
+    // Jeden full-screen trojuhelnik; radius/direction jen pro blur
+    void Draw(GLStateCache& cache, GLuint program, GLenum target, GLuint source, int layer, const Target& t,
+              int radius, int dirX = 0, int dirY = 0) {
+        cache.UseProgram(program);
+        cache.BindTexture(SOURCE_UNIT, target, source);
+        ProgramReflection& r = ProgramReflection::For(program);
+        r.Set(r.Handle<int>("source"_u), SOURCE_UNIT);
+        r.Set(r.Handle<int>("layer"_u), layer);
+        r.Set(r.Handle<int>("scale"_u), t.downsample);
+        r.Set(r.Handle<int>("radius"_u), radius);
+        r.Set(r.Handle<glm::vec2>("direction"_u), glm::vec2(dirX, dirY));
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    GLuint Program(ProgramHandle& program, bool resolve, bool array) {
+        if (!program) {
+            std::vector<std::string> defines;
+            if (array) defines.push_back("ARRAY_SOURCE");
+            if (resolve) defines.push_back("RESOLVE");
+            program = ProgramCache::Get().Acquire(R"glsl(#version 330 core
+void main()
+{
+    // full-screen trojuhelnik bez vertex bufferu
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)glsl", std::string("#version 330 core\n") + EVSM_GLSL + R"glsl(
+#ifdef ARRAY_SOURCE
+uniform sampler2DArray source;
+uniform int layer;
+#define FETCH(p) texelFetch(source, ivec3(p, layer), 0)
+#define SOURCE_SIZE textureSize(source, 0).xy
+#else
+uniform sampler2D source;
+#define FETCH(p) texelFetch(source, p, 0)
+#define SOURCE_SIZE textureSize(source, 0)
+#endif
+out vec4 Moments;
+
+#ifdef RESOLVE
+uniform int scale;
+void main()
+{
+    // depth -> momenty; prumer bloku scale x scale = zmenseni bez ztraty filtrace
+    ivec2 base = ivec2(gl_FragCoord.xy) * scale;
+    vec4 sum = vec4(0.0);
+    for (int y = 0; y < scale; ++y)
+        for (int x = 0; x < scale; ++x)
+            sum += EvsmMoments(FETCH(base + ivec2(x, y)).r);
+    Moments = sum / float(scale * scale);
+}
+#else
+uniform int radius;
+uniform vec2 direction;
+void main()
+{
+    // jeden smer separabilniho Gausse (sigma = radius / 2)
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    ivec2 last = SOURCE_SIZE - 1;
+    float sigma = max(float(radius) * 0.5, 0.5);
+    vec4 sum = vec4(0.0);
+    float weights = 0.0;
+    for (int i = -radius; i <= radius; ++i) {
+        float w = exp(-float(i * i) / (2.0 * sigma * sigma));
+        sum += w * FETCH(clamp(p + ivec2(direction) * i, ivec2(0), last));
+        weights += w;
+    }
+    Moments = sum / weights;
+}
+#endif
+)glsl", defines);
+        }
+        return program->id;
+    }
+};
+
+#endif // EVSMSHADOW_H
@@ -0,0 +1,209 @@
+#ifndef FRAMEUNIFORMS_H
+#define FRAMEUNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstring>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "ShaderReflection.h"
+
+// =========================================================================================
+// Sdilena per-frame data (kamera + svetlo) - std140 uniform blok "FrameData"
+// Plni se jednou za frame, vsechny programy ho ctou z pevneho binding pointu
+// BlockBinding::Frame; per-draw uniformy zustavaji jen pro data objektu.
+// =========================================================================================
+
+// GLSL deklarace bloku - vlozit za #version (retezcova konkatenace literalu)
+#define FRAME_DATA_GLSL                                                   \
+    "layout(std140) uniform FrameData {\n"                                \
+    "    mat4 view;\n"                                                    \
+    "    mat4 projection;\n"                                              \
+    "    mat4 viewProjection;\n"                                          \
+    "    mat4 invView;\n"                                                 \
+    "    mat4 invProjection;\n"                                           \
+    "    mat4 lightSpaceMatrix;\n"                                        \
+    "    vec4 cameraPos;\n"         /* xyz, w = cas [s] */                \
+    "    vec4 lightPos;\n"          /* xyz */                             \
+    "    vec4 lightColor;\n"        /* rgb, a = ambient strength */       \
+    "    vec4 sunDirection;\n"      /* xyz */                             \
+    "    mat4 cascadeMatrices[4];\n" /* light space kaskad (CascadedShadowMaps) */ \
+    "    vec4 cascadeSplits;\n"     /* konec kaskady ve view-space hloubce */ \
+    "    vec4 shadowParams;\n"      /* x = pocet kaskad (0 = jedna mapa, lightSpaceMatrix) */ \
+    "} frame;\n"
+
+// Depth program casteru - matice aktualni kaskady (uniform shadowCascade), bez kaskad lightSpaceMatrix
+#define SHADOW_CASTER_GLSL                                                \
+    "uniform int shadowCascade;\n"                                        \
+    "mat4 shadowCasterMatrix() {\n"                                       \
+    "    return frame.shadowParams.x > 0.0 ? frame.cascadeMatrices[shadowCascade] : frame.lightSpaceMatrix;\n" \
+    "}\n"
+
+// CPU strana - poradi a velikosti musi odpovidat std140 (jen mat4/vec4, bez paddingu)
+struct FrameData {
+    static constexpr int MAX_CASCADES = 4;
+
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::mat4 invView = glm::mat4(1.0f);
+    glm::mat4 invProjection = glm::mat4(1.0f);
+    glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+    glm::vec4 cameraPos = glm::vec4(0.0f);
+    glm::vec4 lightPos = glm::vec4(0.0f);
+    glm::vec4 lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.1f);
+    glm::vec4 sunDirection = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    glm::mat4 cascadeMatrices[MAX_CASCADES] = {glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f)};
+    glm::vec4 cascadeSplits = glm::vec4(0.0f);
+    glm::vec4 shadowParams = glm::vec4(0.0f);
+
+    // kamera + odvozene matice (viewProjection, inverze)
+    void SetCamera(const glm::mat4& v, const glm::mat4& p, const glm::vec3& position, float time) {
+        view = v;
+        projection = p;
+        viewProjection = p * v;
+        invView = glm::inverse(v);
+        invProjection = glm::inverse(p);
+        cameraPos = glm::vec4(position, time);
+    }
+
+    void SetLight(const glm::vec3& position, const glm::vec3& color, float ambientStrength,
+                  const glm::mat4& lightSpace) {
+        lightPos = glm::vec4(position, 1.0f);
+        lightColor = glm::vec4(color, ambientStrength);
+        lightSpaceMatrix = lightSpace;
+    }
+};
+
+static_assert(sizeof(FrameData) == (6 + FrameData::MAX_CASCADES) * sizeof(glm::mat4) + 6 * sizeof(glm::vec4),
+              "FrameData musi odpovidat std140 layoutu bloku");
+
+// =========================================================================================
+// Ring buffer slicu (RING_SIZE framu) v jednom UBO. CPU zapisuje do slice, ktery GPU
+// uz docetl (fence z EndFrame), takze zapis nikdy neceka na rozpracovany frame.
+// S GL 4.4 / ARB_buffer_storage je buffer trvale namapovany (persistent + coherent),
+// jinak se slice plni pres glBufferSubData.
+// =========================================================================================
+class FrameUniforms {
+
+public:
+    static constexpr int RING_SIZE = 3;
+
+    struct Stats {
+        unsigned int frames = 0;
+        unsigned int waits = 0;       // kolikrat musel CPU cekat na fence (GPU o RING_SIZE framu pozadu)
+        double waitMs = 0.0;
+    };
+
+    FrameData data;
+
+    static FrameUniforms& Get() {
+        static FrameUniforms instance;
+        return instance;
+    }
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // Zapise data do dalsiho slice a navaze ho na BlockBinding::Frame
+    void Upload() {
+        if (ubo == 0) Create();
+
+        current = (current + 1) % RING_SIZE;
+        WaitForSlice(current);
+
+        GLintptr offset = static_cast<GLintptr>(current) * sliceStride;
+        if (mapped)
+            std::memcpy(mapped + offset, &data, sizeof(FrameData));
+        else {
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(FrameData), &data);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+
+        glBindBufferRange(GL_UNIFORM_BUFFER, BlockBinding::Frame, ubo, offset, sizeof(FrameData));
+        stats.frames++;
+    }
+
+    // Po poslednim draw callu framu - fence chrani slice pred prepsanim
+    void EndFrame() {
+        if (ubo == 0) return;
+        if (fences[current]) glDeleteSync(fences[current]);
+        fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        for (GLsync& f : fences) {
+            if (f) glDeleteSync(f);
+            f = nullptr;
+        }
+        if (ubo) {
+            if (mapped) {
+                glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+                glUnmapBuffer(GL_UNIFORM_BUFFER);
+                glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            }
+            glDeleteBuffers(1, &ubo);
+        }
+        ubo = 0;
+        mapped = nullptr;
+    }
+
+    const Stats& GetStats() const { return stats; }
+    bool IsPersistent() const { return mapped != nullptr; }
+
+private:
+    GLuint ubo = 0;
+    GLsizeiptr sliceStride = 0;
+    unsigned char* mapped = nullptr;
+    GLsync fences[RING_SIZE] = {};
+    int current = RING_SIZE - 1;
+    Stats stats;
+
+    FrameUniforms() = default;
+    ~FrameUniforms() = default;   // GL objekty uvolnuje Release() (kontext uz muze byt pryc)
+
+    void Create() {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        GLsizeiptr a = static_cast<GLsizeiptr>(alignment);
+        sliceStride = (static_cast<GLsizeiptr>(sizeof(FrameData)) + a - 1) / a * a;
+        GLsizeiptr total = sliceStride * RING_SIZE;
+
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_UNIFORM_BUFFER, total, nullptr, flags | GL_DYNAMIC_STORAGE_BIT);
+            mapped = static_cast<unsigned char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, total, flags));
+            if (!mapped)
+                std::cerr << "warn: FrameUniforms persistent map failed, using glBufferSubData" << std::endl;
+        } else {
+            glBufferData(GL_UNIFORM_BUFFER, total, nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void WaitForSlice(int slice) {
+        GLsync fence = fences[slice];
+        if (!fence) return;
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            auto start = std::chrono::high_resolution_clock::now();
+            stats.waits++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+            } while (result == GL_TIMEOUT_EXPIRED);
+            stats.waitMs += std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+        }
+        glDeleteSync(fence);
+        fences[slice] = nullptr;
+    }
+};
+
+#endif // FRAMEUNIFORMS_H
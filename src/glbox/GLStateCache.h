@@ -0,0 +1,137 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <glad/glad.h>
+
+// =========================================================================================
+// Stinova kopie GL stavu - zahodi redundantni glUseProgram / glBindTexture /
+// glBindVertexArray / blend / color mask zmeny. Kod mimo cache (ImGui, sky, ModelFBX...) meni stav
+// primo, proto se pred kazdou davkou vola Invalidate() - pak se prvni volani vzdy posle.
+// =========================================================================================
+class GLStateCache {
+
+public:
+    static constexpr int MAX_UNITS = 16;
+
+    // requested = kolik volani by poslal kod bez cache, issued = kolik opravdu slo do GL
+    struct Counter {
+        unsigned int requested = 0;
+        unsigned int issued = 0;
+        unsigned int Skipped() const { return requested - issued; }
+    };
+
+    struct Stats {
+        Counter program, texture, vao, blend, colorMask;
+        void Reset() { *this = Stats(); }
+    };
+
+    static GLStateCache& Get() {
+        static GLStateCache instance;
+        return instance;
+    }
+
+    Stats stats;
+
+    // Zapomene zname hodnoty (stav mohl zmenit kdokoli mimo cache)
+    void Invalidate() {
+        program = INVALID;
+        vao = INVALID;
+        activeUnit = INVALID;
+        blendKnown = false;
+        colorMaskKnown = false;
+        for (int i = 0; i < MAX_UNITS; ++i) {
+            tex2D[i] = INVALID;
+            texCube[i] = INVALID;
+            tex2DArray[i] = INVALID;
+        }
+    }
+
+    void UseProgram(GLuint id) {
+        stats.program.requested++;
+        if (program == id) return;
+        glUseProgram(id);
+        program = id;
+        stats.program.issued++;
+    }
+
+    void BindVertexArray(GLuint id) {
+        stats.vao.requested++;
+        if (vao == id) return;
+        glBindVertexArray(id);
+        vao = id;
+        stats.vao.issued++;
+    }
+
+    // target GL_TEXTURE_2D nebo GL_TEXTURE_CUBE_MAP
+    void BindTexture(int unit, GLenum target, GLuint id) {
+        stats.texture.requested++;
+        GLuint* slot = Slot(unit, target);
+        if (slot && *slot == id) return;
+        if (activeUnit != static_cast<GLuint>(unit)) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = static_cast<GLuint>(unit);
+        }
+        glBindTexture(target, id);
+        if (slot) *slot = id;
+        stats.texture.issued++;
+    }
+
+    // Blend on/off + funkce (SRC_ALPHA, ONE_MINUS_SRC_ALPHA jako zbytek repa)
+    void SetBlend(bool enable, GLenum src = GL_SRC_ALPHA, GLenum dst = GL_ONE_MINUS_SRC_ALPHA) {
+        stats.blend.requested++;
+        if (blendKnown && blendEnabled == enable && (!enable || (blendSrc == src && blendDst == dst)))
+            return;
+        if (enable) {
+            glEnable(GL_BLEND);
+            glBlendFunc(src, dst);
+            blendSrc = src;
+            blendDst = dst;
+        } else {
+            glDisable(GL_BLEND);
+        }
+        blendEnabled = enable;
+        blendKnown = true;
+        stats.blend.issued++;
+    }
+
+    // Zapis barvy do vsech kanalu on/off (depth-only pruchody do barevneho cile)
+    void SetColorMask(bool enable) {
+        stats.colorMask.requested++;
+        if (colorMaskKnown && colorMaskEnabled == enable) return;
+        const GLboolean mask = enable ? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask);
+        colorMaskEnabled = enable;
+        colorMaskKnown = true;
+        stats.colorMask.issued++;
+    }
+
+    GLuint CurrentProgram() const { return program; }
+
+private:
+    static constexpr GLuint INVALID = 0xFFFFFFFFu;
+
+    GLuint program = INVALID;
+    GLuint vao = INVALID;
+    GLuint activeUnit = INVALID;
+    GLuint tex2D[MAX_UNITS];
+    GLuint texCube[MAX_UNITS];
+    GLuint tex2DArray[MAX_UNITS];
+    bool blendKnown = false;
+    bool blendEnabled = false;
+    GLenum blendSrc = GL_SRC_ALPHA;
+    GLenum blendDst = GL_ONE_MINUS_SRC_ALPHA;
+    bool colorMaskKnown = false;
+    bool colorMaskEnabled = true;
+
+    GLStateCache() { Invalidate(); }
+
+    GLuint* Slot(int unit, GLenum target) {
+        if (unit < 0 || unit >= MAX_UNITS) return nullptr;
+        if (target == GL_TEXTURE_2D) return &tex2D[unit];
+        if (target == GL_TEXTURE_CUBE_MAP) return &texCube[unit];
+        if (target == GL_TEXTURE_2D_ARRAY) return &tex2DArray[unit];
+        return nullptr;
+    }
+};
+
+#endif // GLSTATECACHE_H
@@ -10,6 +10,8 @@
 #include <string>
 #include "stb_image.h"
 #include "Shader.h"
+#include "FrameUniforms.h"
+#include "geometry/GeometryRegistry.h"
 
 const char* equirectToCubemapVS = R"glsl(
 #version 330 core
@@ -44,16 +46,13 @@ void main()
 }
 )glsl";
 
-const char* skyboxVS = R"glsl(
-#version 330 core
+const char* skyboxVS = "#version 330 core\n" FRAME_DATA_GLSL R"glsl(
 layout (location = 0) in vec3 aPos;
 out vec3 TexCoords;
-uniform mat4 view;
-uniform mat4 projection;
 void main()
 {
     TexCoords = aPos;
-    vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
+    vec4 pos = frame.projection * mat4(mat3(frame.view)) * vec4(aPos, 1.0);
     gl_Position = pos.xyww;
 }
 )glsl";
@@ -82,7 +81,7 @@ private:
     unsigned int skyboxShader;
     unsigned int envCubemap;
     unsigned int equirectToCubemapShader;
-    static unsigned int cubeVAO, cubeVBO;
+    static GeometryHandle cube;
     static unsigned int createShader(const char* vs, const char* fs);
     static void renderCube();
 
@@ -92,48 +91,21 @@ public:
     HdriSky() : skyboxShader(0), envCubemap(0), equirectToCubemapShader(0) {}
 
     void init(const std::string& hdrPath);
-    void draw(const glm::mat4& view, const glm::mat4& projection) const;
+    void draw() const;   // view/projection z FrameUniforms
     unsigned int getCubeMap() const { return envCubemap; }
 };
 
 
-unsigned int HdriSky::cubeVAO = 0;
-unsigned int HdriSky::cubeVBO = 0;
+GeometryHandle HdriSky::cube;
 
 inline void HdriSky::renderCube()
 {
-    if (cubeVAO == 0)
-    {
-        float vertices[] = {
-            // ZÁDA (Z = -10.0f)
-            -10.0f,-10.0f,-10.0f,  10.0f,-10.0f,-10.0f,  10.0f, 10.0f,-10.0f,
-            10.0f, 10.0f,-10.0f, -10.0f, 10.0f,-10.0f, -10.0f,-10.0f,-10.0f,
-            // PŘEDEK (Z = 10.0f)
-            -10.0f,-10.0f, 10.0f,  10.0f,-10.0f, 10.0f,  10.0f, 10.0f, 10.0f,
-            10.0f, 10.0f, 10.0f, -10.0f, 10.0f, 10.0f, -10.0f,-10.0f, 10.0f,
-            // VRCH (Y = 10.0f)
-            -10.0f, 10.0f,-10.0f, -10.0f, 10.0f, 10.0f,  10.0f, 10.0f, 10.0f,
-            10.0f, 10.0f, 10.0f,  10.0f, 10.0f,-10.0f, -10.0f, 10.0f,-10.0f,
-            // SPODEK (Y = -10.0f)
-            -10.0f,-10.0f,-10.0f, -10.0f,-10.0f, 10.0f,  10.0f,-10.0f, 10.0f,
-            10.0f,-10.0f, 10.0f,  10.0f,-10.0f,-10.0f, -10.0f,-10.0f,-10.0f,
-            // LEVÁ STRANA (X = -10.0f)
-            -10.0f, 10.0f, 10.0f, -10.0f, 10.0f,-10.0f, -10.0f,-10.0f,-10.0f,
-            -10.0f,-10.0f,-10.0f, -10.0f,-10.0f, 10.0f, -10.0f, 10.0f, 10.0f,
-            // PRAVÁ STRANA (X = 10.0f)
-            10.0f,-10.0f,-10.0f,  10.0f,-10.0f, 10.0f,  10.0f, 10.0f, 10.0f,
-            10.0f, 10.0f, 10.0f,  10.0f, 10.0f,-10.0f,  10.0f,-10.0f,-10.0f
-        };
-        glGenVertexArrays(1, &cubeVAO);
-        glGenBuffers(1, &cubeVBO);
-        glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-        glBindVertexArray(cubeVAO);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    }
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    // sdilena kostka z GeometryRegistry (stejna jako u TexturedSky)
+    if (!cube)
+        cube = GeometryRegistry::Get().SkyCube();
+
+    glBindVertexArray(cube->VAO);
+    glDrawArrays(GL_TRIANGLES, 0, cube->vertexCount);
     glBindVertexArray(0);
 }
 
@@ -249,15 +221,11 @@ inline void HdriSky::init(const std::string& hdrPath)
     glDeleteFramebuffers(1, &captureFBO);
     glDeleteRenderbuffers(1, &captureRBO);
 }
-inline void HdriSky::draw(const glm::mat4& view, const glm::mat4& projection) const
+inline void HdriSky::draw() const
 {
     glDepthFunc(GL_LEQUAL);
     glUseProgram(skyboxShader);
 
-    glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view)); // Odstranění translace pro skybox
-    glUniformMatrix4fv(glGetUniformLocation(skyboxShader, "view"), 1, GL_FALSE, glm::value_ptr(viewNoTranslation));
-    glUniformMatrix4fv(glGetUniformLocation(skyboxShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
     renderCube();
@@ -0,0 +1,172 @@
+#ifndef INDIRECTDRAW_H
+#define INDIRECTDRAW_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "FrameUniforms.h"
+#include "InstanceBuffer.h"
+#include "ProgramCache.h"
+#include "ShaderReflection.h"
+
+// Format prikazu pro glMultiDrawElementsIndirect (poradi dane specifikaci)
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Pevne binding pointy SSBO pro indirect draw (layout(binding=) v GLSL 4.50+)
+namespace StorageBinding {
+constexpr GLuint DrawObjects = 0;        // InstanceData[] - model, override, normalova matice a MVP objektu
+constexpr GLuint DrawFirstObject = 1;    // uint[] - prvni objekt kazdeho prikazu (horni 3 bity = vrstva)
+}
+
+// =========================================================================================
+// Multi-draw indirect: prikazy jednoho pruchodu v GL_DRAW_INDIRECT_BUFFER, per-objekt data
+// v SSBO. Vertex shader si objekt najde pres gl_DrawID:
+//     objects[firstObject[drawOffset + gl_DrawID] + gl_InstanceID]
+// (drawOffset = index prvniho prikazu volani - gl_DrawID zacina v kazdem volani od 0).
+// Horni 3 bity firstObject nesou vrstvu cile (DRAW_LAYER) pro layered shadow pruchod.
+// Cely beh paketu se stejnym materialem nad jednou arenou = jedno API volani.
+// =========================================================================================
+class IndirectDraw {
+
+public:
+    // glMultiDrawElementsIndirect (4.3) + gl_DrawID (4.6 / ARB_shader_draw_parameters) + arena (4.5)
+    static bool Supported() {
+        return GLAD_GL_VERSION_4_6 || (GLAD_GL_VERSION_4_5 && GLAD_GL_ARB_shader_draw_parameters);
+    }
+
+    static constexpr GLuint LAYER_SHIFT = 29;
+    static constexpr GLuint OBJECT_MASK = (1u << LAYER_SHIFT) - 1u;
+
+    // Hlavicka shaderu: #version + deklarace SSBO a makra DRAW_OBJECT (layer = gl_Layer ve VS)
+    static std::string GlslPrelude(bool layer = false) {
+        std::string s = GLAD_GL_VERSION_4_6
+            ? "#version 460 core\n"
+            : "#version 450 core\n#extension GL_ARB_shader_draw_parameters : require\n";
+        if (layer)
+            s += GLAD_GL_ARB_shader_viewport_layer_array ? "#extension GL_ARB_shader_viewport_layer_array : require\n"
+                                                         : "#extension GL_AMD_vertex_shader_layer : require\n";
+        s += GLAD_GL_VERSION_4_6 ? "#define DRAW_ID gl_DrawID\n" : "#define DRAW_ID gl_DrawIDARB\n";
+        // layout = InstanceData (std430: mat3x4 = 3 sloupce vec4)
+        s += "struct DrawObject { mat4 model; vec4 materialOverride; mat3x4 normalMatrix; mat4 mvp; };\n";
+        s += "layout(std430, binding = " + std::to_string(StorageBinding::DrawObjects) +
+             ") readonly buffer DrawObjects { DrawObject objects[]; };\n";
+        s += "layout(std430, binding = " + std::to_string(StorageBinding::DrawFirstObject) +
+             ") readonly buffer DrawFirstObject { uint firstObject[]; };\n";
+        s += "uniform int drawOffset;\n";
+        s += "#define DRAW_FIRST firstObject[uint(drawOffset + DRAW_ID)]\n";
+        s += "#define DRAW_OBJECT objects[(DRAW_FIRST & " + std::to_string(OBJECT_MASK) + "u) + uint(gl_InstanceID)]\n";
+        s += "#define DRAW_LAYER int(DRAW_FIRST >> " + std::to_string(LAYER_SHIFT) + "u)\n";
+        return s;
+    }
+
+    static IndirectDraw& Get() {
+        static IndirectDraw instance;
+        return instance;
+    }
+
+    IndirectDraw(const IndirectDraw&) = delete;
+    IndirectDraw& operator=(const IndirectDraw&) = delete;
+
+    // Nahraje prikazy + data objektu pruchodu a navaze SSBO (osiroceni jako InstanceBuffer)
+    void Upload(const std::vector<DrawElementsIndirectCommand>& commands,
+                const std::vector<GLuint>& firstObjects,
+                const std::vector<InstanceData>& objects) {
+        if (commands.empty()) return;
+        EnsureBuffers();
+        Stream(commandBuffer, commandCapacity, commands.data(), commands.size() * sizeof(DrawElementsIndirectCommand));
+        Stream(firstObjectBuffer, firstObjectCapacity, firstObjects.data(), firstObjects.size() * sizeof(GLuint));
+        Stream(objectBuffer, objectCapacity, objects.data(), objects.size() * sizeof(InstanceData));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBinding::DrawObjects, objectBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBinding::DrawFirstObject, firstObjectBuffer);
+    }
+
+    // Prikazy [first, first + count) z posledniho Upload; program a VAO areny uz musi byt navazane
+    void Draw(GLuint program, GLenum indexType, GLuint first, GLsizei count) {
+        ProgramReflection& r = ProgramReflection::For(program);
+        r.Set(r.Handle<int>("drawOffset"_u), static_cast<int>(first));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType,
+                                    reinterpret_cast<const void*>(static_cast<uintptr_t>(first) * sizeof(DrawElementsIndirectCommand)),
+                                    count, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Depth program pro shadow pruchod a depth pre-pass (stejny vypocet jako shaders/depth.vert)
+    GLuint DepthProgram() {
+        if (!depthProgram) {
+            std::string vs = GlslPrelude() + FRAME_DATA_GLSL SHADOW_CASTER_GLSL R"glsl(
+layout(location = 0) in vec3 aPos;
+uniform bool prePass;
+invariant gl_Position;
+void main()
+{
+    if (prePass) gl_Position = DRAW_OBJECT.mvp * vec4(aPos, 1.0);
+    else gl_Position = shadowCasterMatrix() * DRAW_OBJECT.model * vec4(aPos, 1.0);
+}
+)glsl";
+            depthProgram = ProgramCache::Get().Acquire(vs, "#version 330 core\nvoid main() {}\n");
+        }
+        return depthProgram->id;
+    }
+
+    // Vsechny kaskady CascadedShadowMaps jednim volanim: vrstva a matice podle DRAW_LAYER
+    GLuint LayeredDepthProgram() {
+        if (!layeredDepthProgram) {
+            std::string vs = GlslPrelude(true) + FRAME_DATA_GLSL R"glsl(
+layout(location = 0) in vec3 aPos;
+void main()
+{
+    int layer = DRAW_LAYER;
+    gl_Layer = layer;
+    gl_Position = frame.cascadeMatrices[layer] * DRAW_OBJECT.model * vec4(aPos, 1.0);
+}
+)glsl";
+            layeredDepthProgram = ProgramCache::Get().Acquire(vs, "#version 330 core\nvoid main() {}\n");
+        }
+        return layeredDepthProgram ? layeredDepthProgram->id : 0;
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        for (GLuint* b : {&commandBuffer, &firstObjectBuffer, &objectBuffer}) {
+            if (*b) glDeleteBuffers(1, b);
+            *b = 0;
+        }
+        commandCapacity = firstObjectCapacity = objectCapacity = 0;
+        depthProgram.reset();
+        layeredDepthProgram.reset();
+    }
+
+private:
+    GLuint commandBuffer = 0, firstObjectBuffer = 0, objectBuffer = 0;
+    GLsizeiptr commandCapacity = 0, firstObjectCapacity = 0, objectCapacity = 0;
+    ProgramHandle depthProgram, layeredDepthProgram;
+
+    IndirectDraw() = default;
+
+    void EnsureBuffers() {
+        if (commandBuffer) return;
+        glGenBuffers(1, &commandBuffer);
+        glGenBuffers(1, &firstObjectBuffer);
+        glGenBuffers(1, &objectBuffer);
+    }
+
+    static void Stream(GLuint buffer, GLsizeiptr& capacity, const void* data, size_t size) {
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(size);
+        if (bytes > capacity) capacity = bytes + bytes / 2;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, bytes, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+};
+
+#endif // INDIRECTDRAW_H
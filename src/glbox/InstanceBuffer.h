@@ -0,0 +1,94 @@
+#ifndef INSTANCEBUFFER_H
+#define INSTANCEBUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geometry/GeometryRegistry.h"
+
+// Per-instance data (location 4-7 model matice, 8 override materialu, 9-11 normalova matice,
+// 12-15 MVP). Stejny layout ma DrawObject v SSBO (std430) - poradi clenu nemenit.
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 materialOverride;   // rgb = nasobic albeda, a = roughness (< 0 = z materialu)
+    glm::mat3x4 normalMatrix;     // transpose(inverse(mat3(model))), sloupce vec4 (ObjectMatrices)
+    glm::mat4 mvp;                // viewProjection * model
+};
+
+// vychozi override - material beze zmeny
+inline glm::vec4 NoMaterialOverride() { return glm::vec4(1.0f, 1.0f, 1.0f, -1.0f); }
+
+// =========================================================================================
+// Jeden sdileny stream buffer s instancemi pro cely pruchod. Do VAO geometrie se pripoji
+// jednou (binding INSTANCE_BINDING, divisor 1); davky se pak kresli pres baseInstance,
+// takze se mezi nimi nemeni zadny vertex stav. Upload osiroti stary obsah (glBufferData
+// s nullptr), driver tak nemusi cekat na predchozi pruchod.
+// =========================================================================================
+class InstanceBuffer {
+
+public:
+    static constexpr GLuint FIRST_LOCATION = 4;      // 4..7 mat4, 8 override, 9..11 normal, 12..15 mvp
+    static constexpr GLuint ATTRIB_COUNT = sizeof(InstanceData) / sizeof(glm::vec4);
+    static constexpr GLuint INSTANCE_BINDING = 15;   // glVertexAttribPointer pouziva binding == location
+
+    static InstanceBuffer& Get() {
+        static InstanceBuffer instance;
+        return instance;
+    }
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    void Upload(const std::vector<InstanceData>& instances) {
+        if (instances.empty()) return;
+        EnsureBuffer();
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(instances.size() * sizeof(InstanceData));
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        if (bytes > capacity) {
+            capacity = bytes + bytes / 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        uploadedBytes += static_cast<size_t>(bytes);
+    }
+
+    // Pripoji instancni atributy do VAO geometrie (jen poprve); VAO musi byt navazane
+    void AttachTo(GpuGeometry& geometry) {
+        if (geometry.instanceAttribs) return;
+        EnsureBuffer();
+        for (GLuint i = 0; i < ATTRIB_COUNT; ++i) {
+            GLuint location = FIRST_LOCATION + i;
+            glEnableVertexAttribArray(location);
+            glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, i * sizeof(glm::vec4));
+            glVertexAttribBinding(location, INSTANCE_BINDING);
+        }
+        glVertexBindingDivisor(INSTANCE_BINDING, 1);
+        glBindVertexBuffer(INSTANCE_BINDING, vbo, 0, sizeof(InstanceData));
+        geometry.instanceAttribs = true;
+    }
+
+    size_t UploadedBytes() const { return uploadedBytes; }
+    void ResetStats() { uploadedBytes = 0; }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        if (vbo) glDeleteBuffers(1, &vbo);
+        vbo = 0;
+        capacity = 0;
+    }
+
+private:
+    GLuint vbo = 0;
+    GLsizeiptr capacity = 0;
+    size_t uploadedBytes = 0;
+
+    InstanceBuffer() = default;
+
+    void EnsureBuffer() {
+        if (vbo == 0) glGenBuffers(1, &vbo);
+    }
+};
+
+#endif // INSTANCEBUFFER_H
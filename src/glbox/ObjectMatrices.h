@@ -0,0 +1,116 @@
+#ifndef OBJECTMATRICES_H
+#define OBJECTMATRICES_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "InstanceBuffer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLBOX_OBJECT_MATRICES_SSE 1
+#include <emmintrin.h>
+#endif
+
+// =========================================================================================
+// Odvozene matice objektu pocitane jednou za frame na CPU misto v kazdem vertexu:
+//   normalMatrix = transpose(inverse(mat3(model))) - sloupce b x c, c x a, a x b (/ det)
+//   mvp          = viewProjection * model
+// Normalova matice se s SSE pocita pro 4 objekty naraz (SoA, lane = objekt), MVP po sloupcich.
+// Singularni model (det == 0) necha kofaktory bez deleni - shader normaly normalizuje.
+// =========================================================================================
+namespace ObjectMatrices {
+
+inline glm::mat3x4 NormalMatrix(const glm::mat4& model) {
+    glm::vec3 a(model[0]), b(model[1]), c(model[2]);
+    glm::vec3 bc = glm::cross(b, c), ca = glm::cross(c, a), ab = glm::cross(a, b);
+    float det = glm::dot(a, bc);
+    float inv = det != 0.0f ? 1.0f / det : 1.0f;
+    return glm::mat3x4(glm::vec4(bc * inv, 0.0f), glm::vec4(ca * inv, 0.0f), glm::vec4(ab * inv, 0.0f));
+}
+
+// Jeden objekt (primy draw mimo RenderQueue)
+inline InstanceData Single(const glm::mat4& model, const glm::mat4& viewProjection,
+                           const glm::vec4& materialOverride = NoMaterialOverride()) {
+    InstanceData object;
+    object.model = model;
+    object.materialOverride = materialOverride;
+    object.normalMatrix = NormalMatrix(model);
+    object.mvp = viewProjection * model;
+    return object;
+}
+
+// Dopocita normalMatrix + mvp pro 'count' objektu (model uz vyplneny)
+inline void Compute(InstanceData* objects, size_t count, const glm::mat4& viewProjection) {
+    size_t i = 0;
+#ifdef GLBOX_OBJECT_MATRICES_SSE
+    const __m128 vp0 = _mm_loadu_ps(&viewProjection[0][0]);
+    const __m128 vp1 = _mm_loadu_ps(&viewProjection[1][0]);
+    const __m128 vp2 = _mm_loadu_ps(&viewProjection[2][0]);
+    const __m128 vp3 = _mm_loadu_ps(&viewProjection[3][0]);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        InstanceData* o[4] = {&objects[i], &objects[i + 1], &objects[i + 2], &objects[i + 3]};
+
+        // mvp[j] = vp * model[j] (broadcast slozek sloupce)
+        for (InstanceData* obj : o) {
+            for (int j = 0; j < 4; ++j) {
+                __m128 m = _mm_loadu_ps(&obj->model[j][0]);
+                __m128 r = _mm_mul_ps(vp0, _mm_shuffle_ps(m, m, _MM_SHUFFLE(0, 0, 0, 0)));
+                r = _mm_add_ps(r, _mm_mul_ps(vp1, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1))));
+                r = _mm_add_ps(r, _mm_mul_ps(vp2, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2))));
+                r = _mm_add_ps(r, _mm_mul_ps(vp3, _mm_shuffle_ps(m, m, _MM_SHUFFLE(3, 3, 3, 3))));
+                _mm_storeu_ps(&obj->mvp[j][0], r);
+            }
+        }
+
+        // sloupce a, b, c ctyr objektu -> SoA (x, y, z pres objekty)
+        __m128 col[3][3];
+        for (int c = 0; c < 3; ++c) {
+            __m128 r0 = _mm_loadu_ps(&o[0]->model[c][0]);
+            __m128 r1 = _mm_loadu_ps(&o[1]->model[c][0]);
+            __m128 r2 = _mm_loadu_ps(&o[2]->model[c][0]);
+            __m128 r3 = _mm_loadu_ps(&o[3]->model[c][0]);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            col[c][0] = r0; col[c][1] = r1; col[c][2] = r2;
+        }
+        auto cross = [](const __m128* u, const __m128* v, __m128* out) {
+            out[0] = _mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1]));
+            out[1] = _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2]));
+            out[2] = _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]));
+        };
+        __m128 n[3][3];
+        cross(col[1], col[2], n[0]);
+        cross(col[2], col[0], n[1]);
+        cross(col[0], col[1], n[2]);
+
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0][0], n[0][0]), _mm_mul_ps(col[0][1], n[0][1])),
+                                _mm_mul_ps(col[0][2], n[0][2]));
+        __m128 nonZero = _mm_cmpneq_ps(det, zero);
+        __m128 inv = _mm_or_ps(_mm_and_ps(nonZero, _mm_div_ps(one, det)), _mm_andnot_ps(nonZero, one));
+
+        // zpet na AoS: kazdy sloupec normalove matice = (x, y, z, 0) jednoho objektu
+        for (int c = 0; c < 3; ++c) {
+            __m128 x = _mm_mul_ps(n[c][0], inv);
+            __m128 y = _mm_mul_ps(n[c][1], inv);
+            __m128 z = _mm_mul_ps(n[c][2], inv);
+            __m128 w = zero;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&o[0]->normalMatrix[c][0], x);
+            _mm_storeu_ps(&o[1]->normalMatrix[c][0], y);
+            _mm_storeu_ps(&o[2]->normalMatrix[c][0], z);
+            _mm_storeu_ps(&o[3]->normalMatrix[c][0], w);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        InstanceData& obj = objects[i];
+        obj.normalMatrix = NormalMatrix(obj.model);
+        obj.mvp = viewProjection * obj.model;
+    }
+}
+
+} // namespace ObjectMatrices
+
+#endif // OBJECTMATRICES_H
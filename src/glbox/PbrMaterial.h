@@ -2,63 +2,109 @@
 #define PBRMATERIAL_H
 
 #include "Shader.h"
+#include "ShaderReflection.h"
+#include "FrameUniforms.h"
+#include "GLStateCache.h"
+#include "InstanceBuffer.h"
+#include "ObjectMatrices.h"
+#include "WeightedOIT.h"
+#include "IndirectDraw.h"
+#include "CascadedShadowMaps.h"
+#include "ShadowFilter.h"
+#include "EvsmShadow.h"
+#include "ProgramCache.h"
+#include "ShaderPermutations.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <string>
+#include <vector>
 
-const char* pbrVertexShaderSrc = R"glsl(
-#version 330 core
+// kamera a svetlo z bloku FrameData, per-draw model + normalova matice + MVP (ObjectMatrices)
+// a material. Telo bez #version - varianta INDIRECT_DRAW bere data objektu z SSBO (IndirectDraw.h)
+const char* pbrVertexShaderBody = R"glsl(
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 layout(location = 3) in vec3 aTangent;
+// instancovani (InstanceBuffer) - model matice, override materialu, normalova matice, MVP
+layout(location = 4) in mat4 iModel;
+layout(location = 8) in vec4 iMaterialOverride;
+layout(location = 9) in mat3x4 iNormalMatrix;
+layout(location = 12) in mat4 iMVP;
 
 out vec3 WorldPos;
 out vec3 Normal;
 out vec2 UV;
 out mat3 TBN;
 out vec4 FragPosLightSpace;
+out vec3 LightDir;
+flat out vec4 MaterialOverride;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+uniform mat3 normalMatrix;
+uniform mat4 mvp;
+uniform vec4 materialOverride;
+uniform bool instanced;
+
+// depth pre-pass (depth.vert) pocita gl_Position stejne - barevny pruchod pak testuje GL_EQUAL
+invariant gl_Position;
 
 void main()
 {
-    WorldPos = vec3(model * vec4(aPos, 1.0));
+#ifdef INDIRECT_DRAW
+    mat4 M = DRAW_OBJECT.model;
+    mat3 NM = mat3(DRAW_OBJECT.normalMatrix);
+    mat4 MVP = DRAW_OBJECT.mvp;
+    MaterialOverride = DRAW_OBJECT.materialOverride;
+#else
+    mat4 M = instanced ? iModel : model;
+    mat3 NM = instanced ? mat3(iNormalMatrix) : normalMatrix;
+    mat4 MVP = instanced ? iMVP : mvp;
+    MaterialOverride = instanced ? iMaterialOverride : materialOverride;
+#endif
+    WorldPos = vec3(M * vec4(aPos, 1.0));
     UV = aUV;
 
-    mat3 normalMatrix = mat3(transpose(inverse(model)));
-    vec3 T = normalize(normalMatrix * aTangent);
-    vec3 N = normalize(normalMatrix * aNormal);
+    vec3 T = normalize(NM * aTangent);
+    vec3 N = normalize(NM * aNormal);
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
     TBN = mat3(T, B, N);
 
     Normal = N;
-    FragPosLightSpace = lightSpaceMatrix * vec4(WorldPos, 1.0);
-    gl_Position = projection * view * vec4(WorldPos, 1.0);
+    // smer ke svetlu z pocatku objektu (konstantni pro cely draw)
+    LightDir = frame.lightPos.xyz - M[3].xyz;
+    FragPosLightSpace = frame.lightSpaceMatrix * vec4(WorldPos, 1.0);
+    gl_Position = MVP * vec4(aPos, 1.0);
 }
 )glsl";
 
-const char* pbrFragmentShaderSrc = R"glsl(
-#version 330 core
+const char* pbrFragmentShaderSrc = "#version 330 core\n" FRAME_DATA_GLSL SHADOW_FILTER_GLSL EVSM_GLSL R"glsl(
+#ifdef OIT
+// weighted blended OIT (WeightedOIT.h) - akumulace + revealage misto blendu do sceny
+layout(location = 0) out vec4 accum;
+layout(location = 1) out float reveal;
+#else
 out vec4 FragColor;
+#endif
 
 in vec3 WorldPos;
 in vec3 Normal;
 in vec2 UV;
 in mat3 TBN;
 in vec4 FragPosLightSpace;
+in vec3 LightDir;
+flat in vec4 MaterialOverride;   // rgb = nasobic albeda, a = roughness (< 0 = z materialu)
 
 // Uniforms
-uniform vec3 cameraPos;
-uniform vec3 lightDir;
-uniform vec3 lightColor;
 uniform samplerCube environmentMap;
-uniform sampler2D shadowMap;
+uniform sampler2DShadow shadowMap;
+uniform sampler2DArrayShadow shadowCascades;   // CascadedShadowMaps (frame.shadowParams.x = pocet kaskad)
+uniform sampler2D shadowMapDepth;              // tytez textury bez compare (PCSS hledani blokeru)
+uniform sampler2DArray shadowCascadesDepth;
+uniform sampler2D shadowMoments;               // EVSM momenty (EvsmShadow, frame.shadowParams.y = 3)
+uniform sampler2DArray shadowCascadeMoments;
 
 // PBR material properties
 uniform vec3 materialColor;
@@ -77,12 +123,23 @@ uniform sampler2D metallicMap;
 uniform sampler2D roughnessMap;
 uniform sampler2D aoMap;
 
-// Texture usage flags
+// Texture usage flags - uber varianta je cte z uniformu, specializovane varianty
+// (ShaderPermutations) je maji jako konstanty a nepouzite vetve se nezkompiluji
+#ifdef PBR_UBER
 uniform bool useAlbedoMap;
 uniform bool useNormalMap;
 uniform bool useMetallicMap;
 uniform bool useRoughnessMap;
 uniform bool useAoMap;
+const bool hasTransmission = true;
+#else
+const bool useAlbedoMap = HAS_ALBEDO_MAP;
+const bool useNormalMap = HAS_NORMAL_MAP;
+const bool useMetallicMap = HAS_METALLIC_MAP;
+const bool useRoughnessMap = HAS_ROUGHNESS_MAP;
+const bool useAoMap = HAS_AO_MAP;
+const bool hasTransmission = HAS_TRANSMISSION;
+#endif
 
 const float PI = 3.14159265359;
 const float MAX_REFLECTION_LOD = 5.0;
@@ -112,21 +169,43 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     return GeometrySchlickGGX(NdotV, roughness) * GeometrySchlickGGX(NdotL, roughness);
 }
 
+// jednoducha shadow mapa (frame.lightSpaceMatrix), filtr podle frame.shadowParams (ShadowFilter.h)
 float ShadowCalculation(vec4 fragPosLightSpace, vec3 N, vec3 L) {
+    // derivace pred prvnim return (EVSM mipmapy); ortho matice -> uv je linearni ve svete
+    vec2 uvDx = 0.5 * (frame.lightSpaceMatrix * vec4(dFdx(WorldPos), 0.0)).xy;
+    vec2 uvDy = 0.5 * (frame.lightSpaceMatrix * vec4(dFdy(WorldPos), 0.0)).xy;
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords = projCoords * 0.5 + 0.5;
     if(projCoords.z > 1.0) return 0.0;
-    float currentDepth = projCoords.z;
     float bias = max(0.005 * (1.0 - dot(N, L)), 0.0005);
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for(int x = -1; x <= 1; ++x)
-        for(int y = -1; y <= 1; ++y)
-        {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
-    return shadow / 9.0;
+    vec3 coord = vec3(projCoords.xy, projCoords.z - bias);
+    if (int(frame.shadowParams.y) == 3) return ShadowEvsm(shadowMoments, coord, uvDx, uvDy);
+    return ShadowFilter(shadowMap, shadowMapDepth, coord, frame.lightSpaceMatrix);
+}
+
+// kaskada podle vzdalenosti od kamery; za posledni hranici bez stinu
+float CascadeShadow(vec3 N, vec3 L) {
+    vec3 worldDx = dFdx(WorldPos), worldDy = dFdy(WorldPos);
+    float viewDepth = -(frame.view * vec4(WorldPos, 1.0)).z;
+    int count = int(frame.shadowParams.x);
+    int cascade = 0;
+    while (cascade < count && viewDepth > frame.cascadeSplits[cascade]) cascade++;
+    if (cascade >= count) return 0.0;
+
+    // normal offset o velikost texelu kaskady ve svete (radek 0 ortho matice = 2 / sirka boxu)
+    mat4 cascadeMatrix = frame.cascadeMatrices[cascade];
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowCascades, 0).xy);
+    float texelWorld = 2.0 * texelSize.x / length(vec3(cascadeMatrix[0][0], cascadeMatrix[1][0], cascadeMatrix[2][0]));
+    float NdotL = clamp(dot(N, L), 0.0, 1.0);
+    vec4 lightSpace = cascadeMatrix * vec4(WorldPos + N * texelWorld * (1.0 + 2.0 * (1.0 - NdotL)), 1.0);
+    vec3 projCoords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+    if(projCoords.z > 1.0) return 0.0;
+    float bias = 0.0005;
+    vec3 coord = vec3(projCoords.xy, projCoords.z - bias);
+    if (int(frame.shadowParams.y) == 3)
+        return ShadowEvsm(shadowCascadeMoments, coord, 0.5 * (cascadeMatrix * vec4(worldDx, 0.0)).xy,
+                          0.5 * (cascadeMatrix * vec4(worldDy, 0.0)).xy, float(cascade));
+    return ShadowFilter(shadowCascades, shadowCascadesDepth, coord, cascadeMatrix, float(cascade));
 }
 
 vec3 RRTAndODTFit(vec3 v) {
@@ -140,11 +219,24 @@ vec3 ACESFilm(vec3 color) {
     return pow(color, vec3(1.0/2.2));
 }
 
+void writeColor(vec3 color) {
+#ifdef OIT
+    // vaha: blizsi a nepruhlednejsi fragmenty prevazi (McGuire & Bavoil, rovnice 7)
+    float w = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    accum = vec4(color * alpha, alpha) * w;
+    reveal = alpha;
+#else
+    FragColor = vec4(color, alpha);
+#endif
+}
+
 void main()
 {
     vec3 albedo       = useAlbedoMap    ? pow(texture(albedoMap, UV).rgb, vec3(2.2)) : pow(materialColor, vec3(2.2));
     float metallicVal = useMetallicMap  ? texture(metallicMap, UV).r                : metallic;
     float roughnessVal= useRoughnessMap ? texture(roughnessMap, UV).r               : roughness;
+    albedo *= MaterialOverride.rgb;
+    if (MaterialOverride.a >= 0.0) roughnessVal = MaterialOverride.a;
     float aoVal       = useAoMap        ? texture(aoMap, UV).r                      : ao;
 
     vec3 N = normalize(Normal);
@@ -153,14 +245,14 @@ void main()
         N = normalize(TBN * tangentNormal);
     }
 
-    vec3 V = normalize(cameraPos - WorldPos);
-    vec3 L = normalize(lightDir);
+    vec3 V = normalize(frame.cameraPos.xyz - WorldPos);
+    vec3 L = normalize(LightDir);
     vec3 H = normalize(V + L);
 
     vec3 F0 = vec3(0.04);
     F0 = mix(F0, albedo, metallicVal);
 
-    if (transmission > 0.0) {
+    if (hasTransmission && transmission > 0.0) {
         float ratio = 1.0 / ior;
         vec3 T = refract(-V, N, ratio);
         vec3 refractedColor = textureLod(environmentMap, T, roughnessVal * MAX_REFLECTION_LOD).rgb;
@@ -168,7 +260,7 @@ void main()
         vec3 reflectedColor = textureLod(environmentMap, R, roughnessVal * MAX_REFLECTION_LOD).rgb;
         vec3 F = fresnelSchlick(max(dot(N, V), 0.0), F0);
         vec3 color = mix(refractedColor, reflectedColor, F);
-        FragColor = vec4(ACESFilm(color), alpha);
+        writeColor(ACESFilm(color));
         return;
     }
 
@@ -183,8 +275,8 @@ void main()
     vec3 diffuse = albedo;
     vec3 specular = (NDF * G * F) / max(4.0 * max(dot(N, V),0.0)*max(dot(N,L),0.0),0.0001);
 
-    float shadow = ShadowCalculation(FragPosLightSpace, N, L);
-    vec3 directLight = (kD * diffuse / PI + specular) * max(dot(N,L),0.0) * (1.0 - shadow) * lightColor;
+    float shadow = frame.shadowParams.x > 0.0 ? CascadeShadow(N, L) : ShadowCalculation(FragPosLightSpace, N, L);
+    vec3 directLight = (kD * diffuse / PI + specular) * max(dot(N,L),0.0) * (1.0 - shadow) * frame.lightColor.rgb;
 
     // --- Image-based lighting (IBL) ---
     vec3 R = reflect(-V, N);
@@ -193,16 +285,24 @@ void main()
     vec3 ambient = (kD * diffuse + F_env * prefilteredColor) * aoVal * reflectionStrength;
 
     vec3 color = directLight + ambient;
-    FragColor = vec4(ACESFilm(color), alpha);
+    writeColor(ACESFilm(color));
 }
 )glsl";
 
 
+// Feature bity PBR permutaci (poradi = poradi v PbrMaterial::Features())
+namespace PbrFeature {
+constexpr uint32_t AlbedoMap = 1u << 0;
+constexpr uint32_t NormalMap = 1u << 1;
+constexpr uint32_t MetallicMap = 1u << 2;
+constexpr uint32_t RoughnessMap = 1u << 3;
+constexpr uint32_t AoMap = 1u << 4;
+constexpr uint32_t Transmission = 1u << 5;
+}
+
 class PbrMaterial {
 
 public:
-    unsigned int shaderProgramID;
-
     glm::vec3 albedoColor;
     float alpha;
     float metallic;
@@ -220,9 +320,10 @@ public:
     unsigned int aoMapID;
 
     PbrMaterial() {
-       // shaderProgramID = createShader(pbrVertexShaderSrc, pbrFragmentShaderSrc);
-        Shader shaderProgram(pbrVertexShaderSrc, pbrFragmentShaderSrc,true);
-        shaderProgramID = shaderProgram.ID;
+        // uber varianta (fallback, nez se zkompiluje specializovana) se zacne kompilovat hned,
+        // cekat se na ni bude az pri prvnim kresleni
+        mainVariant.uber = MainPermutations().Prepare();
+        if (IndirectDraw::Supported()) indirectVariant.uber = IndirectPermutations().Prepare();
         albedoColor = glm::vec3(0.8f); alpha = 1.0f; metallic = 0.0f;
         roughness = 0.5f; ao = 1.0f; reflectionStrength = 1.0f;
         transmission = 0.0f; ior = 1.52f;
@@ -230,10 +331,30 @@ public:
         roughnessMapID = 0; aoMapID = 0;
     }
 
-    ~PbrMaterial() {
-        glDeleteProgram(shaderProgramID);
+    // programy uvolni ProgramHandle ve slotech variant (s poslednim materialem)
+    ~PbrMaterial() = default;
+
+    static const std::vector<std::string>& Features() {
+        static const std::vector<std::string> features = {
+            "HAS_ALBEDO_MAP", "HAS_NORMAL_MAP", "HAS_METALLIC_MAP", "HAS_ROUGHNESS_MAP", "HAS_AO_MAP", "HAS_TRANSMISSION"};
+        return features;
+    }
+
+    // Varianta podle stavu materialu - textura 0 = mapa se v shaderu vubec nevzorkuje
+    uint32_t FeatureBits() const {
+        uint32_t bits = 0;
+        if (albedoMapID)    bits |= PbrFeature::AlbedoMap;
+        if (normalMapID)    bits |= PbrFeature::NormalMap;
+        if (metallicMapID)  bits |= PbrFeature::MetallicMap;
+        if (roughnessMapID) bits |= PbrFeature::RoughnessMap;
+        if (aoMapID)        bits |= PbrFeature::AoMap;
+        if (transmission > 0.0f) bits |= PbrFeature::Transmission;
+        return bits;
     }
 
+    // Program, kterym se material prave kresli (specializovany, nebo uber dokud neni hotovy)
+    GLuint ProgramID() const { return mainSelected().program; }
+
 
     void setAlbedoMap(unsigned int texID)   { albedoMapID = texID; }
     void setNormalMap(unsigned int texID)   { normalMapID = texID; }
@@ -242,53 +363,65 @@ public:
     void setAoMap(unsigned int texID)       { aoMapID = texID; }
     // ------------------------------------
 
-    void use(const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj,
-             const glm::vec3& cameraPos, unsigned int envCubemap, unsigned int shadowMap,
-             const glm::mat4& lightSpaceMatrix, const glm::vec3& lightDir, const glm::vec3& lightCol) const {
-
-        glUseProgram(shaderProgramID);
-
-        setMat4("model", model); setMat4("view", view); setMat4("projection", proj);
-        setMat4("lightSpaceMatrix", lightSpaceMatrix); setVec3("cameraPos", cameraPos);
-        setVec3("lightDir", lightDir); setVec3("lightColor", lightCol);
+    // kamera/svetlo jsou v FrameUniforms (nahrane jednou za frame), tady jen data objektu
+    void use(const glm::mat4& model, unsigned int envCubemap, unsigned int shadowMap,
+             const glm::vec4& materialOverride = NoMaterialOverride()) const {
+        // primy draw mimo RenderQueue - stav mohl zmenit kdokoli, cache nejdriv zapomene
+        GLStateCache& cache = GLStateCache::Get();
+        cache.Invalidate();
+        bind(ObjectMatrices::Single(model, FrameUniforms::Get().data.viewProjection, materialOverride),
+             envCubemap, shadowMap, cache);
+    }
 
+    // Nastavi program, uniformy, textury a blend pres cache (redundantni zmeny se zahodi);
+    // object ma normalMatrix + mvp uz spocitane (ObjectMatrices)
+    void bind(const InstanceData& object, unsigned int envCubemap, unsigned int shadowMap, GLStateCache& cache) const {
+        const Variant& v = mainSelected();
+        bindShared(v, envCubemap, shadowMap, cache);
+        ProgramReflection& r = *v.reflection;
+        r.Set(v.u.instanced, 0);
+        r.Set(v.u.model, object.model);
+        r.Set(v.u.normalMatrix, glm::mat3(object.normalMatrix));
+        r.Set(v.u.mvp, object.mvp);
+        r.Set(v.u.materialOverride, object.materialOverride);
+    }
 
-        setVec3("materialColor", albedoColor); setFloat("alpha", alpha);
-        setFloat("metallic", metallic); setFloat("roughness", roughness);
-        setFloat("ao", ao); setFloat("reflectionStrength", reflectionStrength);
-        setFloat("transmission", transmission); setFloat("ior", ior);
+    // Instancovana davka - model a override jdou z instancnich atributu
+    void bindInstanced(unsigned int envCubemap, unsigned int shadowMap, GLStateCache& cache) const {
+        const Variant& v = mainSelected();
+        bindShared(v, envCubemap, shadowMap, cache);
+        v.reflection->Set(v.u.instanced, 1);
+    }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
-        // Vycisteni (unbind) GL_TEXTURE_2D, pokud tam nejaká stará vazba zůstala.
-        glBindTexture(GL_TEXTURE_2D, 0); // <-- EXPLICITNÍ ČIŠTĚNÍ
-        setInt("environmentMap", 0);
+    // Varianta pro multi-draw indirect (model + override z SSBO pres gl_DrawID);
+    // kompiluje se az pri prvnim pouziti, 0 = bez podpory (IndirectDraw::Supported)
+    GLuint IndirectProgram() const {
+        if (!IndirectDraw::Supported()) return 0;
+        return indirectSelected().program;
+    }
 
-        // Jednotka 1: Shadow Map
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, shadowMap);
-        // Vycisteni (unbind) GL_TEXTURE_CUBE_MAP, pro případné staré vazby.
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0); // <-- EXPLICITNÍ ČIŠTĚNÍ
-        setInt("shadowMap", 1);
-
-        bindTexture(2, "albedoMap",   "useAlbedoMap",   albedoMapID);
-        bindTexture(3, "normalMap",   "useNormalMap",   normalMapID);
-        bindTexture(4, "metallicMap", "useMetallicMap", metallicMapID);
-        bindTexture(5, "roughnessMap","useRoughnessMap",roughnessMapID);
-        bindTexture(6, "aoMap",       "useAoMap",       aoMapID);
-
-        if (transmission > 0.0 || alpha < 1.0) {
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        }
+    // Indirect davka - volat po IndirectProgram() != 0
+    void bindIndirect(unsigned int envCubemap, unsigned int shadowMap, GLStateCache& cache) const {
+        bindShared(indirectSelected(), envCubemap, shadowMap, cache);
     }
 
     void unuse() const {
-        if (transmission > 0.0 || alpha < 1.0) {
+        if (IsTransparent()) {
             glDisable(GL_BLEND);
         }
         glUseProgram(0);
     }
+
+    bool IsTransparent() const { return transmission > 0.0 || alpha < 1.0; }
+
+    // Hash sady textur materialu (klic pro razeni v RenderQueue)
+    uint32_t TextureSetHash() const {
+        uint32_t h = 2166136261u;
+        for (unsigned int id : {albedoMapID, normalMapID, metallicMapID, roughnessMapID, aoMapID})
+            h = (h ^ id) * 16777619u;
+        return h;
+    }
+
     void setParameters(
         const glm::vec3& albedoColor = glm::vec3(0.8f),
         float alpha = 1.0f,
@@ -307,22 +440,183 @@ public:
         this->reflectionStrength = reflectionStrength;
         this->transmission = transmission;
         this->ior = ior;
+        // pruhledny material - OIT varianta se zacne kompilovat hned, ne az pri prvnim kresleni
+        if (IsTransparent() && WeightedOIT::Supported() && !oitVariant.uber) oitVariant.uber = OitPermutations().Prepare();
     }
 private:
-    void bindTexture(int unit, const std::string& samplerName, const std::string& useFlagName, unsigned int texID) const {
-        bool useTexture = (texID != 0);
-        setInt(useFlagName, useTexture);
-        if (useTexture) {
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(GL_TEXTURE_2D, texID);
-            setInt(samplerName, unit);
+    // handles resolvnute jednou po linkovani
+    struct Uniforms {
+        UniformHandle<glm::mat4> model, mvp;
+        UniformHandle<glm::mat3> normalMatrix;
+        UniformHandle<glm::vec4> materialOverride;
+        UniformHandle<int> instanced;
+        UniformHandle<glm::vec3> materialColor;
+        UniformHandle<float> alpha, metallic, roughness, ao, reflectionStrength, transmission, ior;
+        UniformHandle<int> environmentMap, shadowMap, shadowCascades, shadowMapDepth, shadowCascadesDepth;
+        UniformHandle<int> shadowMoments, shadowCascadeMoments;
+        UniformHandle<int> albedoMap, normalMap, metallicMap, roughnessMap, aoMap;
+        UniformHandle<int> useAlbedoMap, useNormalMap, useMetallicMap, useRoughnessMap, useAoMap;
+    };
+
+    // naposledy vybrana varianta + jeji handles (prerezolvuje se jen pri zmene programu).
+    // Slot drzi ProgramHandle pouzivaneho programu, zadane specializovane varianty (i behem
+    // kompilace) a uber fallbacku, dokud specializovana neni hotova
+    struct Variant {
+        GLuint program = 0;
+        ProgramReflection* reflection = nullptr;
+        Uniforms u;
+        ProgramHandle handle, requested, uber;
+        uint32_t bits = ~0u;
+    };
+    mutable Variant mainVariant;
+    mutable Variant indirectVariant;
+    mutable Variant oitVariant;
+    mutable Variant indirectOitVariant;
+
+    // pruhledny material kresleny behem WeightedOIT pruchodu -> OIT varianta (jine vystupy)
+    bool drawsOit() const { return IsTransparent() && WeightedOIT::Get().Active(); }
+
+    const Variant& mainSelected() const {
+        return drawsOit() ? selectVariant(OitPermutations(), oitVariant)
+                          : selectVariant(MainPermutations(), mainVariant);
+    }
+
+    const Variant& indirectSelected() const {
+        return drawsOit() ? selectVariant(IndirectOitPermutations(), indirectOitVariant)
+                          : selectVariant(IndirectPermutations(), indirectVariant);
+    }
+
+    static PermutationSet& MainPermutations() {
+        static PermutationSet set("pbr", std::string("#version 330 core\n" FRAME_DATA_GLSL) + pbrVertexShaderBody,
+                                  pbrFragmentShaderSrc, Features(), "PBR_UBER");
+        return set;
+    }
+
+    // model + override z SSBO pres gl_DrawID (stejny fragment shader)
+    static PermutationSet& IndirectPermutations() {
+        static PermutationSet set("pbr-indirect", IndirectDraw::GlslPrelude() + FRAME_DATA_GLSL + pbrVertexShaderBody,
+                                  pbrFragmentShaderSrc, Features(), "PBR_UBER", {"INDIRECT_DRAW"});
+        return set;
+    }
+
+    static PermutationSet& OitPermutations() {
+        static PermutationSet set("pbr-oit", std::string("#version 330 core\n" FRAME_DATA_GLSL) + pbrVertexShaderBody,
+                                  pbrFragmentShaderSrc, Features(), "PBR_UBER", {"OIT"});
+        return set;
+    }
+
+    static PermutationSet& IndirectOitPermutations() {
+        static PermutationSet set("pbr-indirect-oit", IndirectDraw::GlslPrelude() + FRAME_DATA_GLSL + pbrVertexShaderBody,
+                                  pbrFragmentShaderSrc, Features(), "PBR_UBER", {"INDIRECT_DRAW", "OIT"});
+        return set;
+    }
+
+    const Variant& selectVariant(PermutationSet& set, Variant& slot) const {
+        uint32_t bits = FeatureBits();
+        if (slot.bits != bits) {
+            slot.bits = bits;
+            slot.requested.reset();
+        }
+        ProgramHandle specialized = set.Find(bits, slot.requested);
+        ProgramHandle program = specialized ? specialized : set.Uber();
+        slot.uber = specialized ? nullptr : program;
+        if (slot.handle != program) {
+            slot.handle = program;
+            slot.program = program->id;
+            slot.reflection = resolveUniforms(slot.program, slot.u);
         }
+        return slot;
+    }
+
+    static ProgramReflection* resolveUniforms(GLuint program, Uniforms& u) {
+        ProgramReflection& r = ProgramReflection::For(program);
+        u.model = r.Handle<glm::mat4>("model"_u);
+        u.normalMatrix = r.Handle<glm::mat3>("normalMatrix"_u);
+        u.mvp = r.Handle<glm::mat4>("mvp"_u);
+        u.materialOverride = r.Handle<glm::vec4>("materialOverride"_u);
+        u.instanced = r.Handle<int>("instanced"_u);
+        u.materialColor = r.Handle<glm::vec3>("materialColor"_u);
+        u.alpha = r.Handle<float>("alpha"_u);
+        u.metallic = r.Handle<float>("metallic"_u);
+        u.roughness = r.Handle<float>("roughness"_u);
+        u.ao = r.Handle<float>("ao"_u);
+        u.reflectionStrength = r.Handle<float>("reflectionStrength"_u);
+        u.transmission = r.Handle<float>("transmission"_u);
+        u.ior = r.Handle<float>("ior"_u);
+        u.environmentMap = r.Handle<int>("environmentMap"_u);
+        u.shadowMap = r.Handle<int>("shadowMap"_u);
+        u.shadowCascades = r.Handle<int>("shadowCascades"_u);
+        u.shadowMapDepth = r.Handle<int>("shadowMapDepth"_u);
+        u.shadowCascadesDepth = r.Handle<int>("shadowCascadesDepth"_u);
+        u.shadowMoments = r.Handle<int>("shadowMoments"_u);
+        u.shadowCascadeMoments = r.Handle<int>("shadowCascadeMoments"_u);
+        u.albedoMap = r.Handle<int>("albedoMap"_u);
+        u.normalMap = r.Handle<int>("normalMap"_u);
+        u.metallicMap = r.Handle<int>("metallicMap"_u);
+        u.roughnessMap = r.Handle<int>("roughnessMap"_u);
+        u.aoMap = r.Handle<int>("aoMap"_u);
+        u.useAlbedoMap = r.Handle<int>("useAlbedoMap"_u);
+        u.useNormalMap = r.Handle<int>("useNormalMap"_u);
+        u.useMetallicMap = r.Handle<int>("useMetallicMap"_u);
+        u.useRoughnessMap = r.Handle<int>("useRoughnessMap"_u);
+        u.useAoMap = r.Handle<int>("useAoMap"_u);
+        return &r;
+    }
+
+    // program, parametry materialu, textury a blend - spolecne pro single i instancovany draw
+    void bindShared(const Variant& v, unsigned int envCubemap, unsigned int shadowMap, GLStateCache& cache) const {
+        ProgramReflection& r = *v.reflection;
+        const Uniforms& u = v.u;
+        cache.UseProgram(v.program);
+        r.Set(u.materialColor, albedoColor); r.Set(u.alpha, alpha);
+        r.Set(u.metallic, metallic); r.Set(u.roughness, roughness);
+        r.Set(u.ao, ao); r.Set(u.reflectionStrength, reflectionStrength);
+        r.Set(u.transmission, transmission); r.Set(u.ior, ior);
+
+        cache.BindTexture(0, GL_TEXTURE_CUBE_MAP, envCubemap);
+        // Vycisteni (unbind) GL_TEXTURE_2D, pokud tam nejaká stará vazba zůstala.
+        cache.BindTexture(0, GL_TEXTURE_2D, 0); // <-- EXPLICITNÍ ČIŠTĚNÍ
+        r.Set(u.environmentMap, 0);
+
+        // Jednotka 1: Shadow Map (sampler2DShadow - textura s GL_TEXTURE_COMPARE_MODE)
+        cache.BindTexture(1, GL_TEXTURE_2D, shadowMap);
+        // Vycisteni (unbind) GL_TEXTURE_CUBE_MAP, pro případné staré vazby.
+        cache.BindTexture(1, GL_TEXTURE_CUBE_MAP, 0); // <-- EXPLICITNÍ ČIŠTĚNÍ
+        r.Set(u.shadowMap, 1);
+
+        // kaskady vzdy na vlastni jednotce (sampler2DArrayShadow) - i kdyz jsou vypnute
+        cache.BindTexture(CascadedShadowMaps::TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, CascadedShadowMaps::Get().Texture());
+        r.Set(u.shadowCascades, CascadedShadowMaps::TEXTURE_UNIT);
+        // surova hloubka obou map pro PCSS (sampler bez compare na vlastnich jednotkach)
+        ShadowFilter::Get().BindDepth(cache, shadowMap, CascadedShadowMaps::Get().Texture());
+        r.Set(u.shadowMapDepth, ShadowFilter::DEPTH_UNIT);
+        r.Set(u.shadowCascadesDepth, ShadowFilter::CASCADE_DEPTH_UNIT);
+        // EVSM momenty (prefiltrovane po shadow pruchodu)
+        cache.BindTexture(EvsmShadow::TEXTURE_UNIT, GL_TEXTURE_2D, EvsmShadow::Get().Texture());
+        cache.BindTexture(EvsmShadow::CASCADE_TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, EvsmShadow::Get().CascadeTexture());
+        r.Set(u.shadowMoments, EvsmShadow::TEXTURE_UNIT);
+        r.Set(u.shadowCascadeMoments, EvsmShadow::CASCADE_TEXTURE_UNIT);
+
+        bindTexture(r, cache, 2, u.albedoMap,    u.useAlbedoMap,    albedoMapID);
+        bindTexture(r, cache, 3, u.normalMap,    u.useNormalMap,    normalMapID);
+        bindTexture(r, cache, 4, u.metallicMap,  u.useMetallicMap,  metallicMapID);
+        bindTexture(r, cache, 5, u.roughnessMap, u.useRoughnessMap, roughnessMapID);
+        bindTexture(r, cache, 6, u.aoMap,        u.useAoMap,        aoMapID);
+
+        // behem OIT pruchodu patri blend (glBlendFunci pro oba cile) WeightedOIT
+        if (!WeightedOIT::Get().Active()) cache.SetBlend(IsTransparent());
     }
 
-    void setMat4(const std::string& name, const glm::mat4& mat) const { glUniformMatrix4fv(glGetUniformLocation(shaderProgramID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat)); }
-    void setVec3(const std::string& name, const glm::vec3& vec) const { glUniform3fv(glGetUniformLocation(shaderProgramID, name.c_str()), 1, glm::value_ptr(vec)); }
-    void setInt(const std::string& name, int value) const { glUniform1i(glGetUniformLocation(shaderProgramID, name.c_str()), value); }
-    void setFloat(const std::string& name, float value) const { glUniform1f(glGetUniformLocation(shaderProgramID, name.c_str()), value); }
+    void bindTexture(ProgramReflection& r, GLStateCache& cache, int unit, const UniformHandle<int>& sampler,
+                     const UniformHandle<int>& useFlag, unsigned int texID) const {
+        bool useTexture = (texID != 0);
+        // useFlag existuje jen v uber variante, specializovana ho ma jako konstantu
+        r.Set(useFlag, static_cast<int>(useTexture));
+        // sampler vzdy na vlastni jednotku - nevyuzity sampler2D na jednotce 0 (cubemap)
+        // by v uber variante byl neplatny draw (GL_INVALID_OPERATION)
+        r.Set(sampler, unit);
+        if (useTexture) cache.BindTexture(unit, GL_TEXTURE_2D, texID);
+    }
 };
 
 #endif // PBRMATERIAL_H
@@ -2,6 +2,7 @@
 #define PROCEDURALSKY_H
 
 #include "Shader.h"
+#include "FrameUniforms.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -23,17 +24,12 @@ const char *vertexShaderSource = R"(
         gl_Position = vec4(v_clipSpace, 1.0, 1.0);
     }
 )";
-const char *fragmentShaderSource = R"(
-    #version 330 core
+// inverzni matice, smer slunce a cas z bloku FrameData
+const char *fragmentShaderSource = "#version 330 core\n" FRAME_DATA_GLSL R"(
 
     in vec2 v_clipSpace;
     out vec4 FragColor;
 
-    uniform mat4 u_inverzniProjekce;
-    uniform mat4 u_inverzniPohled;
-    uniform vec3 u_sunDirection;
-    uniform float u_time;
-
     // --- ŠUMOVÉ FUNKCE PRO MRAKY (FBM - Fractal Brownian Motion) ---
 
     float random(vec2 st) {
@@ -69,13 +65,13 @@ const char *fragmentShaderSource = R"(
     {
         // Transformace pro směr pohledu
         vec4 clip = vec4(v_clipSpace, 1.0, 1.0);
-        vec4 view = u_inverzniProjekce * clip;
+        vec4 view = frame.invProjection * clip;
         view = view / view.w;
-        vec4 world = u_inverzniPohled * vec4(view.xyz, 0.0);
+        vec4 world = frame.invView * vec4(view.xyz, 0.0);
         vec3 direction = normalize(world.xyz);
 
         // --- 1. Základní barva oblohy a slunce ---
-        vec3 sunDir = normalize(u_sunDirection);
+        vec3 sunDir = normalize(frame.sunDirection.xyz);
         float sunHeight = smoothstep(-0.1, 0.2, sunDir.y);
 
         vec3 dayTopColor = vec3(0.5, 0.7, 1.0);
@@ -111,8 +107,8 @@ const char *fragmentShaderSource = R"(
         cloudUV.y *= cloudScale * 2.0;
 
         // Animace
-        cloudUV.x += u_time * 0.005;
-        cloudUV.y += u_time * 0.002;
+        cloudUV.x += frame.cameraPos.w * 0.005;
+        cloudUV.y += frame.cameraPos.w * 0.002;
 
         float density = fbm(cloudUV);
 
@@ -176,23 +172,12 @@ public:
     }
 
 
-    void Draw(const glm::mat4 &invView, const glm::mat4 &invProjection,
-              const glm::vec3 &sunDirection, float time) {
-
+    // FrameData.sunDirection a cas (cameraPos.w) musi byt nastavene pred Upload()
+    void Draw() {
 
         glDepthMask(GL_FALSE);
         glUseProgram(m_skyShader);
 
-        glUniformMatrix4fv(glGetUniformLocation(m_skyShader, "u_inverzniProjekce"),
-                           1, GL_FALSE, glm::value_ptr(invProjection));
-        glUniformMatrix4fv(glGetUniformLocation(m_skyShader, "u_inverzniPohled"), 1,
-                           GL_FALSE, glm::value_ptr(invView));
-        glUniform3fv(glGetUniformLocation(m_skyShader, "u_sunDirection"), 1,
-                     glm::value_ptr(sunDirection));
-
-        glUniform1f(glGetUniformLocation(m_skyShader, "u_time"), time);
-
-
         glBindVertexArray(m_skyVAO);
 
         glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -0,0 +1,226 @@
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// =========================================================================================
+// Perzistentni cache slinkovanych programu (glGetProgramBinary / glProgramBinary).
+// Klic = hash zdroju (defines uz jsou vlozene ve zdroji) + vendor/renderer/version driveru,
+// takze novy driver nebo jina GPU binarku jen nenajde. Soubor ma hlavicku s klicem,
+// formatem a kontrolnim souctem; cokoli nesedi (nebo driver binarku odmitne pri linku)
+// se smaze a program se zkompiluje normalne - volajici vidi jen Load() == 0.
+// =========================================================================================
+class ProgramBinaryCache {
+
+public:
+    struct Stats {
+        unsigned int loaded = 0;       // programy z disku
+        unsigned int compiled = 0;     // programy kompilovane ze zdroju
+        unsigned int rejected = 0;     // poskozene / odmitnute driverem
+        unsigned int stored = 0;       // nove zapsane binarky
+        double loadMs = 0.0;
+        double compileMs = 0.0;
+        size_t bytesRead = 0;
+    };
+
+    inline static bool enabled = true;
+    inline static std::string directory = "shader_cache";
+
+    static ProgramBinaryCache& Get() {
+        static ProgramBinaryCache instance;
+        return instance;
+    }
+
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+    // GL 4.1 / ARB_get_program_binary a aspon jeden binarni format
+    bool Supported() {
+        if (!enabled || !(GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary)) return false;
+        InitDriver();
+        return !formats.empty();
+    }
+
+    // Hotovy program z disku, 0 = neni v cache -> zkompilovat a zavolat Store
+    GLuint Load(const char* vertexSource, const char* fragmentSource) {
+        if (!Supported()) return 0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        uint64_t key = Key(vertexSource, fragmentSource);
+        std::filesystem::path path = PathFor(key);
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return 0;
+
+        Header header;
+        std::vector<char> binary;
+        bool valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+                  && header.magic == MAGIC && header.version == VERSION
+                  && header.driver == driverHash && header.key == key
+                  && std::find(formats.begin(), formats.end(), static_cast<GLint>(header.format)) != formats.end();
+        if (valid) {
+            binary.resize(header.length);
+            valid = static_cast<bool>(file.read(binary.data(), header.length))
+                 && file.peek() == std::char_traits<char>::eof()
+                 && Hash(binary.data(), binary.size()) == header.checksum;
+        }
+        file.close();
+
+        GLuint program = 0;
+        if (valid) {
+            program = glCreateProgram();
+            glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint ok = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &ok);
+            if (!ok) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (!program) {
+            std::cerr << "ProgramBinaryCache: neplatna binarka " << path.string() << ", kompiluji" << std::endl;
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            stats.rejected++;
+            return 0;
+        }
+
+        stats.loaded++;
+        stats.bytesRead += binary.size();
+        stats.loadMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+        return program;
+    }
+
+    // Pred glLinkProgram - driver si binarku ponecha pro glGetProgramBinary
+    void PrepareLink(GLuint program) {
+        if (Supported()) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // Po uspesnem linku; compileMs jde do statistik (i kdyz cache neni podporovana)
+    void Store(const char* vertexSource, const char* fragmentSource, GLuint program, double compileMs) {
+        stats.compiled++;
+        stats.compileMs += compileMs;
+        if (!Supported()) return;
+
+        GLint ok = 0, length = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!ok || length <= 0) return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+        binary.resize(length);
+
+        Header header;
+        header.driver = driverHash;
+        header.key = Key(vertexSource, fragmentSource);
+        header.format = format;
+        header.length = static_cast<uint32_t>(binary.size());
+        header.checksum = Hash(binary.data(), binary.size());
+
+        // zapis do .tmp a prejmenovani - prerusena aplikace nenecha napul zapsany soubor
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        std::filesystem::path path = PathFor(header.key);
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) return;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), binary.size());
+            if (!file) return;
+        }
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) std::filesystem::remove(tmp, ec);
+        else stats.stored++;
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    // Souhrn pro log po startu (warm start = vse "from disk")
+    std::string Report() const {
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1)
+          << "Programs: " << stats.loaded << " from disk (" << stats.loadMs << " ms, "
+          << stats.bytesRead / 1024 << " KB), " << stats.compiled << " compiled (" << stats.compileMs << " ms)";
+        if (stats.rejected) s << ", " << stats.rejected << " rejected";
+        return s.str();
+    }
+
+    // Smaze vsechny binarky (napr. po zmene shaderu mimo zdrojaky)
+    void Clear() {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x58424C47;   // "GLBX"
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t driver = 0;
+        uint64_t key = 0;
+        uint32_t format = 0;
+        uint32_t length = 0;
+        uint64_t checksum = 0;
+    };
+
+    std::vector<GLint> formats;
+    uint64_t driverHash = 0;
+    bool driverReady = false;
+    Stats stats;
+
+    ProgramBinaryCache() = default;
+
+    void InitDriver() {
+        if (driverReady) return;
+        driverReady = true;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+        formats.resize(count);
+        if (count > 0) glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+        std::string driver;
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const GLubyte* s = glGetString(name);
+            driver += s ? reinterpret_cast<const char*>(s) : "";
+            driver += '\n';
+        }
+        driverHash = Hash(driver.data(), driver.size());
+    }
+
+    // FNV-1a 64
+    static uint64_t Hash(const void* data, size_t size, uint64_t h = 1469598103934665603ull) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+        return h;
+    }
+
+    static uint64_t Key(const char* vertexSource, const char* fragmentSource) {
+        uint64_t h = Hash(vertexSource, std::strlen(vertexSource));
+        h = (h ^ 0xFFu) * 1099511628211ull;
+        return Hash(fragmentSource, std::strlen(fragmentSource), h);
+    }
+
+    static std::filesystem::path PathFor(uint64_t key) {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+        return std::filesystem::path(directory) / name.str();
+    }
+};
+
+#endif // PROGRAMBINARYCACHE_H
@@ -0,0 +1,283 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include "Shader.h"
+#include "ShaderReflection.h"
+#include "ProgramBinaryCache.h"
+
+// =========================================================================================
+// Sdileny GL program - vlastni ho shared_ptr, glDeleteProgram az s poslednim uzivatelem.
+// Z AcquireAsync prijde hned, ale kreslit s nim jde az po Ready() (funguje jako future).
+// =========================================================================================
+struct GpuProgram {
+    GLuint id = 0;
+    uint64_t key = 0;
+    bool pending = false;         // compile/link jeste bezi v driveru
+
+    bool Ready() const { return id != 0 && !pending; }
+
+    GpuProgram() = default;
+    GpuProgram(const GpuProgram&) = delete;
+    GpuProgram& operator=(const GpuProgram&) = delete;
+
+    ~GpuProgram() {
+        if (id) {
+            ProgramReflection::Forget(id);
+            glDeleteProgram(id);
+        }
+    }
+};
+
+using ProgramHandle = std::shared_ptr<GpuProgram>;
+
+// =========================================================================================
+// Cache programu: klic = hash zdroju + permutacnich defines -> weak_ptr na GpuProgram.
+// Stejny shader = jeden compile a jeden program v driveru bez ohledu na pocet materialu.
+// AcquireAsync jen zada compile + link a vrati handle; s KHR_parallel_shader_compile
+// driver kompiluje ve vlastnich vlaknech a Poll se pta GL_COMPLETION_STATUS bez cekani.
+// Bez rozsireni Poll dokonci nejvys 'budget' programu (blokujici dotaz na status).
+// =========================================================================================
+class ProgramCache {
+
+public:
+    struct Stats {
+        size_t compiles = 0;         // unikatni programy
+        size_t hits = 0;             // Acquire vyrizene z cache
+        double compileMs = 0.0;      // compile + link (synchronni)
+        size_t asyncCompiles = 0;    // z toho pres AcquireAsync
+        double asyncWaitMs = 0.0;    // blokujici cekani na nedokoncene (Wait / Poll bez rozsireni)
+    };
+
+    static ProgramCache& Get() {
+        static ProgramCache instance;
+        return instance;
+    }
+
+    // defines se vlozi za radek #version jako "#define X" (napr. "INDIRECT_DRAW", "USE_NORMAL_MAP 1")
+    ProgramHandle Acquire(const std::string& vertexSource, const std::string& fragmentSource,
+                          const std::vector<std::string>& defines = {}) {
+        uint64_t key = Key(vertexSource, fragmentSource, defines);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (ProgramHandle existing = it->second.lock()) {
+                stats.hits++;
+                if (existing->pending) Wait(existing);
+                return existing;
+            }
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        std::string vs = InjectDefines(vertexSource, defines);
+        std::string fs = InjectDefines(fragmentSource, defines);
+        Shader shader(vs.c_str(), fs.c_str(), true);
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        ProgramHandle program = std::make_shared<GpuProgram>();
+        program->id = shader.ID;
+        program->key = key;
+
+        stats.compiles++;
+        stats.compileMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        entries[key] = program;
+        return program;
+    }
+
+    // Zada compile + link a hned vrati handle (id uz existuje, Ready() az po dokonceni).
+    // Binarka z disku (ProgramBinaryCache) je Ready() okamzite.
+    ProgramHandle AcquireAsync(const std::string& vertexSource, const std::string& fragmentSource,
+                               const std::vector<std::string>& defines = {}) {
+        uint64_t key = Key(vertexSource, fragmentSource, defines);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (ProgramHandle existing = it->second.lock()) {
+                stats.hits++;
+                return existing;
+            }
+        }
+        EnableParallelCompile();
+
+        PendingCompile job;
+        job.vertexSource = InjectDefines(vertexSource, defines);
+        job.fragmentSource = InjectDefines(fragmentSource, defines);
+
+        ProgramHandle program = std::make_shared<GpuProgram>();
+        program->key = key;
+        entries[key] = program;
+        stats.compiles++;
+        stats.asyncCompiles++;
+
+        program->id = ProgramBinaryCache::Get().Load(job.vertexSource.c_str(), job.fragmentSource.c_str());
+        if (program->id) {
+            ProgramReflection::For(program->id);
+            return program;
+        }
+
+        // jen zadani prace - zadny dotaz na status, ten by cekal na driver
+        job.vertex = CompileStage(GL_VERTEX_SHADER, job.vertexSource);
+        job.fragment = CompileStage(GL_FRAGMENT_SHADER, job.fragmentSource);
+        program->id = glCreateProgram();
+        glAttachShader(program->id, job.vertex);
+        glAttachShader(program->id, job.fragment);
+        ProgramBinaryCache::Get().PrepareLink(program->id);
+        glLinkProgram(program->id);
+        program->pending = true;
+
+        job.program = program;
+        job.started = std::chrono::high_resolution_clock::now();
+        pending.push_back(std::move(job));
+        return program;
+    }
+
+    // Dokonci hotove programy (volat jednou za frame); bez rozsireni nejvys 'budget' blokujicich
+    void Poll(int budget = 1) {
+        for (size_t i = 0; i < pending.size();) {
+            PendingCompile& job = pending[i];
+            ProgramHandle program = job.program.lock();
+            bool done = !program;
+            if (program) {
+                if (ParallelSupported()) {
+                    GLint complete = GL_FALSE;
+                    glGetProgramiv(program->id, GL_COMPLETION_STATUS_KHR, &complete);
+                    done = complete == GL_TRUE;
+                } else {
+                    done = budget-- > 0;
+                }
+            }
+            if (!done) { ++i; continue; }
+            Finish(job, program);
+            pending.erase(pending.begin() + i);
+        }
+    }
+
+    // Blokujici dokonceni jednoho programu (prvni pouziti bez fallbacku)
+    void Wait(const ProgramHandle& program) {
+        if (!program || !program->pending) return;
+        auto it = std::find_if(pending.begin(), pending.end(),
+                               [&](const PendingCompile& j) { return j.program.lock() == program; });
+        if (it == pending.end()) return;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        Finish(*it, program);
+        pending.erase(it);
+        stats.asyncWaitMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    }
+
+    size_t PendingCount() const { return pending.size(); }
+
+    static bool ParallelSupported() {
+        return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+    }
+
+    // Pocet zivych programu (zaroven uklidi expirovane zaznamy)
+    size_t LiveCount() {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.expired()) it = entries.erase(it);
+            else ++it;
+        }
+        return entries.size();
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    // FNV-1a 64 pres oba zdroje a defines (s oddelovacem - "ab"+"c" != "a"+"bc")
+    static uint64_t Key(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::vector<std::string>& defines) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const std::string& s) {
+            for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+            h = (h ^ 0xFFu) * 1099511628211ull;
+        };
+        mix(vertexSource);
+        mix(fragmentSource);
+        for (const std::string& d : defines) mix(d);
+        return h;
+    }
+
+    static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines) {
+        if (defines.empty()) return source;
+        std::string block;
+        for (const std::string& d : defines) block += "#define " + d + "\n";
+
+        // za #version (a pripadne #extension radky, ty musi byt pred kodem)
+        size_t pos = 0;
+        size_t version = source.find("#version");
+        if (version != std::string::npos) {
+            pos = source.find('\n', version);
+            pos = (pos == std::string::npos) ? source.size() : pos + 1;
+            while (source.compare(pos, 10, "#extension") == 0) {
+                size_t end = source.find('\n', pos);
+                pos = (end == std::string::npos) ? source.size() : end + 1;
+            }
+        }
+        return source.substr(0, pos) + block + source.substr(pos);
+    }
+
+private:
+    struct PendingCompile {
+        std::weak_ptr<GpuProgram> program;
+        GLuint vertex = 0, fragment = 0;
+        std::string vertexSource, fragmentSource;     // klic ProgramBinaryCache
+        std::chrono::high_resolution_clock::time_point started;
+    };
+
+    std::unordered_map<uint64_t, std::weak_ptr<GpuProgram>> entries;
+    std::vector<PendingCompile> pending;
+    Stats stats;
+    bool parallelEnabled = false;
+
+    // driver si vybere pocet vlaken sam (0xFFFFFFFF = implementacni maximum)
+    void EnableParallelCompile() {
+        if (parallelEnabled) return;
+        parallelEnabled = true;
+        if (GLAD_GL_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        else if (GLAD_GL_ARB_parallel_shader_compile) glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+    }
+
+    static GLuint CompileStage(GLenum type, const std::string& source) {
+        GLuint shader = glCreateShader(type);
+        const char* src = source.c_str();
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // Status + logy, uklid stage, binarka na disk a reflexe (navaze FrameData)
+    void Finish(PendingCompile& job, const ProgramHandle& program) {
+        if (program) {
+            GLint ok = 0;
+            glGetProgramiv(program->id, GL_LINK_STATUS, &ok);
+            if (!ok) {
+                char infoLog[1024];
+                for (GLuint stage : {job.vertex, job.fragment}) {
+                    glGetShaderInfoLog(stage, sizeof(infoLog), nullptr, infoLog);
+                    if (infoLog[0]) std::cout << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+                }
+                glGetProgramInfoLog(program->id, sizeof(infoLog), nullptr, infoLog);
+                std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+            }
+            glDetachShader(program->id, job.vertex);
+            glDetachShader(program->id, job.fragment);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - job.started).count();
+            if (ok) ProgramBinaryCache::Get().Store(job.vertexSource.c_str(), job.fragmentSource.c_str(), program->id, ms);
+            ProgramReflection::For(program->id);
+            program->pending = false;
+        }
+        glDeleteShader(job.vertex);
+        glDeleteShader(job.fragment);
+    }
+
+    ProgramCache() = default;
+};
+
+#endif // PROGRAMCACHE_H
@@ -0,0 +1,737 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "SceneObject.h"
+#include "GLStateCache.h"
+#include "FrameUniforms.h"
+#include "ShaderReflection.h"
+#include "InstanceBuffer.h"
+#include "ObjectMatrices.h"
+#include "IndirectDraw.h"
+#include "ShaderPermutations.h"
+#include "DepthPrePass.h"
+#include "WeightedOIT.h"
+#include "CascadedShadowMaps.h"
+#include "ShadowCache.h"
+
+enum class RenderPass : uint8_t { Shadow = 0, Opaque = 1, Transparent = 2 };
+
+// Jeden draw - data pro submit; razeni jde pres SortEntry (klic + index), ne pres pakety.
+// Matice objektu jsou v RenderQueue::objects pod stejnym indexem (souvisle pro ObjectMatrices).
+struct DrawPacket {
+    const StaticMesh* mesh = nullptr;
+    ModelFBX* model = nullptr;            // skinovany model - vlastni draw mimo cache
+    GLuint program = 0;                   // depth program (shadow pass)
+    unsigned int envCubemap = 0;
+    unsigned int shadowMap = 0;
+    glm::vec3 boundsMin = glm::vec3(0.0f);   // AABB ve svete (shadow caster, culling kaskad)
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    bool bounded = false;
+    bool staticCaster = false;            // ShadowCache: kresli se jen pri zmene statickeho obsahu
+};
+
+// =========================================================================================
+// Render queue: sbira pakety, seradi je podle 64bit klice (radix sort) a posila je
+// pres GLStateCache, takze sousedni pakety se stejnym programem/texturami/VAO
+// nemeni GL stav (meshe v GeometryArena sdili jeden VAO, klic proto nese id geometrie,
+// ne VAO - jinak by se pakety ruznych meshu se stejnym materialem prokladaly podle depth
+// a rozbily instancovane davky). Sousedni pakety se stejnou geometrii a materialem (shadow: programem)
+// se slouci do jednoho glDrawElementsInstancedBaseInstance (InstanceBuffer).
+// S GeometryArena a GL 4.6 (useIndirect) se cely beh davek se stejnym materialem
+// (shadow: vsechny) posle jednim glMultiDrawElementsIndirect - kazda davka je jeden
+// prikaz, model/override cte shader z SSBO (IndirectDraw). Meshe s meshlety jdou v barevnych
+// pruchodech dal pres single draw kvuli CPU cullingu.
+// SubmitDepthPrePass kresli opaque pakety pozicnim depth programem kamerou (DepthPrePass);
+// nasledny Submit(Opaque) pak testuje GL_EQUAL bez zapisu depth.
+// SubmitShadowCascades kresli shadow pakety do CascadedShadowMaps - kazdy caster jen do
+// kaskad, ktere jeho AABB protina; s layered vsechny kaskady jednim multi-draw (gl_Layer).
+// SubmitShadowMap / SubmitShadowCascades s ShadowCache kresli staticke castery jen pri zmene
+// svetla nebo statickeho obsahu, jinak obnovi vrstvu z kopie a kresli jen dynamicke castery.
+// Pruhledny pruchod jde s WeightedOIT do accum/reveal cilu - poradi nehraje roli, takze se
+// radi podle stavu jako opaque (a muze se instancovat); bez OIT zezadu dopredu.
+//
+// Klic (MSB -> LSB):
+//   Shadow/Opaque/OIT: pass:2 | program:10 | material:12 | textures:12 | geometry:12 | depth:16 (front-to-back)
+//   Transparent:       pass:2 | depth:16 (back-to-front) | program:10 | material:12 | textures:12 | geometry:12
+// =========================================================================================
+class RenderQueue {
+
+public:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    struct Stats {
+        unsigned int packets[3] = {0, 0, 0};
+        unsigned int drawCalls = 0;
+        unsigned int instancedDraws = 0;
+        unsigned int instances = 0;       // objekty nakreslene v instancovanych davkach
+        unsigned int radixPasses = 0;     // 8bit pruchody, ktere nesly preskocit
+        unsigned int indirectDraws = 0;   // glMultiDrawElementsIndirect volani
+        unsigned int indirectCommands = 0;
+        double sortMs = 0.0;
+        double matrixMs = 0.0;            // normalMatrix + MVP vsech paketu (ObjectMatrices)
+        unsigned int cascadeCasters[CascadedShadowMaps::MAX_CASCADES] = {};   // castery po cullingu
+    };
+
+    float maxSortDistance = 1000.0f;      // vzdalenost od kamery mapovana na 16bit depth
+    unsigned int minInstances = 2;        // mensi davky jdou pres single draw (s meshlet cullingem)
+    bool useIndirect = true;              // multi-draw indirect pro geometrii v GeometryArena
+
+    void Clear() {
+        packets.clear();
+        objects.clear();
+        entries.clear();
+        sorted = false;
+        prePassDone = false;
+        stats = Stats();
+    }
+
+    // Barevny pruchod - pass (opaque/transparent) podle materialu
+    void Add(const SceneObject& object, unsigned int envCubemap, unsigned int shadowMap) {
+        DrawPacket p;
+        InstanceData o;
+        o.model = object.worldMatrix();
+        o.materialOverride = object.materialOverride;
+        p.envCubemap = envCubemap;
+        p.shadowMap = shadowMap;
+
+        RenderPass pass = RenderPass::Opaque;
+        uint32_t program = 0, material = 0, textures = 0, geometry = 0;
+        if (const StaticMesh* mesh = object.getStaticMesh()) {
+            if (!mesh->material || mesh->VAO() == 0) return;
+            p.mesh = mesh;
+            pass = mesh->material->IsTransparent() ? RenderPass::Transparent : RenderPass::Opaque;
+            program = mesh->material->ProgramID();
+            material = CompactId(materialIds, reinterpret_cast<uintptr_t>(mesh->material));
+            uint32_t texHash = mesh->material->TextureSetHash();
+            texHash = (texHash ^ envCubemap) * 16777619u;
+            texHash = (texHash ^ shadowMap) * 16777619u;
+            textures = CompactId(textureIds, texHash);
+            geometry = GeometryId(mesh->geometry.get());
+        } else if (ModelFBX* model = object.getModel()) {
+            p.model = model;
+            o.model = model->transform.GetModelMatrix();   // ModelFBX kresli se svym transformem
+            program = model->program();
+            material = CompactId(materialIds, reinterpret_cast<uintptr_t>(model));
+        } else {
+            return;
+        }
+
+        const bool backToFront = pass == RenderPass::Transparent && !OitEnabled();
+        Push(p, o, MakeKey(pass, program, material, textures, geometry, Depth(o.model), backToFront));
+    }
+
+    // Shadow pruchod s danym depth programem
+    void AddShadowCaster(const SceneObject& object, GLuint depthProgram) {
+        DrawPacket p;
+        InstanceData o;
+        o.model = object.worldMatrix();
+        o.materialOverride = NoMaterialOverride();
+        p.program = depthProgram;
+        p.staticCaster = object.staticShadow && !object.getModel();   // skinovany model se hybe vzdy
+
+        uint32_t geometry = 0;
+        if (const StaticMesh* mesh = object.getStaticMesh()) {
+            if (mesh->VAO() == 0 || mesh->IndexCount() == 0) return;
+            p.mesh = mesh;
+            geometry = GeometryId(mesh->geometry.get());
+            if (mesh->localAABB.min.x <= mesh->localAABB.max.x) {   // prazdny AABB = bez cullingu
+                const BoxCollider bounds = mesh->localAABB.GetTransformed(o.model);
+                p.boundsMin = bounds.min;
+                p.boundsMax = bounds.max;
+                p.bounded = true;
+            }
+        } else if (ModelFBX* model = object.getModel()) {
+            p.model = model;
+        } else {
+            return;
+        }
+
+        // depth ve shadow pruchodu nema smysl (ortho svetlo), radi se jen podle stavu
+        Push(p, o, MakeKey(RenderPass::Shadow, depthProgram, 0, 0, geometry, 0));
+    }
+
+    void Submit(RenderPass pass) {
+        if (pass == RenderPass::Opaque && prePassDone) {
+            // depth uz je hotovy - stinuje se jen fragment, ktery pre-pass nechal navrchu
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+            SubmitPass(pass, Mode::Colour);
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+            return;
+        }
+        if (pass == RenderPass::Transparent && OitEnabled()) {
+            // akumulace bez razeni + jeden composite pruchod
+            if (WeightedOIT::Get().Begin()) {
+                SubmitPass(pass, Mode::Colour);
+                WeightedOIT::Get().Composite();
+                return;
+            }
+        }
+        // bez pre-passu se meri overdraw barevneho pruchodu (samples query nejde vnorit
+        // do mereni variant - s ShaderPermutations::profiling se mereni vynecha)
+        const bool measure = pass == RenderPass::Opaque && !ShaderPermutations::Get().profiling;
+        if (measure) DepthPrePass::Get().BeginMeasure();
+        SubmitPass(pass, pass == RenderPass::Shadow ? Mode::ShadowDepth : Mode::Colour);
+        if (measure) DepthPrePass::Get().EndMeasure();
+    }
+
+    // Opaque pakety jen do depth bufferu kamerou (depth.vert s prePass = true), pred Submit(Opaque).
+    // Skinovane modely se vynechaji - v barevnem pruchodu kresli s GL_LESS jako bez pre-passu.
+    // depth.frag nic nezapisuje - bez masky by obsah barevneho cile byl nedefinovany (a platil
+    // by se zapis barvy, kterym ma pre-pass setrit).
+    void SubmitDepthPrePass(GLuint depthProgram) {
+        prePassProgram = depthProgram;
+        GLStateCache& cache = GLStateCache::Get();
+        cache.SetColorMask(false);
+        DepthPrePass::Get().BeginMeasure();
+        SubmitPass(RenderPass::Opaque, Mode::PrePassDepth);
+        DepthPrePass::Get().EndMeasure();
+        cache.SetColorMask(true);
+        prePassDone = true;
+    }
+
+    // Shadow pakety do jednoduche shadow mapy (fbo s depth texturou). S ShadowCache se staticke
+    // castery kresli jen pri zmene lightSpaceMatrix nebo statickeho obsahu, jinak se mapa obnovi z kopie.
+    void SubmitShadowMap(GLuint fbo, GLuint depthTexture, GLsizei width, GLsizei height) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        ShadowCache& shadowCache = ShadowCache::Get();
+        if (!shadowCache.Active()) {
+            glClear(GL_DEPTH_BUFFER_BIT);
+            SubmitPass(RenderPass::Shadow, Mode::ShadowDepth);
+            return;
+        }
+        if (!sorted) Sort();
+        auto range = PassRange(RenderPass::Shadow);
+
+        uint64_t staticHash = 0;
+        unsigned int staticCasters = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!packets[it->index].staticCaster) continue;
+            staticHash = ShadowCache::Combine(staticHash, CasterHash(it->index));
+            staticCasters++;
+        }
+
+        const glm::mat4& lightMatrix = FrameUniforms::Get().data.lightSpaceMatrix;
+        if (shadowCache.Valid(depthTexture, 0, lightMatrix, staticHash)) {
+            shadowCache.Restore(depthTexture, 0);
+            shadowCache.CountSkipped(staticCasters);
+        } else {
+            glClear(GL_DEPTH_BUFFER_BIT);
+            SubmitShadowCasters(range.first, range.second, -1, Casters::Static);
+            shadowCache.Store(depthTexture, GL_TEXTURE_2D, 0, lightMatrix, staticHash);
+        }
+        SubmitShadowCasters(range.first, range.second, -1, Casters::Dynamic);
+    }
+
+    // Shadow pakety do kaskad csm (misto Submit(Shadow)). Castery bez AABB (ModelFBX) jdou do vsech.
+    // S ShadowCache se staticke castery kaskady kresli jen pri zmene jeji matice (pohyb kamery
+    // o texel, svetlo) nebo statickeho obsahu kaskady.
+    void SubmitShadowCascades(CascadedShadowMaps& csm) {
+        const int count = csm.Count();
+        if (count == 0) return;
+        if (!sorted) Sort();
+        auto range = PassRange(RenderPass::Shadow);
+
+        uint64_t staticHash[CascadedShadowMaps::MAX_CASCADES] = {};
+        unsigned int staticCasters[CascadedShadowMaps::MAX_CASCADES] = {};
+        cascadeMasks.resize(packets.size());
+        for (auto it = range.first; it != range.second; ++it) {
+            const DrawPacket& p = packets[it->index];
+            uint32_t mask = p.bounded ? csm.CascadeMask(p.boundsMin, p.boundsMax) : csm.AllCascades();
+            cascadeMasks[it->index] = mask;
+            const uint64_t hash = p.staticCaster ? CasterHash(it->index) : 0;
+            for (int c = 0; c < count; ++c) {
+                if (!(mask & (1u << c))) continue;
+                stats.cascadeCasters[c]++;
+                if (!p.staticCaster) continue;
+                staticHash[c] = ShadowCache::Combine(staticHash[c], hash);
+                staticCasters[c]++;
+            }
+        }
+
+        ShadowCache& shadowCache = ShadowCache::Get();
+        if (!shadowCache.Active()) {
+            DrawCascades(csm, range.first, range.second, csm.AllCascades(), Casters::All, true);
+            return;
+        }
+
+        uint32_t rebuild = 0;
+        for (int c = 0; c < count; ++c)
+            if (!shadowCache.Valid(csm.Texture(), c, csm.Matrix(c), staticHash[c])) rebuild |= 1u << c;
+        // staticke castery jen do neplatnych kaskad (layered clear maze vse - platne se hned obnovi)
+        if (rebuild) DrawCascades(csm, range.first, range.second, rebuild, Casters::Static, true);
+        for (int c = 0; c < count; ++c) {
+            if (rebuild & (1u << c)) {
+                shadowCache.Store(csm.Texture(), GL_TEXTURE_2D_ARRAY, c, csm.Matrix(c), staticHash[c]);
+            } else {
+                shadowCache.Restore(csm.Texture(), c);
+                shadowCache.CountSkipped(staticCasters[c]);
+            }
+        }
+        DrawCascades(csm, range.first, range.second, csm.AllCascades(), Casters::Dynamic, false);
+    }
+
+    const Stats& GetStats() const { return stats; }
+    size_t Size() const { return packets.size(); }
+
+    // Kompaktni id geometrie do klice (12 bitu, drzi se mezi framy jako id materialu)
+    uint32_t GeometryId(const GpuGeometry* geometry) {
+        return CompactId(geometryIds, reinterpret_cast<uintptr_t>(geometry));
+    }
+
+    static uint64_t MakeKey(RenderPass pass, uint32_t program, uint32_t material,
+                            uint32_t textures, uint32_t geometry, uint32_t depth, bool backToFront = false) {
+        uint64_t key = static_cast<uint64_t>(pass) << 62;
+        uint64_t state = (static_cast<uint64_t>(program & 0x3FF) << 36) |
+                         (static_cast<uint64_t>(material & 0xFFF) << 24) |
+                         (static_cast<uint64_t>(textures & 0xFFF) << 12) |
+                         static_cast<uint64_t>(geometry & 0xFFF);
+        if (backToFront)
+            return key | (static_cast<uint64_t>(0xFFFF - (depth & 0xFFFF)) << 46) | state;
+        return key | (state << 16) | (depth & 0xFFFF);
+    }
+
+    // LSD radix sort po 8 bitech (stabilni); bajty se stejnou hodnotou u vsech klicu se preskoci
+    static unsigned int RadixSort(std::vector<SortEntry>& items, std::vector<SortEntry>& scratch) {
+        const size_t n = items.size();
+        if (n < 2) return 0;
+        scratch.resize(n);
+
+        size_t counts[8][256] = {};
+        for (const SortEntry& e : items)
+            for (int d = 0; d < 8; ++d)
+                counts[d][(e.key >> (d * 8)) & 0xFF]++;
+
+        SortEntry* src = items.data();
+        SortEntry* dst = scratch.data();
+        unsigned int passes = 0;
+        for (int d = 0; d < 8; ++d) {
+            const int shift = d * 8;
+            if (counts[d][(src[0].key >> shift) & 0xFF] == n) continue;
+
+            size_t offsets[256];
+            size_t sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                offsets[b] = sum;
+                sum += counts[d][b];
+            }
+            for (size_t i = 0; i < n; ++i)
+                dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+            std::swap(src, dst);
+            passes++;
+        }
+        if (src != items.data())
+            std::copy(src, src + n, items.data());
+        return passes;
+    }
+
+private:
+    // jak se pakety kresli: depth-only programem (shadow / pre-pass) nebo materialem
+    enum class Mode : uint8_t { ShadowDepth, PrePassDepth, Colour };
+
+    using EntryIterator = std::vector<SortEntry>::const_iterator;
+
+    // rozsah paketu daneho pruchodu (pass je v nejvyssich bitech)
+    std::pair<EntryIterator, EntryIterator> PassRange(RenderPass pass) const {
+        uint64_t passBits = static_cast<uint64_t>(pass) << 62;
+        auto first = std::lower_bound(entries.begin(), entries.end(), passBits,
+                                      [](const SortEntry& e, uint64_t k) { return e.key < k; });
+        auto last = first;
+        while (last != entries.end() && (last->key >> 62) == static_cast<uint64_t>(pass)) ++last;
+        return {first, last};
+    }
+
+    void SubmitPass(RenderPass pass, Mode mode) {
+        if (!sorted) Sort();
+        auto range = PassRange(pass);
+
+        // indirect: kazdy beh je prikaz s instanceCount >= 1, data objektu jdou vzdy pres instanceData
+        const bool indirect = useIndirect && IndirectDraw::Supported();
+        BuildBatches(range.first, range.second, mode, indirect ? 1u : minInstances);
+        BuildIndirectRuns(mode, indirect);
+        DrawBatches(mode);
+    }
+
+    // ktere shadow castery se kresli (ShadowCache: staticke zvlast do cache, dynamicke pres ni)
+    enum class Casters : uint8_t { All, Static, Dynamic };
+
+    // Shadow pakety kaskady c (c < 0 = bez kaskad) do shadowEntries, poradi zustava serazene.
+    // S layered jdou indirectable pakety do spolecneho multi-draw (layeredPart), po kaskadach jen zbytek.
+    void CollectShadow(EntryIterator first, EntryIterator last, int c, Casters casters,
+                       bool layered = false, bool layeredPart = false) {
+        shadowEntries.clear();
+        for (auto it = first; it != last; ++it) {
+            const DrawPacket& p = packets[it->index];
+            if (c >= 0 && !(cascadeMasks[it->index] & (1u << c))) continue;
+            if (casters != Casters::All && p.staticCaster != (casters == Casters::Static)) continue;
+            if (layered && Indirectable(p, Mode::ShadowDepth) != layeredPart) continue;
+            shadowEntries.push_back(*it);
+        }
+    }
+
+    // Vybrane shadow pakety do aktualne navazaneho cile (bez clear)
+    void SubmitShadowCasters(EntryIterator first, EntryIterator last, int c, Casters casters) {
+        CollectShadow(first, last, c, casters);
+        if (shadowEntries.empty()) return;
+        const bool indirect = useIndirect && IndirectDraw::Supported();
+        BuildBatches(shadowEntries.begin(), shadowEntries.end(), Mode::ShadowDepth, indirect ? 1u : minInstances);
+        BuildIndirectRuns(Mode::ShadowDepth, indirect);
+        DrawBatches(Mode::ShadowDepth);
+    }
+
+    // Vybrane castery do kaskad z masky cascades; clear = vycistit vrstvy pred kreslenim
+    void DrawCascades(CascadedShadowMaps& csm, EntryIterator first, EntryIterator last,
+                      uint32_t cascades, Casters casters, bool clear) {
+        const int count = csm.Count();
+        const bool indirect = useIndirect && IndirectDraw::Supported();
+        const bool layered = indirect && csm.Layered() && IndirectDraw::Get().LayeredDepthProgram() != 0;
+        if (layered) {
+            // castery v arene ze vsech kaskad v jednom behu - vrstva jde v hornich bitech firstObject
+            batches.clear();
+            instanceData.clear();
+            for (int c = 0; c < count; ++c) {
+                if (!(cascades & (1u << c))) continue;
+                CollectShadow(first, last, c, casters, true, true);
+                AppendBatches(shadowEntries.begin(), shadowEntries.end(), Mode::ShadowDepth, 1u, c);
+            }
+            BuildIndirectRuns(Mode::ShadowDepth, true);
+            csm.BeginLayered(clear);
+            layeredShadow = true;
+            DrawBatches(Mode::ShadowDepth);
+            layeredShadow = false;
+        }
+
+        // po kaskadach: vse (bez layered) nebo zbytek mimo arenu (ModelFBX, meshe bez areny)
+        for (int c = 0; c < count; ++c) {
+            if (!(cascades & (1u << c))) continue;
+            CollectShadow(first, last, c, casters, layered, false);
+            if (!layered) csm.BeginCascade(c, clear);    // i prazdnou kaskadu je treba vycistit
+            if (shadowEntries.empty()) continue;
+            if (layered) csm.BeginCascade(c, false);
+            shadowCascade = c;
+            BuildBatches(shadowEntries.begin(), shadowEntries.end(), Mode::ShadowDepth, indirect ? 1u : minInstances);
+            BuildIndirectRuns(Mode::ShadowDepth, indirect && !layered);
+            DrawBatches(Mode::ShadowDepth);
+        }
+        shadowCascade = 0;
+    }
+
+    uint64_t CasterHash(uint32_t index) const {
+        const DrawPacket& p = packets[index];
+        const void* geometry = p.mesh ? static_cast<const void*>(p.mesh->geometry.get()) : static_cast<const void*>(p.model);
+        return ShadowCache::CasterHash(geometry, p.program, objects[index].model);
+    }
+
+    // Nakresli batches (+ runs z BuildIndirectRuns)
+    void DrawBatches(Mode mode) {
+        bool needInstances = false;
+        for (const Batch& b : batches) needInstances |= !b.indirect && b.count > 1;
+        if (needInstances) InstanceBuffer::Get().Upload(instanceData);
+
+        GLStateCache& cache = GLStateCache::Get();
+        cache.Invalidate();
+
+        const bool depthOnly = mode != Mode::Colour;
+        GLuint depthProgram = 0;
+        UniformHandle<glm::mat4> depthModel, depthMvp;
+        UniformHandle<int> depthInstanced, depthPrePass, depthCascade;
+
+        size_t nextRun = 0;
+        for (size_t i = 0; i < batches.size(); ++i) {
+            if (nextRun < runs.size() && runs[nextRun].firstBatch == i) {
+                SubmitIndirect(runs[nextRun], mode, cache);
+                i = runs[nextRun++].endBatch - 1;
+                continue;
+            }
+
+            const Batch& b = batches[i];
+            const DrawPacket& p = packets[b.packet];
+            const InstanceData& o = objects[b.packet];
+
+            if (p.model) {
+                if (mode == Mode::PrePassDepth) continue;
+                // ModelFBX si stav nastavuje sam (glUseProgram, textury) a na konci vola glUseProgram(0)
+                if (mode == Mode::ShadowDepth) {
+                    ProgramReflection& r = ProgramReflection::For(p.program);
+                    r.Set(r.Handle<int>("shadowCascade"_u), shadowCascade);
+                    p.model->DrawForShadow(p.program);
+                } else if (prePassDone) {
+                    // neni v pre-passu - depth test a zapis jako bez nej
+                    glDepthFunc(GL_LESS);
+                    glDepthMask(GL_TRUE);
+                    p.model->draw();
+                    glDepthFunc(GL_EQUAL);
+                    glDepthMask(GL_FALSE);
+                } else {
+                    p.model->draw();
+                }
+                cache.Invalidate();
+                stats.drawCalls++;
+                continue;
+            }
+
+            GpuGeometry& geo = *p.mesh->geometry;
+            const bool instanced = b.count > 1;
+
+            if (depthOnly) {
+                GLuint program = mode == Mode::PrePassDepth ? prePassProgram : p.program;
+                cache.UseProgram(program);
+                ProgramReflection& r = ProgramReflection::For(program);
+                if (depthProgram != program) {
+                    depthProgram = program;
+                    depthModel = r.Handle<glm::mat4>("model"_u);
+                    depthMvp = r.Handle<glm::mat4>("mvp"_u);
+                    depthInstanced = r.Handle<int>("instanced"_u);
+                    depthPrePass = r.Handle<int>("prePass"_u);
+                    depthCascade = r.Handle<int>("shadowCascade"_u);
+                }
+                r.Set(depthPrePass, mode == Mode::PrePassDepth ? 1 : 0);
+                r.Set(depthCascade, shadowCascade);
+                r.Set(depthInstanced, instanced ? 1 : 0);
+                if (!instanced) {
+                    r.Set(depthModel, o.model);
+                    r.Set(depthMvp, o.mvp);
+                }
+            } else if (instanced) {
+                p.mesh->material->bindInstanced(p.envCubemap, p.shadowMap, cache);
+            } else {
+                p.mesh->material->bind(o, p.envCubemap, p.shadowMap, cache);
+            }
+
+            cache.BindVertexArray(geo.VAO);
+            // cena varianty shaderu (jen s ShaderPermutations::profiling)
+            if (!depthOnly) ShaderPermutations::Get().BeginDraw(p.mesh->material->ProgramID());
+            if (instanced) {
+                InstanceBuffer::Get().AttachTo(geo);
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, geo.indexCount, geo.indexType,
+                                                              geo.IndexOffset(), b.count, geo.BaseVertex(),
+                                                              b.baseInstance);
+                stats.instancedDraws++;
+                stats.instances += b.count;
+            } else if (depthOnly) {
+                glDrawElementsBaseVertex(GL_TRIANGLES, geo.indexCount, geo.indexType,
+                                         geo.IndexOffset(), geo.BaseVertex());
+            } else {
+                p.mesh->DrawElements(o.model);
+            }
+            ShaderPermutations::Get().EndDraw();
+            stats.drawCalls++;
+        }
+
+        cache.BindVertexArray(0);
+        cache.UseProgram(0);
+        cache.SetBlend(false);
+    }
+
+    // souvisly beh paketu se stejnym stavem; count >= minInstances => instancovany draw
+    struct Batch {
+        uint32_t packet;          // prvni paket davky
+        uint32_t count;
+        uint32_t baseInstance;    // offset v InstanceBuffer
+        bool indirect = false;    // soucasti IndirectRun
+        uint32_t layer = 0;       // kaskada v layered shadow pruchodu
+    };
+
+    // souvisly beh davek nad jednou arenou se stejnym stavem = jeden glMultiDrawElementsIndirect
+    struct IndirectRun {
+        size_t firstBatch, endBatch;
+        GLuint firstCommand;
+    };
+
+    std::vector<DrawPacket> packets;
+    std::vector<InstanceData> objects;    // matice + override paketu (index = index paketu)
+    std::vector<Batch> batches;
+    std::vector<InstanceData> instanceData;
+    std::vector<IndirectRun> runs;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<GLuint> firstObjects;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+    std::vector<SortEntry> shadowEntries;    // vybrane shadow pakety (kaskada, static/dynamic)
+    std::vector<uint32_t> cascadeMasks;      // kaskady paketu (index = index paketu)
+    int shadowCascade = 0;                   // uniform shadowCascade depth programu
+    bool layeredShadow = false;              // indirect depth = LayeredDepthProgram
+    bool sorted = false;
+    bool prePassDone = false;             // Submit(Opaque) kresli s GL_EQUAL
+    GLuint prePassProgram = 0;
+    Stats stats;
+
+    // kompaktni ID (12 bitu) pro materialy, sady textur a geometrie - drzi se mezi framy, klice jsou stabilni
+    std::unordered_map<uint64_t, uint32_t> materialIds;
+    std::unordered_map<uint64_t, uint32_t> textureIds;
+    std::unordered_map<uint64_t, uint32_t> geometryIds;
+
+    static uint32_t CompactId(std::unordered_map<uint64_t, uint32_t>& ids, uint64_t value) {
+        auto it = ids.find(value);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(ids.size()) & 0xFFF;
+        ids.emplace(value, id);
+        return id;
+    }
+
+    static bool OitEnabled() { return WeightedOIT::Get().enabled && WeightedOIT::Supported(); }
+
+    uint32_t Depth(const glm::mat4& modelMatrix) const {
+        const glm::vec3 cameraPos = glm::vec3(FrameUniforms::Get().data.cameraPos);
+        float d = glm::length(glm::vec3(modelMatrix[3]) - cameraPos) / maxSortDistance;
+        return static_cast<uint32_t>(glm::clamp(d, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    void Push(const DrawPacket& p, const InstanceData& o, uint64_t key) {
+        entries.push_back({key, static_cast<uint32_t>(packets.size())});
+        packets.push_back(p);
+        objects.push_back(o);
+        stats.packets[static_cast<int>(key >> 62)]++;
+        sorted = false;
+    }
+
+    static bool SameBatch(const DrawPacket& a, const DrawPacket& b, Mode mode) {
+        if (!a.mesh || !b.mesh || a.mesh->geometry != b.mesh->geometry) return false;
+        if (mode == Mode::PrePassDepth) return true;
+        if (mode == Mode::ShadowDepth) return a.program == b.program;
+        return a.mesh->material == b.mesh->material &&
+               a.envCubemap == b.envCubemap && a.shadowMap == b.shadowMap;
+    }
+
+    void BuildBatches(EntryIterator first, EntryIterator last, Mode mode, unsigned int threshold) {
+        batches.clear();
+        instanceData.clear();
+        AppendBatches(first, last, mode, threshold, 0);
+    }
+
+    void AppendBatches(EntryIterator first, EntryIterator last, Mode mode, unsigned int threshold, uint32_t layer) {
+        for (auto it = first; it != last; ) {
+            auto end = it + 1;
+            while (end != last && SameBatch(packets[it->index], packets[end->index], mode)) ++end;
+
+            Batch b;
+            b.packet = it->index;
+            b.count = static_cast<uint32_t>(end - it);
+            b.baseInstance = static_cast<uint32_t>(instanceData.size());
+            b.layer = layer;
+            if (b.count >= threshold) {
+                for (auto e = it; e != end; ++e)
+                    instanceData.push_back(objects[e->index]);
+                batches.push_back(b);
+            } else {
+                // pod prahem: kazdy paket zvlast (meshlet culling, vlastni uniformy)
+                for (auto e = it; e != end; ++e)
+                    batches.push_back({e->index, 1, 0, false, layer});
+            }
+            it = end;
+        }
+    }
+
+    // Paket, ktery jde kreslit pres indirect (geometrie v arene, existuje indirect program)
+    static bool Indirectable(const DrawPacket& p, Mode mode) {
+        if (!p.mesh || !p.mesh->geometry || !p.mesh->geometry->arena) return false;
+        if (mode != Mode::Colour) return IndirectDraw::Get().DepthProgram() != 0;
+        return p.mesh->geometry->meshlets.empty() && p.mesh->material->IndirectProgram() != 0;
+    }
+
+    static bool SameIndirectRun(const DrawPacket& a, const DrawPacket& b, Mode mode) {
+        if (a.mesh->geometry->arena != b.mesh->geometry->arena) return false;
+        if (mode == Mode::PrePassDepth) return true;
+        if (mode == Mode::ShadowDepth) return a.program == b.program;
+        return a.mesh->material == b.mesh->material &&
+               a.envCubemap == b.envCubemap && a.shadowMap == b.shadowMap;
+    }
+
+    // Rozdeli davky na indirect behy, sestavi prikazy a nahraje je i s daty objektu
+    void BuildIndirectRuns(Mode mode, bool indirect) {
+        runs.clear();
+        commands.clear();
+        firstObjects.clear();
+        if (!indirect) return;
+
+        for (size_t i = 0; i < batches.size(); ) {
+            const DrawPacket& head = packets[batches[i].packet];
+            if (!Indirectable(head, mode)) { ++i; continue; }
+
+            IndirectRun run;
+            run.firstBatch = i;
+            run.firstCommand = static_cast<GLuint>(commands.size());
+            size_t end = i;
+            while (end < batches.size()) {
+                const DrawPacket& p = packets[batches[end].packet];
+                if (!Indirectable(p, mode) || !SameIndirectRun(head, p, mode)) break;
+                Batch& b = batches[end];
+                const GpuGeometry& geo = *p.mesh->geometry;
+                commands.push_back({geo.indexCount, b.count, geo.arenaRange.firstIndex, geo.BaseVertex(), b.baseInstance});
+                firstObjects.push_back(b.baseInstance | (b.layer << IndirectDraw::LAYER_SHIFT));
+                b.indirect = true;
+                ++end;
+            }
+            run.endBatch = end;
+            runs.push_back(run);
+            i = end;
+        }
+
+        if (!commands.empty())
+            IndirectDraw::Get().Upload(commands, firstObjects, instanceData);
+    }
+
+    void SubmitIndirect(const IndirectRun& run, Mode mode, GLStateCache& cache) {
+        const DrawPacket& p = packets[batches[run.firstBatch].packet];
+        GLuint program = 0;
+        if (mode != Mode::Colour) {
+            // vestaveny depth program (stejny vypocet jako depth.vert, model / mvp z SSBO)
+            program = layeredShadow ? IndirectDraw::Get().LayeredDepthProgram() : IndirectDraw::Get().DepthProgram();
+            cache.UseProgram(program);
+            ProgramReflection& r = ProgramReflection::For(program);
+            r.Set(r.Handle<int>("prePass"_u), mode == Mode::PrePassDepth ? 1 : 0);
+            r.Set(r.Handle<int>("shadowCascade"_u), shadowCascade);
+        } else {
+            p.mesh->material->bindIndirect(p.envCubemap, p.shadowMap, cache);
+            program = p.mesh->material->IndirectProgram();
+        }
+
+        const GeometryArena& arena = *p.mesh->geometry->arena;
+        cache.BindVertexArray(arena.VAO());
+        GLsizei count = static_cast<GLsizei>(run.endBatch - run.firstBatch);
+        if (mode == Mode::Colour) ShaderPermutations::Get().BeginDraw(program);
+        IndirectDraw::Get().Draw(program, arena.IndexType(), run.firstCommand, count);
+        ShaderPermutations::Get().EndDraw();
+
+        stats.drawCalls++;
+        stats.indirectDraws++;
+        stats.indirectCommands += static_cast<unsigned int>(count);
+        for (size_t i = run.firstBatch; i < run.endBatch; ++i) {
+            if (batches[i].count < 2) continue;
+            stats.instancedDraws++;
+            stats.instances += batches[i].count;
+        }
+    }
+
+    void Sort() {
+        auto start = std::chrono::high_resolution_clock::now();
+        stats.radixPasses = RadixSort(entries, scratch);
+        auto sortEnd = std::chrono::high_resolution_clock::now();
+        stats.sortMs = std::chrono::duration<double, std::milli>(sortEnd - start).count();
+
+        // pozy vsech skinovanych modelu do BonePalette pred prvnim draw - jeden upload pro vsechny
+        for (const DrawPacket& p : packets)
+            if (p.model) p.model->writeBonePalette();
+
+        // odvozene matice jednou za frame pro vsechny pakety (vertex shader uz nic neinvertuje)
+        ObjectMatrices::Compute(objects.data(), objects.size(), FrameUniforms::Get().data.viewProjection);
+        stats.matrixMs = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - sortEnd).count();
+        sorted = true;
+    }
+};
+
+#endif // RENDERQUEUE_H
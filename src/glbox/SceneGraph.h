@@ -0,0 +1,279 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "Transform.h"
+#include "geometry/ParallelGeometry.h"
+
+// =========================================================================================
+// Hierarchie transformaci (rodic/potomek) v plochych SoA polich serazenych podle hloubky:
+// uroven 0 = koreny, uroven 1 = jejich potomci, ... Rodic je vzdy na nizsim indexu, takze
+// svetove matice se spocitaji jednim pruchodem po urovnich - uzly jedne urovne jsou nezavisle
+// a pocitaji se paralelne na ThreadPool (ParallelGeometry::Pool).
+// Lokalni matice prichazi z Transform (kontrola Version()) nebo ze SetLocal (napr. kost
+// modelu + offset zbrane). Prepocita se jen uzel se zmenenou lokalni matici nebo s rodicem
+// zmenenym v tomto Update - staticke podstromy se jen projdou priznakem.
+// Node je stabilni handle; poradi slotu se meni jen pri zmene struktury (Create/SetParent/Destroy).
+// =========================================================================================
+class SceneGraph {
+
+public:
+    using Node = uint32_t;
+    static constexpr Node INVALID = UINT32_MAX;
+
+    struct Stats {
+        double updateMs = 0.0;
+        size_t nodes = 0;
+        size_t levels = 0;
+        size_t updated = 0;           // prepocitane svetove matice v poslednim Update
+        unsigned int rebuilds = 0;    // preusporadani po zmene struktury
+    };
+
+    // local = zdroj lokalni matice (musi zit dele nez uzel), nullptr = SetLocal / identita
+    Node Create(Node parent = INVALID, const Transform* local = nullptr) {
+        Node node;
+        if (!freeHandles.empty()) {
+            node = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            node = static_cast<Node>(handles.size());
+            handles.emplace_back();
+        }
+        HandleData& h = handles[node];
+        h = HandleData();
+        h.alive = true;
+        h.parent = IsAlive(parent) ? parent : INVALID;
+        h.source = local;
+        orderDirty = true;
+        return node;
+    }
+
+    // Potomci odebraneho uzlu se prevesi na jeho rodice
+    void Destroy(Node node) {
+        if (!IsAlive(node)) return;
+        for (HandleData& h : handles)
+            if (h.alive && h.parent == node) h.parent = handles[node].parent;
+        handles[node].alive = false;
+        freeHandles.push_back(node);
+        orderDirty = true;
+    }
+
+    void Clear() {
+        handles.clear();
+        freeHandles.clear();
+        orderDirty = true;
+    }
+
+    void SetParent(Node node, Node parent) {
+        if (!IsAlive(node)) return;
+        if (parent != INVALID && !IsAlive(parent)) parent = INVALID;
+        for (Node p = parent; p != INVALID; p = handles[p].parent) {
+            if (p == node) {
+                std::cerr << "SceneGraph: SetParent by vytvoril cyklus (uzel " << node << ")" << std::endl;
+                return;
+            }
+        }
+        handles[node].parent = parent;
+        orderDirty = true;
+    }
+
+    void SetSource(Node node, const Transform* local) {
+        if (!IsAlive(node)) return;
+        handles[node].source = local;
+        if (!orderDirty) {
+            uint32_t s = handles[node].slot;
+            // pocet zdroju urovne - uroven bez zdroju Update preskakuje
+            const size_t level = LevelOf(s);
+            if (source[s]) levelSources[level]--;
+            if (local) levelSources[level]++;
+            source[s] = local;
+            sourceVersion[s] = local ? local->Version() - 1 : 0;
+            MarkLocalDirty(s);
+        }
+    }
+
+    // Lokalni matice uzlu bez Transform zdroje
+    void SetLocal(Node node, const glm::mat4& matrix) {
+        if (!IsAlive(node)) return;
+        handles[node].local = matrix;
+        if (!orderDirty) {
+            uint32_t s = handles[node].slot;
+            local[s] = matrix;
+            MarkLocalDirty(s);
+        }
+    }
+
+    bool IsAlive(Node node) const { return node < handles.size() && handles[node].alive; }
+    Node Parent(Node node) const { return IsAlive(node) ? handles[node].parent : INVALID; }
+
+    // Platne po Update
+    const glm::mat4& World(Node node) const { return world[handles[node].slot]; }
+
+    // Frame, ve kterem se svetova matice naposled zmenila (porovnat s Frame())
+    uint32_t ChangedFrame(Node node) const { return changedFrame[handles[node].slot]; }
+    uint32_t Frame() const { return frame; }
+
+    void Update() {
+        auto start = std::chrono::high_resolution_clock::now();
+        if (orderDirty) Rebuild();
+        frame++;
+
+        std::atomic<size_t> updated{0};
+        bool parentLevelChanged = false;
+        for (size_t level = 0; level + 1 < levelStart.size(); ++level) {
+            const uint32_t begin = levelStart[level], end = levelStart[level + 1];
+            // uroven bez zdroju, bez SetLocal a bez zmeneneho rodice se vubec neprochazi
+            if (!parentLevelChanged && levelSources[level] == 0 && levelDirty[level] == 0) continue;
+            levelDirty[level] = 0;
+
+            std::atomic<bool> changed{false};
+            ParallelGeometry::ParallelRows(static_cast<int>(end - begin), [&](int rowBegin, int rowEnd) {
+                size_t count = 0;
+                for (uint32_t i = begin + rowBegin; i < begin + static_cast<uint32_t>(rowEnd); ++i) {
+                    bool dirty = localDirty[i] != 0;
+                    if (const Transform* t = source[i]) {
+                        uint32_t v = t->Version();
+                        if (v != sourceVersion[i]) {
+                            sourceVersion[i] = v;
+                            local[i] = t->GetModelMatrix();
+                            dirty = true;
+                        }
+                    }
+                    const int32_t p = parent[i];
+                    if (p >= 0 && changedFrame[p] == frame) dirty = true;
+                    if (!dirty) continue;
+
+                    localDirty[i] = 0;
+                    world[i] = p >= 0 ? world[p] * local[i] : local[i];
+                    changedFrame[i] = frame;
+                    count++;
+                }
+                if (count) {
+                    updated += count;
+                    changed = true;
+                }
+            }, MIN_NODES_PER_TASK);
+            parentLevelChanged = changed;
+        }
+
+        stats.nodes = world.size();
+        stats.levels = levelStart.empty() ? 0 : levelStart.size() - 1;
+        stats.updated = updated;
+        stats.updateMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    static constexpr int MIN_NODES_PER_TASK = 2048;
+
+    struct HandleData {
+        Node parent = INVALID;
+        const Transform* source = nullptr;
+        glm::mat4 local = glm::mat4(1.0f);
+        uint32_t slot = 0;
+        bool alive = false;
+    };
+
+    // handle -> data pro prestavbu poradi
+    std::vector<HandleData> handles;
+    std::vector<Node> freeHandles;
+    bool orderDirty = false;
+
+    // SoA podle slotu (serazeno podle hloubky)
+    std::vector<int32_t> parent;                 // slot rodice, -1 = koren
+    std::vector<const Transform*> source;
+    std::vector<uint32_t> sourceVersion;
+    std::vector<uint8_t> localDirty;
+    std::vector<uint32_t> changedFrame;
+    std::vector<glm::mat4> local;
+    std::vector<glm::mat4> world;
+    std::vector<Node> slotHandle;
+
+    std::vector<uint32_t> levelStart;            // slot prvniho uzlu urovne, posledni = pocet uzlu
+    std::vector<uint32_t> levelSources;          // uzly s Transform zdrojem v urovni
+    std::vector<uint32_t> levelDirty;            // SetLocal od posledniho Update
+
+    uint32_t frame = 0;
+    Stats stats;
+
+    void MarkLocalDirty(uint32_t slot) {
+        localDirty[slot] = 1;
+        levelDirty[LevelOf(slot)]++;
+    }
+
+    size_t LevelOf(uint32_t slot) const {
+        return static_cast<size_t>(std::upper_bound(levelStart.begin(), levelStart.end(), slot) - levelStart.begin()) - 1;
+    }
+
+    // Hloubky -> counting sort podle urovne -> SoA pole; vsechny uzly se prepocitaji
+    void Rebuild() {
+        orderDirty = false;
+        stats.rebuilds++;
+
+        const size_t handleCount = handles.size();
+        std::vector<uint32_t> depth(handleCount, UINT32_MAX);
+        uint32_t maxDepth = 0;
+        size_t alive = 0;
+        for (Node n = 0; n < handleCount; ++n) {
+            if (!handles[n].alive) continue;
+            alive++;
+            // hloubka prochazenim k prvnimu uzlu se znamou hloubkou
+            uint32_t d = 0;
+            Node p = handles[n].parent;
+            while (p != INVALID && depth[p] == UINT32_MAX) {
+                d++;
+                p = handles[p].parent;
+            }
+            uint32_t base = p == INVALID ? 0 : depth[p] + 1;
+            depth[n] = base + d;
+            maxDepth = std::max(maxDepth, depth[n]);
+            // doplnit hloubky mezilehlych predku
+            uint32_t dd = depth[n];
+            for (Node q = handles[n].parent; q != INVALID && depth[q] == UINT32_MAX; q = handles[q].parent)
+                depth[q] = --dd;
+        }
+
+        levelStart.assign(alive ? maxDepth + 2 : 1, 0);
+        for (Node n = 0; n < handleCount; ++n)
+            if (handles[n].alive) levelStart[depth[n] + 1]++;
+        for (size_t l = 1; l < levelStart.size(); ++l) levelStart[l] += levelStart[l - 1];
+
+        std::vector<uint32_t> cursor(levelStart.begin(), levelStart.end() - 1);
+        slotHandle.assign(alive, INVALID);
+        for (Node n = 0; n < handleCount; ++n) {
+            if (!handles[n].alive) continue;
+            uint32_t s = cursor[depth[n]]++;
+            handles[n].slot = s;
+            slotHandle[s] = n;
+        }
+
+        parent.resize(alive);
+        source.resize(alive);
+        sourceVersion.resize(alive);
+        localDirty.assign(alive, 1);
+        changedFrame.assign(alive, 0);
+        local.resize(alive);
+        world.resize(alive);
+        levelSources.assign(levelStart.size() - 1, 0);
+        levelDirty.assign(levelStart.size() - 1, 0);
+        for (uint32_t s = 0; s < alive; ++s) {
+            const HandleData& h = handles[slotHandle[s]];
+            parent[s] = h.parent == INVALID ? -1 : static_cast<int32_t>(handles[h.parent].slot);
+            source[s] = h.source;
+            sourceVersion[s] = h.source ? h.source->Version() - 1 : 0;
+            local[s] = h.local;
+            if (h.source) levelSources[depth[slotHandle[s]]]++;
+            levelDirty[depth[slotHandle[s]]]++;
+        }
+    }
+};
+
+#endif // SCENEGRAPH_H
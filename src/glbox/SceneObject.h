@@ -2,6 +2,7 @@
 #define SCENEOBJECT_H
 
 #include "Transform.h"
+#include "SceneGraph.h"
 #include "StaticMesh.h"
 #include "Model.h"
 
@@ -16,6 +17,16 @@ public:
     StaticMesh* statiMesh = nullptr;
     ModelFBX* model = nullptr;
 
+    // per-objekt zmena materialu (i v instancovane davce): rgb = nasobic albeda, a = roughness (< 0 = z materialu)
+    glm::vec4 materialOverride = glm::vec4(1.0f, 1.0f, 1.0f, -1.0f);
+
+    // nehybny shadow caster - ShadowCache ho drzi v ulozene shadow mape (pohyb pozna podle matice)
+    bool staticShadow = false;
+
+    // uzel hierarchie - pokud je nastaven, kresli se se svetovou matici uzlu (transform = lokalni)
+    const SceneGraph* graph = nullptr;
+    SceneGraph::Node node = SceneGraph::INVALID;
+
     SceneObject() = default;
 
     SceneObject(StaticMesh* statiMesh) : statiMesh(statiMesh) {}
@@ -36,31 +47,37 @@ public:
         model = newModel;
     }
 
-    void Draw( const glm::mat4& view, const glm::mat4& proj,
-              const glm::vec3& cameraPos, unsigned int envCubemap, unsigned int shadowMap,
-              const glm::mat4& lightSpaceMatrix, const glm::vec3& lightDir, const glm::vec3& lightCol) const {
-          const glm::mat4 modelMatrix = transform.GetModelMatrix();
+    void attach(SceneGraph& sceneGraph, SceneGraph::Node parent = SceneGraph::INVALID) {
+        graph = &sceneGraph;
+        node = sceneGraph.Create(parent, &transform);
+    }
+
+    const glm::mat4& worldMatrix() const {
+        return graph ? graph->World(node) : transform.GetModelMatrix();
+    }
+
+    // kamera a svetlo jsou v FrameUniforms - objekt posila jen svoje data
+    void Draw(unsigned int envCubemap, unsigned int shadowMap) const {
+        const glm::mat4& modelMatrix = worldMatrix();
 
         if (statiMesh) {
-            statiMesh->Draw(modelMatrix, view, proj,
-                             cameraPos,envCubemap,shadowMap,
-                             lightSpaceMatrix, lightDir, lightCol);
+            statiMesh->Draw(modelMatrix, envCubemap, shadowMap, materialOverride);
         } else if (model) {
-            model->draw( view, proj,  cameraPos);
+            model->draw();
         }
     }
 
-    void DrawForShadow(unsigned int depthShaderID, const glm::mat4& lightSpaceMatrix) const {
-        const glm::mat4 modelMatrix = transform.GetModelMatrix();
+    void DrawForShadow(unsigned int depthShaderID) const {
+        const glm::mat4& modelMatrix = worldMatrix();
 
         glUseProgram(depthShaderID);
-        glUniformMatrix4fv(glGetUniformLocation(depthShaderID, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-        glUniformMatrix4fv(glGetUniformLocation(depthShaderID, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        ProgramReflection& r = ProgramReflection::For(depthShaderID);
+        r.Set(r.Handle<glm::mat4>("model"_u), modelMatrix);
 
         if (statiMesh) {
-            statiMesh->DrawForShadow(depthShaderID, modelMatrix, lightSpaceMatrix);
+            statiMesh->DrawForShadow(depthShaderID, modelMatrix);
         } else if (model) {
-            model->DrawForShadow(depthShaderID, lightSpaceMatrix);
+            model->DrawForShadow(depthShaderID);
         }
 
         glUseProgram(0);
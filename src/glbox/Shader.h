@@ -9,6 +9,12 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include "ShaderReflection.h"
+#include "ProgramBinaryCache.h"
+#include "FrameUniforms.h"
+#include "BonePalette.h"
+#include "ShadowFilter.h"
 
 class Shader
 {
@@ -43,13 +49,20 @@ public:
             fShaderStream << fShaderFile.rdbuf();
             vShaderFile.close();
             fShaderFile.close();
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
+            vertexCode = ExpandIncludes(vShaderStream.str(), vertexPath);
+            fragmentCode = ExpandIncludes(fShaderStream.str(), fragmentPath);
         } catch (std::ifstream::failure &e) {
             std::cout << "CHYBA::SHADER::SOUBOR_NEBYL_USPESNE_PRECTEN" << std::endl;
         }
         const char *vShaderCode = vertexCode.c_str();
         const char *fShaderCode = fragmentCode.c_str();
+        // warm start - slinkovany program z disku, kompilace se preskoci
+        ID = ProgramBinaryCache::Get().Load(vShaderCode, fShaderCode);
+        if (ID) {
+            ProgramReflection::For(ID);
+            return;
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
         unsigned int vertex, fragment;
         int success;
         char infoLog[512];
@@ -74,6 +87,7 @@ public:
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        ProgramBinaryCache::Get().PrepareLink(ID);
         glLinkProgram(ID);
         glGetProgramiv(ID, GL_LINK_STATUS, &success);
         if(!success) {
@@ -82,6 +96,10 @@ public:
         }
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+        ProgramBinaryCache::Get().Store(vShaderCode, fShaderCode, ID,
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count());
+        // reflexe hned po linkovani - pripoji sdilene uniform bloky (FrameData)
+        ProgramReflection::For(ID);
     }
     ~Shader(){
 
@@ -93,6 +111,13 @@ public:
         const char* vShaderCode = vertexSource;
         const char* fShaderCode = fragmentSource;
 
+        ID = ProgramBinaryCache::Get().Load(vShaderCode, fShaderCode);
+        if (ID) {
+            ProgramReflection::For(ID);
+            return;
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+
         vertex = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertex, 1, &vShaderCode, NULL);
         glCompileShader(vertex);
@@ -118,6 +143,7 @@ public:
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        ProgramBinaryCache::Get().PrepareLink(ID);
         glLinkProgram(ID);
         glGetProgramiv(ID, GL_LINK_STATUS, &success);
         if(!success) {
@@ -126,18 +152,70 @@ public:
         }
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+        ProgramBinaryCache::Get().Store(vShaderCode, fShaderCode, ID,
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count());
+        // reflexe hned po linkovani - pripoji sdilene uniform bloky (FrameData)
+        ProgramReflection::For(ID);
     }
     void use() {
         glUseProgram(ID);
     }
+    // settery jdou pres reflexi programu (hash jmena + stinova kopie, bez glGetUniformLocation)
+    void setMat3(const std::string &name, const glm::mat3 &mat) const {
+        reflection().Set(name, mat);
+    }
     void setMat4(const std::string &name, const glm::mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        reflection().Set(name, mat);
     }
     void setVec3(const std::string &name, const glm::vec3 &value) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        reflection().Set(name, value);
     }
     void setInt(const std::string &name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        reflection().Set(name, value);
+    }
+    void setFloat(const std::string &name, float value) const {
+        reflection().Set(name, value);
+    }
+
+    // typovany handle pro opakovane uploady: shader.handle<glm::mat4>("model"_u)
+    template<typename T>
+    UniformHandle<T> handle(uint32_t nameHash) const { return reflection().Handle<T>(nameHash); }
+
+    template<typename T>
+    void set(const UniformHandle<T>& h, const T& value) const { reflection().Set(h, value); }
+
+    ProgramReflection& reflection() const { return ProgramReflection::For(ID); }
+
+    // Shadery ze souboru: radek "#pragma include <Jmeno>" se pri nacteni nahradi stejnym
+    // GLSL blokem, jaky vkladaji vestavene shadery (FRAME_DATA_GLSL ...) - jedna definice
+    static std::string ExpandIncludes(const std::string& code, const char* path = "") {
+        static const std::pair<const char*, const char*> snippets[] = {
+            { "FrameData", FRAME_DATA_GLSL },
+            { "ShadowCaster", SHADOW_CASTER_GLSL },
+            { "BonePalette", BONE_PALETTE_GLSL },
+            { "ShadowKernels", SHADOW_KERNELS_GLSL },
+        };
+        static const std::string directive = "#pragma include ";
+
+        std::string out;
+        out.reserve(code.size() + 2048);
+        std::istringstream lines(code);
+        std::string line;
+        while (std::getline(lines, line)) {
+            size_t start = line.find_first_not_of(" \t");
+            if (start != std::string::npos && line.compare(start, directive.size(), directive) == 0) {
+                std::string name = line.substr(start + directive.size());
+                name.erase(name.find_last_not_of(" \t\r") + 1);
+                const char* snippet = nullptr;
+                for (const auto& s : snippets)
+                    if (name == s.first) snippet = s.second;
+                if (snippet) { out += snippet; continue; }
+                std::cerr << "err: Shader: unknown include '" << name << "' in " << path << std::endl;
+            }
+            out += line;
+            out += '\n';
+        }
+        return out;
     }
 
 private:
@@ -0,0 +1,304 @@
+#ifndef SHADERPERMUTATIONS_H
+#define SHADERPERMUTATIONS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <cctype>
+#include <algorithm>
+
+#include "ProgramCache.h"
+
+// =========================================================================================
+// Permutovatelny shader: jeden zdroj, varianty z #define bitu. Bit i -> "<feature[i]> true/false",
+// takze shader pouziva feature jako const bool a mrtve vetve vyhodi kompilator.
+// Uber varianta (uberDefine) cte feature z uniformu a slouzi jako fallback, dokud driver
+// specializovanou variantu nedokompiluje (ProgramCache::AcquireAsync). Na uber se ceka
+// jen pri prvnim kresleni - Prepare() ji zada uz pri vytvoreni materialu.
+// Set drzi varianty jen pres weak_ptr: ProgramHandle drzi materialy, ktere variantu pouzivaji
+// (i behem kompilace), a program se smaze s poslednim z nich.
+// =========================================================================================
+class PermutationSet {
+
+public:
+    PermutationSet(std::string name, std::string vertexSource, std::string fragmentSource,
+                   std::vector<std::string> features, std::string uberDefine,
+                   std::vector<std::string> baseDefines = {})
+        : name(std::move(name)), vs(std::move(vertexSource)), fs(std::move(fragmentSource)),
+          features(std::move(features)), uberDefine(std::move(uberDefine)), baseDefines(std::move(baseDefines)) {}
+
+    const std::string& Name() const { return name; }
+
+    std::vector<std::string> Defines(uint32_t bits) const {
+        std::vector<std::string> defines = baseDefines;
+        for (size_t i = 0; i < features.size(); ++i)
+            defines.push_back(features[i] + ((bits >> i) & 1u ? " true" : " false"));
+        return defines;
+    }
+
+    // napr. "pbr[albedo+normal]"; feature bez prefixu HAS_, mala pismena
+    std::string Label(uint32_t bits) const {
+        std::string label = name + "[";
+        bool first = true;
+        for (size_t i = 0; i < features.size(); ++i) {
+            if (!((bits >> i) & 1u)) continue;
+            std::string f = features[i].rfind("HAS_", 0) == 0 ? features[i].substr(4) : features[i];
+            for (char& c : f) c = (c == '_') ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            label += (first ? "" : "+") + f;
+            first = false;
+        }
+        return label + "]";
+    }
+
+    // Zada kompilaci uber varianty (bez cekani); handle si drzi volajici
+    ProgramHandle Prepare();
+
+    // Uber varianta pripravena ke kresleni (pripadne pocka na driver)
+    ProgramHandle Uber();
+
+    // Hotova varianta, jinak nullptr (pri prvnim dotazu se zada asynchronni kompilace).
+    // 'hold' drzi volajici - udrzi variantu nazivu i behem kompilace
+    ProgramHandle Find(uint32_t bits, ProgramHandle& hold);
+
+    // Varianta hned, s cekanim na driver (predkompilace znamych kombinaci)
+    ProgramHandle Compile(uint32_t bits);
+
+    // Varianty, ktere uz nikdo nedrzi (program je smazany) - id pro uklid statistik
+    void Prune(std::vector<GLuint>& released) {
+        released.insert(released.end(), replaced.begin(), replaced.end());
+        replaced.clear();
+        for (auto it = variants.begin(); it != variants.end();) {
+            if (it->second.program.expired()) {
+                if (it->second.id) released.push_back(it->second.id);
+                it = variants.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (uber.id && uber.program.expired()) {
+            released.push_back(uber.id);
+            uber = Variant();
+        }
+    }
+
+    void Release() {
+        uber = Variant();
+        variants.clear();
+        replaced.clear();
+    }
+
+private:
+    std::string name, vs, fs;
+    std::vector<std::string> features;
+    std::string uberDefine;
+    std::vector<std::string> baseDefines;
+
+    struct Variant {
+        std::weak_ptr<GpuProgram> program;
+        GLuint id = 0;
+        std::chrono::high_resolution_clock::time_point submitted;
+        bool reported = false;        // OnCompiled uz probehl
+    };
+
+    void Submit(Variant& v, const ProgramHandle& program) {
+        if (v.id && v.id != program->id) replaced.push_back(v.id);
+        v.program = program;
+        v.id = program->id;
+        v.submitted = std::chrono::high_resolution_clock::now();
+        v.reported = false;
+    }
+
+    Variant uber;
+    std::unordered_map<uint32_t, Variant> variants;
+    std::vector<GLuint> replaced;     // id smazanych variant, ktere nahradila nova kompilace
+};
+
+// =========================================================================================
+// Registr permutaci: dokoncovani asynchronnich kompilaci (Pump jednou za frame)
+// a mereni ceny variant - GL_TIME_ELAPSED + GL_SAMPLES_PASSED kolem kazdeho draw callu,
+// vysledky se ctou az po RING_SIZE framech (bez cekani na GPU).
+// =========================================================================================
+class ShaderPermutations {
+
+public:
+    static constexpr int RING_SIZE = 3;
+
+    struct VariantInfo {
+        std::string label;
+        double compileMs = 0.0;       // uber synchronne, varianty od zadani do Ready()
+        // GPU (klouzavy prumer za frame), jen pri profiling
+        double gpuMs = 0.0;
+        double samples = 0.0;
+        unsigned int draws = 0;
+        double NsPerSample() const { return samples > 0.0 ? gpuMs * 1e6 / samples : 0.0; }
+    };
+
+    bool profiling = false;
+
+    static ShaderPermutations& Get() {
+        static ShaderPermutations instance;
+        return instance;
+    }
+
+    ShaderPermutations(const ShaderPermutations&) = delete;
+    ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+    void Register(PermutationSet* set) {
+        if (std::find(sets.begin(), sets.end(), set) == sets.end()) sets.push_back(set);
+    }
+
+    // Dokonci hotove kompilace (volat mimo kresleni, napr. po SwapBuffers); budget plati
+    // jen bez KHR_parallel_shader_compile, kde dokonceni blokuje
+    void Pump(int budget = 1) {
+        ProgramCache::Get().Poll(budget);
+        std::vector<GLuint> released;
+        for (PermutationSet* s : sets) s->Prune(released);
+        for (GLuint id : released) variants.erase(id);
+    }
+
+    size_t PendingCount() const { return ProgramCache::Get().PendingCount(); }
+
+    void OnCompiled(GLuint program, const std::string& label, double ms) {
+        VariantInfo& info = variants[program];
+        info.label = label;
+        info.compileMs = ms;
+    }
+
+    const std::unordered_map<GLuint, VariantInfo>& Variants() const { return variants; }
+
+    // ---- GPU mereni (jen s profiling) ----
+    void BeginDraw(GLuint program) {
+        if (!profiling || active) return;
+        Frame& f = frames[current];
+        if (f.used == f.queries.size()) {
+            Query q;
+            glGenQueries(1, &q.time);
+            glGenQueries(1, &q.samples);
+            f.queries.push_back(q);
+        }
+        Query& q = f.queries[f.used++];
+        q.program = program;
+        glBeginQuery(GL_TIME_ELAPSED, q.time);
+        glBeginQuery(GL_SAMPLES_PASSED, q.samples);
+        active = true;
+    }
+
+    void EndDraw() {
+        if (!active) return;
+        glEndQuery(GL_SAMPLES_PASSED);
+        glEndQuery(GL_TIME_ELAPSED);
+        active = false;
+    }
+
+    // Na konci framu: precte dotazy z nejstarsiho slotu a pripravi ho pro dalsi frame
+    void EndFrame() {
+        current = (current + 1) % RING_SIZE;
+        Frame& f = frames[current];
+        if (f.used == 0) return;
+
+        std::unordered_map<GLuint, VariantInfo> frame;
+        for (size_t i = 0; i < f.used; ++i) {
+            const Query& q = f.queries[i];
+            GLuint64 ns = 0, samples = 0;
+            glGetQueryObjectui64v(q.time, GL_QUERY_RESULT, &ns);
+            glGetQueryObjectui64v(q.samples, GL_QUERY_RESULT, &samples);
+            VariantInfo& v = frame[q.program];
+            v.gpuMs += ns * 1e-6;
+            v.samples += static_cast<double>(samples);
+            v.draws++;
+        }
+        for (auto& [program, v] : variants) {
+            auto it = frame.find(program);
+            double ms = it != frame.end() ? it->second.gpuMs : 0.0;
+            double samples = it != frame.end() ? it->second.samples : 0.0;
+            v.gpuMs += (ms - v.gpuMs) * SMOOTHING;
+            v.samples += (samples - v.samples) * SMOOTHING;
+            v.draws = it != frame.end() ? it->second.draws : 0;
+        }
+        f.used = 0;
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        for (PermutationSet* s : sets) s->Release();
+        for (Frame& f : frames) {
+            for (Query& q : f.queries) {
+                glDeleteQueries(1, &q.time);
+                glDeleteQueries(1, &q.samples);
+            }
+            f.queries.clear();
+            f.used = 0;
+        }
+        variants.clear();
+    }
+
+private:
+    static constexpr double SMOOTHING = 0.1;
+
+    struct Query { GLuint time = 0, samples = 0, program = 0; };
+    struct Frame { std::vector<Query> queries; size_t used = 0; };
+
+    std::vector<PermutationSet*> sets;
+    std::unordered_map<GLuint, VariantInfo> variants;
+    Frame frames[RING_SIZE];
+    int current = 0;
+    bool active = false;
+
+    ShaderPermutations() = default;
+};
+
+// ---- PermutationSet (potrebuje ShaderPermutations) ----
+
+inline ProgramHandle PermutationSet::Prepare() {
+    if (ProgramHandle existing = uber.program.lock()) return existing;
+    std::vector<std::string> defines = baseDefines;
+    defines.push_back(uberDefine);
+    ProgramHandle program = ProgramCache::Get().AcquireAsync(vs, fs, defines);
+    Submit(uber, program);
+    ShaderPermutations::Get().Register(this);
+    return program;
+}
+
+inline ProgramHandle PermutationSet::Uber() {
+    ProgramHandle program = Prepare();
+    if (!uber.reported) {
+        ProgramCache::Get().Wait(program);
+        uber.reported = true;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - uber.submitted).count();
+        ShaderPermutations::Get().OnCompiled(program->id, name + "[uber]", ms);
+    }
+    return program;
+}
+
+inline ProgramHandle PermutationSet::Find(uint32_t bits, ProgramHandle& hold) {
+    Variant& v = variants[bits];
+    if (!hold) {
+        hold = v.program.lock();
+        if (!hold) {
+            hold = ProgramCache::Get().AcquireAsync(vs, fs, Defines(bits));
+            Submit(v, hold);
+            ShaderPermutations::Get().Register(this);
+        }
+    }
+    if (!hold->Ready()) return nullptr;
+    if (!v.reported) {
+        v.reported = true;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - v.submitted).count();
+        ShaderPermutations::Get().OnCompiled(hold->id, Label(bits), ms);
+    }
+    return hold;
+}
+
+inline ProgramHandle PermutationSet::Compile(uint32_t bits) {
+    ProgramHandle hold;
+    if (!Find(bits, hold)) {
+        ProgramCache::Get().Wait(hold);
+        Find(bits, hold);
+    }
+    return hold;
+}
+
+#endif // SHADERPERMUTATIONS_H
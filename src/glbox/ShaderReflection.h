@@ -0,0 +1,323 @@
+#ifndef SHADERREFLECTION_H
+#define SHADERREFLECTION_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <iostream>
+
+// =========================================================================================
+// Hash jmena uniformu (FNV-1a 32), constexpr - "model"_u se spocita pri kompilaci
+// =========================================================================================
+constexpr uint32_t UniformHash(const char* s, uint32_t h = 2166136261u) {
+    return *s ? UniformHash(s + 1, (h ^ static_cast<uint8_t>(*s)) * 16777619u) : h;
+}
+
+constexpr uint32_t operator""_u(const char* s, size_t) { return UniformHash(s); }
+
+// GL typ pro C++ typ hodnoty (kontrola pri vydani handle)
+template<typename T> struct UniformGLType;
+template<> struct UniformGLType<int>       { static constexpr GLenum value = GL_INT; };
+template<> struct UniformGLType<float>     { static constexpr GLenum value = GL_FLOAT; };
+template<> struct UniformGLType<glm::vec2> { static constexpr GLenum value = GL_FLOAT_VEC2; };
+template<> struct UniformGLType<glm::vec3> { static constexpr GLenum value = GL_FLOAT_VEC3; };
+template<> struct UniformGLType<glm::vec4> { static constexpr GLenum value = GL_FLOAT_VEC4; };
+template<> struct UniformGLType<glm::mat3> { static constexpr GLenum value = GL_FLOAT_MAT3; };
+template<> struct UniformGLType<glm::mat4> { static constexpr GLenum value = GL_FLOAT_MAT4; };
+
+// Typovany handle - location + slot ve stinove kopii; neplatny handle (-1) se tise ignoruje
+template<typename T>
+struct UniformHandle {
+    GLint location = -1;
+    int slot = -1;
+    bool Valid() const { return location >= 0; }
+};
+
+struct UniformInfo {
+    std::string name;        // bez "[0]" u poli
+    uint32_t hash = 0;
+    GLint location = -1;
+    GLenum type = 0;
+    GLint arraySize = 1;
+    bool isSampler = false;
+    size_t shadowOffset = 0;  // offset hodnoty ve stinove kopii programu
+    size_t elementBytes = 0;
+};
+
+struct UniformBlockInfo {
+    std::string name;
+    GLuint index = 0;
+    GLint dataSize = 0;
+    GLint binding = 0;
+};
+
+// Pevne binding pointy sdilenych uniform bloku - programy se k nim pripoji pri reflexi
+namespace BlockBinding {
+constexpr GLuint Frame = 0;     // FrameData (FrameUniforms.h)
+}
+
+// Citace uploadu za frame (vsechny programy)
+struct UniformStats {
+    unsigned int uploads = 0;
+    unsigned int skipped = 0;
+    unsigned int lookups = 0;     // runtime lookup podle jmena (std::string API)
+    void Reset() { uploads = skipped = lookups = 0; }
+};
+
+// =========================================================================================
+// Reflexe linknuteho programu: aktivni uniformy, bloky, samplery
+// Hodnoty jdou pres glProgramUniform* (bez zavislosti na glUseProgram; na 3.3 kontextech
+// glUniform* s docasnym navazanim programu) a stinova kopie preskoci upload, pokud se hodnota nezmenila.
+// =========================================================================================
+class ProgramReflection {
+
+public:
+    inline static UniformStats stats;
+
+    GLuint program = 0;
+    std::vector<UniformInfo> uniforms;
+    std::vector<UniformBlockInfo> blocks;
+    std::vector<int> samplers;        // indexy do uniforms
+
+    // Reflexe pro program; vytvori se pri prvnim pouziti (po linkovani)
+    static ProgramReflection& For(GLuint program) {
+        auto& all = Registry();
+        auto it = all.find(program);
+        if (it == all.end()) {
+            it = all.emplace(program, ProgramReflection()).first;
+            it->second.Reflect(program);
+        }
+        return it->second;
+    }
+
+    // Volat pred glDeleteProgram - GL muze ID znovu pouzit
+    static void Forget(GLuint program) { Registry().erase(program); }
+
+    void Reflect(GLuint prog) {
+        program = prog;
+        uniforms.clear(); blocks.clear(); samplers.clear(); byHash.clear();
+
+        GLint count = 0, maxLen = 0;
+        glGetProgramiv(prog, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(prog, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+        std::vector<char> nameBuf(std::max(maxLen, 1) + 1);
+
+        size_t shadowBytes = 0;
+        for (GLint i = 0; i < count; ++i) {
+            UniformInfo u;
+            GLsizei len = 0;
+            glGetActiveUniform(prog, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuf.size()), &len,
+                               &u.arraySize, &u.type, nameBuf.data());
+            u.name.assign(nameBuf.data(), len);
+            if (u.name.size() > 3 && u.name.compare(u.name.size() - 3, 3, "[0]") == 0)
+                u.name.resize(u.name.size() - 3);
+
+            u.location = glGetUniformLocation(prog, nameBuf.data());
+            if (u.location < 0) {
+                // clen uniform bloku
+                GLint blockIndex = -1;
+                GLuint index = static_cast<GLuint>(i);
+                glGetActiveUniformsiv(prog, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+                if (blockIndex >= 0) continue;
+            }
+
+            u.hash = UniformHash(u.name.c_str());
+            u.isSampler = IsSamplerType(u.type);
+            u.elementBytes = TypeBytes(u.type);
+            u.shadowOffset = shadowBytes;
+            shadowBytes += u.elementBytes * u.arraySize;
+
+            byHash[u.hash] = static_cast<int>(uniforms.size());
+            if (u.isSampler) samplers.push_back(static_cast<int>(uniforms.size()));
+            uniforms.push_back(u);
+        }
+
+        shadow.assign(shadowBytes, 0);
+        shadowValid.assign(shadowBytes, false);
+
+        GLint blockCount = 0;
+        glGetProgramiv(prog, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+        for (GLint b = 0; b < blockCount; ++b) {
+            UniformBlockInfo info;
+            info.index = static_cast<GLuint>(b);
+            GLint nameLen = 0;
+            glGetActiveUniformBlockiv(prog, info.index, GL_UNIFORM_BLOCK_NAME_LENGTH, &nameLen);
+            std::vector<char> blockName(std::max(nameLen, 1));
+            glGetActiveUniformBlockName(prog, info.index, static_cast<GLsizei>(blockName.size()), nullptr, blockName.data());
+            info.name = blockName.data();
+            glGetActiveUniformBlockiv(prog, info.index, GL_UNIFORM_BLOCK_DATA_SIZE, &info.dataSize);
+            glGetActiveUniformBlockiv(prog, info.index, GL_UNIFORM_BLOCK_BINDING, &info.binding);
+
+            GLint shared = SharedBlockBinding(info.name);
+            if (shared >= 0 && shared != info.binding) {
+                glUniformBlockBinding(prog, info.index, static_cast<GLuint>(shared));
+                info.binding = shared;
+            }
+            blocks.push_back(info);
+        }
+    }
+
+    const UniformInfo* Find(uint32_t hash) const {
+        auto it = byHash.find(hash);
+        return it != byHash.end() ? &uniforms[it->second] : nullptr;
+    }
+
+    const UniformBlockInfo* FindBlock(const std::string& name) const {
+        for (const auto& b : blocks) if (b.name == name) return &b;
+        return nullptr;
+    }
+
+    // Typovany handle; neexistujici (vyoptimalizovany) uniform vrati neplatny handle
+    template<typename T>
+    UniformHandle<T> Handle(uint32_t hash) const {
+        UniformHandle<T> h;
+        auto it = byHash.find(hash);
+        if (it == byHash.end()) return h;
+        const UniformInfo& u = uniforms[it->second];
+        if (!TypeMatches<T>(u.type)) {
+            std::cerr << "warn: uniform '" << u.name << "' type mismatch" << std::endl;
+            return h;
+        }
+        h.location = u.location;
+        h.slot = it->second;
+        return h;
+    }
+
+    template<typename T>
+    UniformHandle<T> Handle(const char* name) const { return Handle<T>(UniformHash(name)); }
+
+    // Nastavi hodnotu (nebo prvnich count prvku pole); preskoci, pokud je stejna jako posledne
+    template<typename T>
+    void Set(const UniformHandle<T>& h, const T& value) { SetArray(h, &value, 1); }
+
+    template<typename T>
+    void SetArray(const UniformHandle<T>& h, const T* values, size_t count) {
+        if (!h.Valid() || count == 0) return;
+        const UniformInfo& u = uniforms[h.slot];
+        count = std::min(count, static_cast<size_t>(u.arraySize));
+        size_t bytes = count * sizeof(T);
+        unsigned char* dst = shadow.data() + u.shadowOffset;
+
+        if (shadowValid[u.shadowOffset] && shadowValid[u.shadowOffset + bytes - 1] &&
+            std::memcmp(dst, values, bytes) == 0) {
+            stats.skipped++;
+            return;
+        }
+        std::memcpy(dst, values, bytes);
+        std::fill(shadowValid.begin() + u.shadowOffset, shadowValid.begin() + u.shadowOffset + bytes, true);
+        Upload(h.location, values, static_cast<GLsizei>(count));
+        stats.uploads++;
+    }
+
+    // Runtime varianta podle jmena (Shader::setMat4 apod.) - hash + lookup misto glGetUniformLocation
+    template<typename T>
+    void Set(const std::string& name, const T& value) {
+        stats.lookups++;
+        Set(Handle<T>(UniformHash(name.c_str())), value);
+    }
+
+    // Po externim glUniform* na tento program
+    void Invalidate() { std::fill(shadowValid.begin(), shadowValid.end(), false); }
+
+private:
+    std::unordered_map<uint32_t, int> byHash;
+    std::vector<unsigned char> shadow;
+    std::vector<bool> shadowValid;
+
+    static std::unordered_map<GLuint, ProgramReflection>& Registry() {
+        static std::unordered_map<GLuint, ProgramReflection> registry;
+        return registry;
+    }
+
+    // #version 330 nema layout(binding=), sdilene bloky se navazou podle jmena
+    static GLint SharedBlockBinding(const std::string& name) {
+        if (name == "FrameData") return static_cast<GLint>(BlockBinding::Frame);
+        return -1;
+    }
+
+    template<typename T>
+    static bool TypeMatches(GLenum type) {
+        if (type == UniformGLType<T>::value) return true;
+        // int handle i pro bool a samplery
+        return std::is_same<T, int>::value && (type == GL_BOOL || IsSamplerType(type));
+    }
+
+    static bool IsSamplerType(GLenum type) {
+        switch (type) {
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_CUBE_SHADOW: case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_2D:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static size_t TypeBytes(GLenum type) {
+        switch (type) {
+        case GL_FLOAT_VEC2: return sizeof(glm::vec2);
+        case GL_FLOAT_VEC3: return sizeof(glm::vec3);
+        case GL_FLOAT_VEC4: return sizeof(glm::vec4);
+        case GL_FLOAT_MAT3: return sizeof(glm::mat3);
+        case GL_FLOAT_MAT4: return sizeof(glm::mat4);
+        default:            return 4; // float, int, bool, samplery
+        }
+    }
+
+    // glProgramUniform* je az od GL 4.1 / ARB_separate_shader_objects (3.3 kontexty ho nemaji);
+    // bez nej glUniform* na docasne navazanem programu - puvodni program se obnovi,
+    // takze GLStateCache zustava platny
+    static bool HasProgramUniform() {
+        static const bool supported = GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_separate_shader_objects;
+        return supported;
+    }
+
+    template<class Direct, class Bound>
+    void UploadWith(Direct&& direct, Bound&& bound) {
+        if (HasProgramUniform()) { direct(); return; }
+        GLint previous = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+        if (static_cast<GLuint>(previous) != program) glUseProgram(program);
+        bound();
+        if (static_cast<GLuint>(previous) != program) glUseProgram(static_cast<GLuint>(previous));
+    }
+
+    void Upload(GLint loc, const int* v, GLsizei n) {
+        UploadWith([&] { glProgramUniform1iv(program, loc, n, v); }, [&] { glUniform1iv(loc, n, v); });
+    }
+    void Upload(GLint loc, const float* v, GLsizei n) {
+        UploadWith([&] { glProgramUniform1fv(program, loc, n, v); }, [&] { glUniform1fv(loc, n, v); });
+    }
+    void Upload(GLint loc, const glm::vec2* v, GLsizei n) {
+        const float* p = glm::value_ptr(v[0]);
+        UploadWith([&] { glProgramUniform2fv(program, loc, n, p); }, [&] { glUniform2fv(loc, n, p); });
+    }
+    void Upload(GLint loc, const glm::vec3* v, GLsizei n) {
+        const float* p = glm::value_ptr(v[0]);
+        UploadWith([&] { glProgramUniform3fv(program, loc, n, p); }, [&] { glUniform3fv(loc, n, p); });
+    }
+    void Upload(GLint loc, const glm::vec4* v, GLsizei n) {
+        const float* p = glm::value_ptr(v[0]);
+        UploadWith([&] { glProgramUniform4fv(program, loc, n, p); }, [&] { glUniform4fv(loc, n, p); });
+    }
+    void Upload(GLint loc, const glm::mat3* v, GLsizei n) {
+        const float* p = glm::value_ptr(v[0]);
+        UploadWith([&] { glProgramUniformMatrix3fv(program, loc, n, GL_FALSE, p); },
+                   [&] { glUniformMatrix3fv(loc, n, GL_FALSE, p); });
+    }
+    void Upload(GLint loc, const glm::mat4* v, GLsizei n) {
+        const float* p = glm::value_ptr(v[0]);
+        UploadWith([&] { glProgramUniformMatrix4fv(program, loc, n, GL_FALSE, p); },
+                   [&] { glUniformMatrix4fv(loc, n, GL_FALSE, p); });
+    }
+};
+
+#endif // SHADERREFLECTION_H
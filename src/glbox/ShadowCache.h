@@ -0,0 +1,172 @@
+#ifndef SHADOWCACHE_H
+#define SHADOWCACHE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+// =========================================================================================
+// Cache statickych casteru shadow map. Ke kazde vrstve shadow mapy (jednoducha mapa = vrstva
+// 0, CascadedShadowMaps = vrstva na kaskadu) drzi kopii depth jen se statickymi castery
+// a klic, pro ktery plati: matice svetla + hash statickych casteru (mesh, program, matice).
+// Dokud se klic nezmeni, frame jen obnovi vrstvu kopii (glCopyImageSubData) a nakresli
+// pres ni dynamicke castery - staticka geometrie se do shadow mapy nekresli vubec.
+// Pohnuti statickym objektem nebo svetlem zmeni klic a vrstva se jednou prekresli.
+// Pamet: jedna kopie kazde cachovane shadow mapy.
+// =========================================================================================
+class ShadowCache {
+
+public:
+    bool enabled = true;
+
+    struct Stats {
+        unsigned int rebuilds = 0;        // vrstvy prekreslene se statickymi castery
+        unsigned int restores = 0;        // vrstvy obnovene z cache
+        unsigned int skippedCasters = 0;  // staticke castery, ktere se nemusely kreslit
+    };
+
+    static ShadowCache& Get() {
+        static ShadowCache instance;
+        return instance;
+    }
+
+    ShadowCache(const ShadowCache&) = delete;
+    ShadowCache& operator=(const ShadowCache&) = delete;
+
+    // glCopyImageSubData (GL 4.3 / ARB_copy_image)
+    static bool Supported() {
+        return GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_copy_image;
+    }
+
+    bool Active() const { return enabled && Supported(); }
+
+    // Plati ulozena vrstva pro danou matici svetla a staticke castery?
+    bool Valid(GLuint depthTexture, int layer, const glm::mat4& lightMatrix, uint64_t staticHash) const {
+        auto it = entries.find(depthTexture);
+        if (it == entries.end() || layer >= static_cast<int>(it->second.keys.size())) return false;
+        const Key& k = it->second.keys[layer];
+        return k.valid && k.hash == staticHash && std::memcmp(&k.light, &lightMatrix, sizeof(glm::mat4)) == 0;
+    }
+
+    // Ulozi vrstvu (prave nakreslene staticke castery) a jeji klic
+    void Store(GLuint depthTexture, GLenum target, int layer, const glm::mat4& lightMatrix, uint64_t staticHash) {
+        Entry& e = EnsureEntry(depthTexture, target);
+        if (!e.copy) return;
+        Copy(depthTexture, e.copy, e, layer);
+        e.keys[layer] = {lightMatrix, staticHash, true};
+        stats.rebuilds++;
+    }
+
+    // Obnovi vrstvu z cache (prepise celou vrstvu - clear neni potreba)
+    void Restore(GLuint depthTexture, int layer) {
+        auto it = entries.find(depthTexture);
+        if (it == entries.end()) return;
+        Copy(it->second.copy, depthTexture, it->second, layer);
+        stats.restores++;
+    }
+
+    void CountSkipped(unsigned int casters) { stats.skippedCasters += casters; }
+
+    // Vsechny vrstvy se pri pristim pouziti prekresli (napr. zmena rozliseni)
+    void Invalidate() {
+        for (auto& [texture, e] : entries)
+            for (Key& k : e.keys) k.valid = false;
+    }
+
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+
+    size_t MemoryBytes() const {
+        size_t bytes = 0;
+        for (const auto& [texture, e] : entries)
+            bytes += static_cast<size_t>(e.width) * e.height * e.layers * 4;
+        return bytes;
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        for (auto& [texture, e] : entries)
+            if (e.copy) glDeleteTextures(1, &e.copy);
+        entries.clear();
+    }
+
+    // Hash jednoho casteru (do klice vrstvy se skladaji v poradi render queue)
+    static uint64_t CasterHash(const void* geometry, GLuint program, const glm::mat4& model) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+        mix(reinterpret_cast<uintptr_t>(geometry));
+        mix(program);
+        uint32_t words[16];
+        std::memcpy(words, &model, sizeof(words));
+        for (uint32_t w : words) mix(w);
+        return h;
+    }
+
+    static uint64_t Combine(uint64_t hash, uint64_t caster) {
+        return (hash ^ caster) * 1099511628211ull + 0x9E3779B97F4A7C15ull;
+    }
+
+private:
+    struct Key {
+        glm::mat4 light = glm::mat4(0.0f);
+        uint64_t hash = 0;
+        bool valid = false;
+    };
+
+    struct Entry {
+        GLuint copy = 0;
+        GLenum target = GL_TEXTURE_2D;
+        GLint width = 0, height = 0, layers = 1;
+        GLint internalFormat = 0;
+        std::vector<Key> keys;
+    };
+
+    std::unordered_map<GLuint, Entry> entries;    // zdrojova depth textura -> kopie
+    Stats stats;
+
+    ShadowCache() = default;
+
+    // Kopie se stejnym formatem a rozmery jako zdroj (glCopyImageSubData vyzaduje shodny format)
+    Entry& EnsureEntry(GLuint depthTexture, GLenum target) {
+        Entry& e = entries[depthTexture];
+        GLint width = 0, height = 0, layers = 1, format = 0;
+        glBindTexture(target, depthTexture);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_HEIGHT, &height);
+        if (target == GL_TEXTURE_2D_ARRAY) glGetTexLevelParameteriv(target, 0, GL_TEXTURE_DEPTH, &layers);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+        glBindTexture(target, 0);
+        if (e.copy && e.width == width && e.height == height && e.layers == layers && e.internalFormat == format)
+            return e;
+
+        // nova nebo zmenena shadow mapa
+        if (e.copy) glDeleteTextures(1, &e.copy);
+        e.target = target;
+        e.width = width;
+        e.height = height;
+        e.layers = layers;
+        e.internalFormat = format;
+        e.keys.assign(layers, Key());
+        glGenTextures(1, &e.copy);
+        glBindTexture(target, e.copy);
+        if (target == GL_TEXTURE_2D_ARRAY)
+            glTexImage3D(target, 0, format, width, height, layers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        else
+            glTexImage2D(target, 0, format, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(target, 0);
+        return e;
+    }
+
+    static void Copy(GLuint source, GLuint destination, const Entry& e, int layer) {
+        glCopyImageSubData(source, e.target, 0, 0, 0, layer,
+                           destination, e.target, 0, 0, 0, layer,
+                           e.width, e.height, 1);
+    }
+};
+
+#endif // SHADOWCACHE_H
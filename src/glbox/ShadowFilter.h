@@ -0,0 +1,213 @@
+#ifndef SHADOWFILTER_H
+#define SHADOWFILTER_H
+
+#include <glad/glad.h>
+
+#include "FrameUniforms.h"
+#include "GLStateCache.h"
+
+// Jadra filtrovani stinu - jedno telo pro sampler2DShadow i sampler2DArrayShadow (pretizeni).
+// Vraci podil stinu (1 = plny stin); coord = (uv, porovnavana hloubka uz s biasem),
+// slope = zmena hloubky na texel (tapy dal od stredu porovnavaji s vetsim biasem).
+// Pred vlozenim definovat SHADOW_MAP/SHADOW_DEPTH/SHADOW_LAYER_*/SHADOW_CMP/SHADOW_RAW.
+#define SHADOW_KERNELS_BODY_GLSL                                                           \
+    "float ShadowPcf4(SHADOW_MAP map, vec3 coord SHADOW_LAYER_ARG) {\n"                     \
+    "    vec2 texel = 1.0 / vec2(textureSize(map, 0).xy);\n"                                \
+    "    float lit = SHADOW_CMP(map, coord.xy + vec2(-0.5, -0.5) * texel, coord.z)\n"       \
+    "              + SHADOW_CMP(map, coord.xy + vec2( 0.5, -0.5) * texel, coord.z)\n"       \
+    "              + SHADOW_CMP(map, coord.xy + vec2(-0.5,  0.5) * texel, coord.z)\n"       \
+    "              + SHADOW_CMP(map, coord.xy + vec2( 0.5,  0.5) * texel, coord.z);\n"      \
+    "    return 1.0 - lit * 0.25;\n"                                                        \
+    "}\n"                                                                                   \
+    "float ShadowPoisson(SHADOW_MAP map, vec3 coord, float radius, float slope, float angle SHADOW_LAYER_ARG) {\n" \
+    "    vec2 texel = 1.0 / vec2(textureSize(map, 0).xy);\n"                                \
+    "    mat2 rot = mat2(cos(angle), sin(angle), -sin(angle), cos(angle)) * radius;\n"      \
+    "    float lit = 0.0;\n"                                                                \
+    "    for (int i = 0; i < SHADOW_POISSON_TAPS; ++i) {\n"                                 \
+    "        vec2 offset = rot * SHADOW_POISSON[i];\n"                                      \
+    "        lit += SHADOW_CMP(map, coord.xy + offset * texel, coord.z - slope * length(offset));\n" \
+    "    }\n"                                                                               \
+    "    return 1.0 - lit / float(SHADOW_POISSON_TAPS);\n"                                  \
+    "}\n"                                                                                   \
+    "float ShadowPcss(SHADOW_MAP map, SHADOW_DEPTH depth, vec3 coord, float maxRadius, float slope,\n" \
+    "                 float depthToTexels, float angle SHADOW_LAYER_ARG) {\n"               \
+    "    vec2 texel = 1.0 / vec2(textureSize(map, 0).xy);\n"                                \
+    "    mat2 rot = mat2(cos(angle), sin(angle), -sin(angle), cos(angle)) * maxRadius;\n"   \
+    "    float blockerSum = 0.0, blockers = 0.0;\n"                                         \
+    "    for (int i = 0; i < SHADOW_POISSON_TAPS; ++i) {\n"                                 \
+    "        vec2 offset = rot * SHADOW_POISSON[i];\n"                                      \
+    "        float d = SHADOW_RAW(depth, coord.xy + offset * texel);\n"                      \
+    "        if (d < coord.z - slope * length(offset)) { blockerSum += d; blockers += 1.0; }\n" \
+    "    }\n"                                                                               \
+    "    if (blockers == 0.0) return 0.0;\n"                                                \
+    "    float penumbra = clamp((coord.z - blockerSum / blockers) * depthToTexels, 1.0, maxRadius);\n" \
+    "    return ShadowPoisson(map, coord, penumbra, slope, angle SHADOW_LAYER_CALL);\n"     \
+    "}\n"
+
+// Jadra bez zavislosti na FrameData (vlozit za #version do fragment shaderu)
+#define SHADOW_KERNELS_GLSL                                                                \
+    "#define SHADOW_POISSON_TAPS 12\n"                                                      \
+    "const vec2 SHADOW_POISSON[12] = vec2[](\n"                                             \
+    "    vec2(-0.326, -0.406), vec2(-0.840, -0.074), vec2(-0.696,  0.457),\n"               \
+    "    vec2(-0.203,  0.621), vec2( 0.962, -0.195), vec2( 0.473, -0.480),\n"               \
+    "    vec2( 0.519,  0.767), vec2( 0.185, -0.893), vec2( 0.507,  0.064),\n"               \
+    "    vec2( 0.896,  0.412), vec2(-0.322, -0.933), vec2(-0.792, -0.598));\n"              \
+    "float ShadowNoise(vec2 pixel) {\n"                                                     \
+    "    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));\n"     \
+    "}\n"                                                                                   \
+    "#define SHADOW_MAP sampler2DShadow\n"                                                  \
+    "#define SHADOW_DEPTH sampler2D\n"                                                      \
+    "#define SHADOW_LAYER_ARG\n"                                                            \
+    "#define SHADOW_LAYER_CALL\n"                                                           \
+    "#define SHADOW_CMP(m, uv, z) texture(m, vec3(uv, z))\n"                                \
+    "#define SHADOW_RAW(d, uv) texture(d, uv).r\n"                                          \
+    SHADOW_KERNELS_BODY_GLSL                                                                \
+    "#undef SHADOW_MAP\n#undef SHADOW_DEPTH\n#undef SHADOW_LAYER_ARG\n#undef SHADOW_LAYER_CALL\n" \
+    "#undef SHADOW_CMP\n#undef SHADOW_RAW\n"                                                \
+    "#define SHADOW_MAP sampler2DArrayShadow\n"                                             \
+    "#define SHADOW_DEPTH sampler2DArray\n"                                                 \
+    "#define SHADOW_LAYER_ARG , float layer\n"                                              \
+    "#define SHADOW_LAYER_CALL , layer\n"                                                   \
+    "#define SHADOW_CMP(m, uv, z) texture(m, vec4(uv, layer, z))\n"                         \
+    "#define SHADOW_RAW(d, uv) texture(d, vec3(uv, layer)).r\n"                             \
+    SHADOW_KERNELS_BODY_GLSL                                                                \
+    "#undef SHADOW_MAP\n#undef SHADOW_DEPTH\n#undef SHADOW_LAYER_ARG\n#undef SHADOW_LAYER_CALL\n" \
+    "#undef SHADOW_CMP\n#undef SHADOW_RAW\n"
+
+// Vyber jadra podle FrameData.shadowParams (y = jadro, z = polomer v texelech, w = tan uhlu svetla).
+// EVSM (jadro 3) vzorkuje volajici z momentu (EvsmShadow.h), tady je za nej 4-tap PCF.
+// Vlozit za FRAME_DATA_GLSL; z lightMatrix (ortho) se bere zmena hloubky na texel: slope = bias
+// tapu umerny jeho vzdalenosti (plocha pod 45 stupni siroke jadro nezastini), PCSS prevod na texely.
+#define SHADOW_FILTER_GLSL                                                                 \
+    SHADOW_KERNELS_GLSL                                                                     \
+    "vec2 ShadowKernelScale(mat4 m, float resolution) {\n"                                 \
+    "    float xScale = length(vec3(m[0][0], m[1][0], m[2][0]));\n"                         \
+    "    float zScale = length(vec3(m[0][2], m[1][2], m[2][2]));\n"                         \
+    "    float texelDepth = zScale / (xScale * resolution);\n"                              \
+    "    return vec2(texelDepth, frame.shadowParams.w / texelDepth);\n"                     \
+    "}\n"                                                                                   \
+    "float ShadowFilter(sampler2DShadow map, sampler2D depth, vec3 coord, mat4 lightMatrix) {\n" \
+    "    int kernel = int(frame.shadowParams.y);\n"                                         \
+    "    if (kernel == 0 || kernel > 2) return ShadowPcf4(map, coord);\n"                   \
+    "    float angle = 6.2831853 * ShadowNoise(gl_FragCoord.xy);\n"                         \
+    "    float radius = max(frame.shadowParams.z, 1.0);\n"                                  \
+    "    vec2 scale = ShadowKernelScale(lightMatrix, float(textureSize(map, 0).x));\n"      \
+    "    if (kernel == 1) return ShadowPoisson(map, coord, radius, scale.x, angle);\n"      \
+    "    return ShadowPcss(map, depth, coord, radius, scale.x, scale.y, angle);\n"          \
+    "}\n"                                                                                   \
+    "float ShadowFilter(sampler2DArrayShadow map, sampler2DArray depth, vec3 coord, mat4 lightMatrix, float layer) {\n" \
+    "    int kernel = int(frame.shadowParams.y);\n"                                         \
+    "    if (kernel == 0 || kernel > 2) return ShadowPcf4(map, coord, layer);\n"            \
+    "    float angle = 6.2831853 * ShadowNoise(gl_FragCoord.xy);\n"                         \
+    "    float radius = max(frame.shadowParams.z, 1.0);\n"                                  \
+    "    vec2 scale = ShadowKernelScale(lightMatrix, float(textureSize(map, 0).x));\n"      \
+    "    if (kernel == 1) return ShadowPoisson(map, coord, radius, scale.x, angle, layer);\n" \
+    "    return ShadowPcss(map, depth, coord, radius, scale.x, scale.y, angle, layer);\n"   \
+    "}\n"
+
+// =========================================================================================
+// Filtrovani shadow map pres sampler2DShadow: bilinearni compare v hardware = 2x2 PCF
+// v jednom fetchi (textura musi mit GL_TEXTURE_COMPARE_MODE, viz createDepthMapFBO).
+// Jadra (fetche na pixel):
+//   Pcf4     4   ctyri bilinearni compare po +-0.5 texelu = stanovy filtr 3x3 (drive 9 bodovych .r)
+//   Poisson  12  rotovany Poisson disk (rotace = interleaved gradient noise), radius v texelech
+//   Pcss     24  hledani blokeru (12 x surova hloubka) + Poisson s polostinem podle vzdalenosti
+//                receiver - blocker (smerove svetlo: linearne, lightAngle = tan uhlu svetla)
+//   Evsm     1   trilinearni fetch predfiltrovanych momentu (EvsmShadow::Filter jednou za frame)
+// Volba jadra jde per frame pres FrameData.shadowParams (jeden program, vetveni uniformni).
+// PCSS cte surovou hloubku stejne textury na vlastnich jednotkach se sampler objektem bez
+// compare - jednotky DEPTH_UNIT / CASCADE_DEPTH_UNIT nic jineho nepouziva.
+// =========================================================================================
+class ShadowFilter {
+
+public:
+    enum class Kernel : int { Pcf4 = 0, Poisson = 1, Pcss = 2, Evsm = 3 };
+
+    static constexpr int DEPTH_UNIT = 8;           // surova hloubka jednoduche mapy (PCSS)
+    static constexpr int CASCADE_DEPTH_UNIT = 9;   // surova hloubka kaskad (PCSS)
+
+    Kernel kernel = Kernel::Pcf4;
+    float radius = 3.0f;          // Poisson: polomer, PCSS: maximalni polostin (texely)
+    float lightAngle = 0.02f;     // PCSS: tan uhlove velikosti svetla
+
+    static ShadowFilter& Get() {
+        static ShadowFilter instance;
+        return instance;
+    }
+
+    ShadowFilter(const ShadowFilter&) = delete;
+    ShadowFilter& operator=(const ShadowFilter&) = delete;
+
+    static const char* Name(Kernel k) {
+        switch (k) {
+        case Kernel::Pcf4: return "4-tap PCF";
+        case Kernel::Poisson: return "Poisson 12";
+        case Kernel::Pcss: return "PCSS";
+        case Kernel::Evsm: return "EVSM (prefiltered)";
+        }
+        return "";
+    }
+
+    // Texture fetche na pixel (pro porovnani ceny jader)
+    static int Fetches(Kernel k) {
+        switch (k) {
+        case Kernel::Pcf4: return 4;
+        case Kernel::Poisson: return 12;
+        case Kernel::Pcss: return 24;
+        case Kernel::Evsm: return 1;
+        }
+        return 0;
+    }
+
+    // Parametry do FrameData (pred FrameUniforms::Upload); shadowParams.x patri kaskadam
+    void Apply(FrameData& frame) const {
+        frame.shadowParams.y = static_cast<float>(kernel);
+        frame.shadowParams.z = radius;
+        frame.shadowParams.w = lightAngle;
+    }
+
+    // Surova hloubka pro PCSS (sampler object bez compare zustane navazany do UnbindDepth)
+    void BindDepth(GLStateCache& cache, GLuint shadowMap, GLuint cascades) {
+        if (!depthSampler) {
+            glGenSamplers(1, &depthSampler);
+            glSamplerParameteri(depthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glSamplerParameteri(depthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+            glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+            const float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            glSamplerParameterfv(depthSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+            glSamplerParameteri(depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+        }
+        if (!samplersBound) {
+            glBindSampler(DEPTH_UNIT, depthSampler);
+            glBindSampler(CASCADE_DEPTH_UNIT, depthSampler);
+            samplersBound = true;
+        }
+        cache.BindTexture(DEPTH_UNIT, GL_TEXTURE_2D, shadowMap);
+        cache.BindTexture(CASCADE_DEPTH_UNIT, GL_TEXTURE_2D_ARRAY, cascades);
+    }
+
+    // Po pruchodech, ktere ctou stiny: jednotky 8/9 vrati parametry textury (jine pruchody
+    // a dalsi shadow pass nedostanou sampler bez compare)
+    void UnbindDepth() {
+        if (!samplersBound) return;
+        glBindSampler(DEPTH_UNIT, 0);
+        glBindSampler(CASCADE_DEPTH_UNIT, 0);
+        samplersBound = false;
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        UnbindDepth();
+        if (depthSampler) glDeleteSamplers(1, &depthSampler);
+        depthSampler = 0;
+    }
+
+private:
+    GLuint depthSampler = 0;
+    bool samplersBound = false;
+
+    ShadowFilter() = default;
+};
+
+#endif // SHADOWFILTER_H
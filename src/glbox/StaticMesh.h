@@ -5,22 +5,33 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "PbrMaterial.h"
+#include "FrameUniforms.h"
 #include "physics/Raycast.h"
+#include "geometry/Meshlet.h"
+#include "geometry/IndexData.h"
+#include "geometry/GeometryRegistry.h"
 
 class StaticMesh {
 
 public:
 
-    unsigned int VAO = 0, VBO = 0, EBO = 0;
-    unsigned int indexCount;
+    // sdilena GPU geometrie (rozsah v GeometryArena nebo vlastni VAO/VBO/EBO, CPU data, meshlety)
+    // stejna data = jedna alokace
+    GeometryHandle geometry;
+    uint64_t sourceKey = 0;               // hash vstupnich dat (stride 8)
+    ContentCheck sourceCheck;             // overeni sourceKey (velikosti + druhy hash)
     std::string meshname = "";
 
-    std::vector<float> vertices;    //  data Stride 11 (P, N, UV, T)
-    std::vector<unsigned int> indices;
-
+    // per-instance
     PbrMaterial* material;
     BoxCollider localAABB;
 
+    bool useMeshlets = false;
+    mutable MeshletDrawList meshletDrawList;
+
+    // co z geometrie drzet v RAM po uploadu (AABB zustava vzdy)
+    CpuResidency residency = CpuResidency::KeepAll;
+
     static constexpr int VERTEX_STRIDE = 11;
     static constexpr int INPUT_STRIDE = 8;
 
@@ -35,27 +46,37 @@ public:
         UpdateGeometry(initialVertices, initialIndices);
     }
 
-
-    ~StaticMesh() {
-        if (VAO) glDeleteVertexArrays(1, &VAO);
-        if (VBO) glDeleteBuffers(1, &VBO);
-        if (EBO) glDeleteBuffers(1, &EBO);
+    // hotova (sdilena) geometrie stride 11, napr. z ParallelGeometry::UploadPlane
+    StaticMesh(GeometryHandle sharedGeometry, PbrMaterial* mat, std::string name)
+        : geometry(std::move(sharedGeometry)), meshname(name), material(mat)
+    {
+        if (geometry) {
+            sourceKey = geometry->key;
+            sourceCheck = geometry->content;
+            localAABB = geometry->localAABB;
+            residency = geometry->residency;
+        }
     }
 
-    void Draw(const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj,
-              const glm::vec3& cameraPos, unsigned int envCubemap, unsigned int shadowMap,
-              const glm::mat4& lightSpaceMatrix, const glm::vec3& lightDir, const glm::vec3& lightCol) const
+    unsigned int VAO() const { return geometry ? geometry->VAO : 0; }
+    unsigned int IndexCount() const { return geometry ? geometry->indexCount : 0; }
+    GLenum IndexType() const { return geometry ? geometry->indexType : GL_UNSIGNED_INT; }
+
+    // kamera a svetlo se berou z FrameUniforms (shader z bloku, culling z CPU kopie)
+    void Draw(const glm::mat4& model, unsigned int envCubemap, unsigned int shadowMap,
+              const glm::vec4& materialOverride = NoMaterialOverride()) const
     {
-        if (!material || VAO == 0) return;
+        if (!material || VAO() == 0) return;
+        const GpuGeometry& geo = *geometry;
 
-        material->use(model, view, proj, cameraPos, envCubemap, shadowMap, lightSpaceMatrix, lightDir, lightCol);
+        material->use(model, envCubemap, shadowMap, materialOverride);
         if(material->transmission > 0.0){
             glEnable(GL_BLEND);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         }
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(geo.VAO);
+        DrawElements(model);
         glBindVertexArray(0);
         if(material->transmission > 0.0){
             glDisable(GL_BLEND);
@@ -63,18 +84,67 @@ public:
         material->unuse();
     }
 
-    void DrawForShadow(unsigned int depthShader, const glm::mat4& model, const glm::mat4& lightSpaceMatrix) const {
-        if (VAO == 0 || indexCount == 0) return;
+    // Jen draw call (s meshlet cullingem, pokud je zapnuty); program a VAO uz musi byt navazane
+    void DrawElements(const glm::mat4& model) const {
+        const GpuGeometry& geo = *geometry;
+        if (!geo.meshlets.empty()) {
+            const FrameData& frame = FrameUniforms::Get().data;
+            MeshletCuller::Cull(geo.meshlets, model, frame.viewProjection, glm::vec3(frame.cameraPos), IndexData::TypeSize(geo.indexType), meshletDrawList, geo.arenaRange.firstIndex);
+            MeshletStats::Add(meshletDrawList, geo.meshlets.size());
+            if (meshletDrawList.DrawCount() > 0) {
+                meshletDrawList.baseVertices.assign(meshletDrawList.counts.size(), geo.BaseVertex());
+                glMultiDrawElementsBaseVertex(GL_TRIANGLES, meshletDrawList.counts.data(), geo.indexType,
+                                              meshletDrawList.offsets.data(), meshletDrawList.DrawCount(),
+                                              meshletDrawList.baseVertices.data());
+            }
+        } else {
+            MeshletStats::AddUnclustered(geo.indexCount / 3);
+            glDrawElementsBaseVertex(GL_TRIANGLES, geo.indexCount, geo.indexType, geo.IndexOffset(), geo.BaseVertex());
+        }
+    }
+
+    // lightSpaceMatrix je v bloku FrameData
+    void DrawForShadow(unsigned int depthShader, const glm::mat4& model) const {
+        if (VAO() == 0 || IndexCount() == 0) return;
 
         glUseProgram(depthShader);
-        glUniformMatrix4fv(glGetUniformLocation(depthShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(glGetUniformLocation(depthShader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+        ProgramReflection& r = ProgramReflection::For(depthShader);
+        r.Set(r.Handle<int>("instanced"_u), 0);
+        r.Set(r.Handle<glm::mat4>("model"_u), model);
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(geometry->VAO);
+        glDrawElementsBaseVertex(GL_TRIANGLES, geometry->indexCount, geometry->indexType,
+                                 geometry->IndexOffset(), geometry->BaseVertex());
         glBindVertexArray(0);
     }
 
+    // Zapne/vypne meshlet culling; meshlet varianta je v registry pod vlastnim klicem,
+    // takze ji instance se stejnymi daty sdileji
+    void EnableMeshlets(bool enable) {
+        useMeshlets = enable;
+        if (!geometry || geometry->vertexCount == 0) return;
+        if (!geometry->meshlets.empty() == enable) return;
+
+        GeometryHandle source = geometry;
+        geometry = GeometryRegistry::Get().Acquire(GeometryKey(), sourceCheck, [&](GpuGeometry& g) {
+            source->EnsureCpuData();
+            g.vertices = source->vertices;
+            g.indices = source->indices;
+            g.localAABB = source->localAABB;
+            if (useMeshlets)
+                g.meshlets = MeshletBuilder::Build(g.vertices, VERTEX_STRIDE, g.indices);
+            Upload(g);
+        });
+        source->SetResidency(source->residency);
+        geometry->SetResidency(residency);
+    }
+
+    // Nastavi residency policy a hned ji aplikuje na (sdilenou) geometrii
+    void SetResidency(CpuResidency policy) {
+        residency = policy;
+        if (geometry) geometry->SetResidency(policy);
+    }
+
     // data STRIDE 8,  tangentS TO  STRIDE 11
     // =========================================================================================
 
@@ -83,41 +153,66 @@ public:
 
         if (inputVertices.size() % INPUT_STRIDE != 0) {
             std::cerr << "err: UpdateGeometry:  data (P, N, UV) not have Stride " << INPUT_STRIDE << "." << std::endl;
-            indexCount = 0;
+            geometry.reset();
             return;
         }
-        this->localAABB.CalculateFromVertices(inputVertices, INPUT_STRIDE);
-        // COPY (Stride 8) a transforma (Stride 11)
-        this->vertices = inputVertices;
-        this->indices = inputIndices;
 
-        CalculateTangents(this->vertices, this->indices); //  Stride 8 -> Stride 11
+        sourceKey = GeometryRegistry::KeyFromContent("StaticMesh:P3N3UV2", inputVertices, inputIndices);
+        sourceCheck = GeometryRegistry::CheckFromContent(inputVertices, inputIndices);
 
-        if (this->vertices.size() % VERTEX_STRIDE != 0) {
-            std::cerr << "err: UpdateGeometry:  Stride not " << VERTEX_STRIDE << "." << std::endl;
-            indexCount = 0;
-            return;
-        }
+        geometry = GeometryRegistry::Get().Acquire(GeometryKey(), sourceCheck, [&](GpuGeometry& g) {
+            g.localAABB.CalculateFromVertices(inputVertices, INPUT_STRIDE);
+            // COPY (Stride 8) a transforma (Stride 11)
+            g.vertices = inputVertices;
+            g.indices = inputIndices;
+
+            CalculateTangents(g.vertices, g.indices); //  Stride 8 -> Stride 11
+
+            if (g.vertices.size() % VERTEX_STRIDE != 0) {
+                std::cerr << "err: UpdateGeometry:  Stride not " << VERTEX_STRIDE << "." << std::endl;
+                return;
+            }
+
+            if (useMeshlets)
+                g.meshlets = MeshletBuilder::Build(g.vertices, VERTEX_STRIDE, g.indices);
 
-        indexCount = static_cast<unsigned int>(this->indices.size());
+            Upload(g);
+        });
 
-        if (VAO) glDeleteVertexArrays(1, &VAO);
-        if (VBO) glDeleteBuffers(1, &VBO);
-        if (EBO) glDeleteBuffers(1, &EBO);
+        this->localAABB = geometry->localAABB;
+        geometry->SetResidency(residency);
+    }
 
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+    // Nahraje CPU data geometrie (stride 11) do GeometryArena, bez areny do novych VAO/VBO/EBO
+    static void Upload(GpuGeometry& g) {
+        g.vertexStride = VERTEX_STRIDE;
+        g.vertexCount = static_cast<unsigned int>(g.vertices.size() / VERTEX_STRIDE);
+        g.indexCount = static_cast<unsigned int>(g.indices.size());
+        g.vertexBytes = g.vertices.size() * sizeof(float);
 
-        glBindVertexArray(VAO);
+        // Indices, uint16/uint32 podle poctu vertexu
+        IndexData packed = IndexData::FromIndices(g.indices, g.vertexCount);
+        g.indexType = packed.type;
+        g.indexBytes = packed.Bytes();
+
+        if (g.PlaceInArena(packed.type)) {
+            g.arena->Upload(g.arenaRange, g.vertices.data(), packed.Data());
+            return;
+        }
+
+        glGenVertexArrays(1, &g.VAO);
+        glGenBuffers(1, &g.VBO);
+        glGenBuffers(1, &g.EBO);
+
+        glBindVertexArray(g.VAO);
 
         // VBO (Vertices -  Stride 11)
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(float), this->vertices.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, g.VBO);
+        glBufferData(GL_ARRAY_BUFFER, g.vertexBytes, g.vertices.data(), GL_STATIC_DRAW);
 
-        // EBO (Indices)
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->indices.size() * sizeof(unsigned int), this->indices.data(), GL_DYNAMIC_DRAW);
+        // EBO
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, g.indexBytes, packed.Data(), GL_STATIC_DRAW);
 
         // 3.  atributS (Stride 11)
         GLsizei stride = VERTEX_STRIDE * sizeof(float);
@@ -206,6 +301,12 @@ public:
         vertices = std::move(newVertices); //  (stride 8) TO(stride 11)
     }
 
+private:
+
+    uint64_t GeometryKey() const {
+        return GeometryRegistry::Combine(sourceKey, useMeshlets ? 1u : 0u);
+    }
+
 };
 
 #endif // STATICMESH_H
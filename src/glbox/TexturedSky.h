@@ -2,6 +2,8 @@
 #define TEXTUREDSKY_H
 
 #include "Shader.h"
+#include "FrameUniforms.h"
+#include "geometry/GeometryRegistry.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -11,17 +13,14 @@
 #include <iostream>
 #include <stb_image.h>
 
-const char *skyboxVertexShaderSource = R"(
-    #version 330 core
+const char *skyboxVertexShaderSource = "#version 330 core\n" FRAME_DATA_GLSL R"(
     layout (location = 0) in vec3 aPos;
     out vec3 TexCoords;
-    uniform mat4 projection;
-    uniform mat4 view;
     void main()
     {
         TexCoords = aPos;
         // Odstranění translace z view matice pro nekonečně vzdálený skybox
-        vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
+        vec4 pos = frame.projection * mat4(mat3(frame.view)) * vec4(aPos, 1.0);
         gl_Position = pos.xyww; // Použití z ve w pro zaručení maximální hloubky
     }
     )";
@@ -75,23 +74,17 @@ public:
         glUniform1i(glGetUniformLocation(shaderProgram, "skybox"), 0);
     }
 
-    void Draw(const glm::mat4& view, const glm::mat4& projection) {
+    // view/projection z FrameUniforms, translaci odstrani vertex shader
+    void Draw() {
         // Nastavení pro kreslení skyboxu
         glDepthFunc(GL_LEQUAL); // Změníme funkci hloubkového testu
 
         glUseProgram(shaderProgram);
 
-        // Z view matice odstraníme složky translace, aby se skybox pohyboval s kamerou
-        // ale nepromítal se do prostoru (zůstane "nekonečně" daleko).
-        glm::mat4 skyView = glm::mat4(glm::mat3(view));
-
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(skyView));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-        glBindVertexArray(skyboxVAO);
+        glBindVertexArray(skyCube->VAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glDrawArrays(GL_TRIANGLES, 0, skyCube->vertexCount);
         glBindVertexArray(0);
 
         glDepthFunc(GL_LESS);
@@ -99,8 +92,7 @@ public:
 
 
     ~TexturedSky() {
-        glDeleteVertexArrays(1, &skyboxVAO);
-        glDeleteBuffers(1, &skyboxVBO);
+        ProgramReflection::Forget(shaderProgram);
         glDeleteProgram(shaderProgram);
         glDeleteTextures(1, &cubemapTexture);
     }
@@ -131,7 +123,8 @@ private:
         return texID;
     }
 
-    unsigned int skyboxVAO, skyboxVBO, shaderProgram, cubemapTexture;
+    unsigned int shaderProgram, cubemapTexture;
+    GeometryHandle skyCube;   // sdilena kostka +-1 z GeometryRegistry
 
     void InitShaders() {
 
@@ -141,29 +134,7 @@ private:
     }
 
     void InitData() {
-        float skyboxVertices[] = {
-            -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
-            1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
-            -1.0f, -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
-            -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
-            1.0f, -1.0f, -1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,  1.0f,
-            1.0f,  1.0f,  1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
-            -1.0f, -1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,  1.0f,  1.0f,
-            1.0f,  1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
-            -1.0f,  1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,
-            1.0f,  1.0f,  1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f,
-            -1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,
-            1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f
-        };
-
-        glGenVertexArrays(1, &skyboxVAO);
-        glGenBuffers(1, &skyboxVBO);
-        glBindVertexArray(skyboxVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), skyboxVertices, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glBindVertexArray(0);
+        skyCube = GeometryRegistry::Get().SkyCube();
     }
 };
 
@@ -3,7 +3,16 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdint>
 
+// =========================================================================================
+// Pozice / Euler rotace (stupne, poradi X*Y*Z) / meritko s cachovanou model matici.
+// Pole jsou verejna a zapisuje se do nich primo, proto se "dirty" pozna porovnanim s
+// hodnotami, ze kterych byla matice naposled postavena (9 floatu misto 6 sin/cos a
+// ctyr nasobeni mat4). Staticke objekty matici postavi jednou, pohyblive jednou za frame
+// bez ohledu na pocet volani (Draw, shadow, fyzika, RenderQueue).
+// =========================================================================================
 class Transform {
 
 public:
@@ -14,14 +23,46 @@ public:
     Transform(const glm::vec3& pos = glm::vec3(0.0f), const glm::vec3& rot = glm::vec3(0.0f), const glm::vec3& s = glm::vec3(1.0f))
         : position(pos), rotation(rot), scale(s) {}
 
-    glm::mat4 GetModelMatrix() const {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::scale(model, scale);
+    const glm::mat4& GetModelMatrix() const {
+        if (!valid || position != builtPosition || rotation != builtRotation || scale != builtScale) {
+            model = Compose(position, rotation, scale);
+            builtPosition = position;
+            builtRotation = rotation;
+            builtScale = scale;
+            valid = true;
+            version++;
+        }
         return model;
     }
+
+    // Zvysi se pri kazdem prepocitani matice - konzumenti (AABB, shadow cache) si muzou
+    // pamatovat posledni verzi a preskocit praci, pokud se objekt nepohnul
+    uint32_t Version() const {
+        GetModelMatrix();
+        return version;
+    }
+
+    // translate * rotX * rotY * rotZ * scale v uzavrene forme (sloupce rotace prenasobene meritkem)
+    static glm::mat4 Compose(const glm::vec3& pos, const glm::vec3& rotDegrees, const glm::vec3& s) {
+        const glm::vec3 r = glm::radians(rotDegrees);
+        const float sx = std::sin(r.x), cx = std::cos(r.x);
+        const float sy = std::sin(r.y), cy = std::cos(r.y);
+        const float sz = std::sin(r.z), cz = std::cos(r.z);
+
+        glm::mat4 m;
+        m[0] = glm::vec4(cy * cz, sx * sy * cz + cx * sz, sx * sz - cx * sy * cz, 0.0f) * s.x;
+        m[1] = glm::vec4(-cy * sz, cx * cz - sx * sy * sz, cx * sy * sz + sx * cz, 0.0f) * s.y;
+        m[2] = glm::vec4(sy, -sx * cy, cx * cy, 0.0f) * s.z;
+        m[3] = glm::vec4(pos, 1.0f);
+        return m;
+    }
+
+private:
+    mutable glm::mat4 model = glm::mat4(1.0f);
+    mutable glm::vec3 builtPosition = glm::vec3(0.0f);
+    mutable glm::vec3 builtRotation = glm::vec3(0.0f);
+    mutable glm::vec3 builtScale = glm::vec3(1.0f);
+    mutable uint32_t version = 0;
+    mutable bool valid = false;
 };
 #endif // TRANSFORM_H
@@ -0,0 +1,321 @@
+#ifndef TRANSFORMBATCH_H
+#define TRANSFORMBATCH_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+
+#include "Transform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLBOX_TRANSFORM_BATCH_SSE 1
+#include <emmintrin.h>
+#endif
+
+// =========================================================================================
+// Davkove skladani model matic z SoA poli (translate * rotace * scale), 4 objekty v jednom
+// SSE registru (lane = objekt). Euler varianta (stupne, poradi X*Y*Z = Transform::Compose)
+// pocita sin/cos vlastnim polynomem (Cephes, presnost ~1e-7 pro rozumne uhly),
+// quaternion varianta je bez goniometrie, osa/uhel varianta pocita sin/cos polovicniho uhlu
+// stejnym polynomem a normalizuje osu v registru. Na konci se 4x4 lane transponuji do sloupcu mat4.
+// *Scalar = referencni implementace se stejnymi vzorci (zbytek davky, porovnani, bez SSE).
+// =========================================================================================
+namespace TransformBatch {
+
+// Pohled na SoA data - pole musi mit alespon 'count' prvku
+struct EulerSoA {
+    const float *px, *py, *pz;
+    const float *rx, *ry, *rz;    // stupne
+    const float *sx, *sy, *sz;
+};
+
+struct QuatSoA {
+    const float *px, *py, *pz;
+    const float *qx, *qy, *qz, *qw;   // jednotkovy quaternion
+    const float *sx, *sy, *sz;
+};
+
+struct AxisAngleSoA {
+    const float *px, *py, *pz;
+    const float *ax, *ay, *az;    // osa rotace (nemusi byt normalizovana, nesmi byt nulova)
+    const float *angle;           // radiany
+    const float *sx, *sy, *sz;
+};
+
+inline void ComposeEulerScalar(const EulerSoA& in, size_t begin, size_t end, glm::mat4* out) {
+    for (size_t i = begin; i < end; ++i)
+        out[i] = Transform::Compose(glm::vec3(in.px[i], in.py[i], in.pz[i]),
+                                    glm::vec3(in.rx[i], in.ry[i], in.rz[i]),
+                                    glm::vec3(in.sx[i], in.sy[i], in.sz[i]));
+}
+
+inline void QuatMatrix(float x, float y, float z, float w, const glm::vec3& pos, const glm::vec3& s, glm::mat4& m) {
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y, wz = w * z;
+    m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * s.x;
+    m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * s.y;
+    m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * s.z;
+    m[3] = glm::vec4(pos, 1.0f);
+}
+
+inline void ComposeQuatScalar(const QuatSoA& in, size_t begin, size_t end, glm::mat4* out) {
+    for (size_t i = begin; i < end; ++i)
+        QuatMatrix(in.qx[i], in.qy[i], in.qz[i], in.qw[i], glm::vec3(in.px[i], in.py[i], in.pz[i]),
+                   glm::vec3(in.sx[i], in.sy[i], in.sz[i]), out[i]);
+}
+
+inline void ComposeAxisAngleScalar(const AxisAngleSoA& in, size_t begin, size_t end, glm::mat4* out) {
+    for (size_t i = begin; i < end; ++i) {
+        const glm::vec3 axis = glm::normalize(glm::vec3(in.ax[i], in.ay[i], in.az[i]));
+        const float s = std::sin(0.5f * in.angle[i]);
+        QuatMatrix(axis.x * s, axis.y * s, axis.z * s, std::cos(0.5f * in.angle[i]),
+                   glm::vec3(in.px[i], in.py[i], in.pz[i]), glm::vec3(in.sx[i], in.sy[i], in.sz[i]), out[i]);
+    }
+}
+
+#ifdef GLBOX_TRANSFORM_BATCH_SSE
+namespace detail {
+
+// sin a cos 4 uhlu (radiany): redukce na [-pi/4, pi/4] po kvadrantech (Cody-Waite), Cephes polynomy
+inline void SinCos(__m128 x, __m128& s, __m128& c) {
+    const __m128i j = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236758134f)));   // round(x * 2/pi)
+    const __m128 jf = _mm_cvtepi32_ps(j);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(jf, _mm_set1_ps(1.5703125f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(4.837512969970703125e-4f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(7.54978995489188216e-8f)));
+
+    const __m128 z = _mm_mul_ps(r, r);
+    __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(ps, z), r));
+    __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_mul_ps(_mm_mul_ps(z, z), pc));
+
+    // kvadrant q = j & 3: sin = (s, c, -s, -c), cos = (c, -s, -c, s)
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, two), 30));
+    const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), two), 30));
+    s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps)), sinSign);
+    c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc)), cosSign);
+}
+
+// Sloupce rotace*scale z jednotkovych quaternionu (lane = objekt)
+inline void QuatColumns(__m128 x, __m128 y, __m128 z, __m128 w,
+                        __m128 scaleX, __m128 scaleY, __m128 scaleZ, __m128 col[3][3]) {
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+    const __m128 x2 = _mm_mul_ps(x, two), y2 = _mm_mul_ps(y, two), z2 = _mm_mul_ps(z, two);
+    const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+    const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+    const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+    col[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scaleX);
+    col[0][1] = _mm_mul_ps(_mm_add_ps(xy, wz), scaleX);
+    col[0][2] = _mm_mul_ps(_mm_sub_ps(xz, wy), scaleX);
+    col[1][0] = _mm_mul_ps(_mm_sub_ps(xy, wz), scaleY);
+    col[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scaleY);
+    col[1][2] = _mm_mul_ps(_mm_add_ps(yz, wx), scaleY);
+    col[2][0] = _mm_mul_ps(_mm_add_ps(xz, wy), scaleZ);
+    col[2][1] = _mm_mul_ps(_mm_sub_ps(yz, wx), scaleZ);
+    col[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scaleZ);
+}
+
+// Sloupce rotace*scale (col[c][radek], lane = objekt) + pozice -> 4 matice
+inline void Store(__m128 col[3][3], __m128 px, __m128 py, __m128 pz, glm::mat4* out) {
+    const __m128 zero = _mm_setzero_ps();
+    for (int c = 0; c < 3; ++c) {
+        __m128 a = col[c][0], b = col[c][1], d = col[c][2], w = zero;
+        _MM_TRANSPOSE4_PS(a, b, d, w);
+        _mm_storeu_ps(&out[0][c][0], a);
+        _mm_storeu_ps(&out[1][c][0], b);
+        _mm_storeu_ps(&out[2][c][0], d);
+        _mm_storeu_ps(&out[3][c][0], w);
+    }
+    __m128 one = _mm_set1_ps(1.0f);
+    _MM_TRANSPOSE4_PS(px, py, pz, one);
+    _mm_storeu_ps(&out[0][3][0], px);
+    _mm_storeu_ps(&out[1][3][0], py);
+    _mm_storeu_ps(&out[2][3][0], pz);
+    _mm_storeu_ps(&out[3][3][0], one);
+}
+
+} // namespace detail
+#endif
+
+// out[0 .. count) - stejny vysledek jako Transform::Compose (az na presnost sin/cos)
+inline void ComposeEuler(const EulerSoA& in, size_t count, glm::mat4* out) {
+    size_t i = 0;
+#ifdef GLBOX_TRANSFORM_BATCH_SSE
+    const __m128 toRad = _mm_set1_ps(0.017453292519943295f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 sx, cx, sy, cy, sz, cz;
+        detail::SinCos(_mm_mul_ps(_mm_loadu_ps(in.rx + i), toRad), sx, cx);
+        detail::SinCos(_mm_mul_ps(_mm_loadu_ps(in.ry + i), toRad), sy, cy);
+        detail::SinCos(_mm_mul_ps(_mm_loadu_ps(in.rz + i), toRad), sz, cz);
+        const __m128 scaleX = _mm_loadu_ps(in.sx + i), scaleY = _mm_loadu_ps(in.sy + i), scaleZ = _mm_loadu_ps(in.sz + i);
+        const __m128 sxsy = _mm_mul_ps(sx, sy), cxsy = _mm_mul_ps(cx, sy);
+
+        __m128 col[3][3];
+        col[0][0] = _mm_mul_ps(_mm_mul_ps(cy, cz), scaleX);
+        col[0][1] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(sxsy, cz), _mm_mul_ps(cx, sz)), scaleX);
+        col[0][2] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sx, sz), _mm_mul_ps(cxsy, cz)), scaleX);
+        col[1][0] = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(cy, sz)), scaleY);
+        col[1][1] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cx, cz), _mm_mul_ps(sxsy, sz)), scaleY);
+        col[1][2] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cxsy, sz), _mm_mul_ps(sx, cz)), scaleY);
+        col[2][0] = _mm_mul_ps(sy, scaleZ);
+        col[2][1] = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sx, cy)), scaleZ);
+        col[2][2] = _mm_mul_ps(_mm_mul_ps(cx, cy), scaleZ);
+        detail::Store(col, _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i), out + i);
+    }
+#endif
+    ComposeEulerScalar(in, i, count, out);
+}
+
+inline void ComposeQuat(const QuatSoA& in, size_t count, glm::mat4* out) {
+    size_t i = 0;
+#ifdef GLBOX_TRANSFORM_BATCH_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 col[3][3];
+        detail::QuatColumns(_mm_loadu_ps(in.qx + i), _mm_loadu_ps(in.qy + i), _mm_loadu_ps(in.qz + i), _mm_loadu_ps(in.qw + i),
+                            _mm_loadu_ps(in.sx + i), _mm_loadu_ps(in.sy + i), _mm_loadu_ps(in.sz + i), col);
+        detail::Store(col, _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i), out + i);
+    }
+#endif
+    ComposeQuatScalar(in, i, count, out);
+}
+
+// Osa/uhel: normalizace osy i sin/cos polovicniho uhlu v registru, pak jako ComposeQuat
+inline void ComposeAxisAngle(const AxisAngleSoA& in, size_t count, glm::mat4* out) {
+    size_t i = 0;
+#ifdef GLBOX_TRANSFORM_BATCH_SSE
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 ax = _mm_loadu_ps(in.ax + i), ay = _mm_loadu_ps(in.ay + i), az = _mm_loadu_ps(in.az + i);
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, ax), _mm_mul_ps(ay, ay)), _mm_mul_ps(az, az));
+        __m128 s, c;
+        detail::SinCos(_mm_mul_ps(_mm_loadu_ps(in.angle + i), half), s, c);
+        const __m128 k = _mm_div_ps(s, _mm_sqrt_ps(len2));
+
+        __m128 col[3][3];
+        detail::QuatColumns(_mm_mul_ps(ax, k), _mm_mul_ps(ay, k), _mm_mul_ps(az, k), c,
+                            _mm_loadu_ps(in.sx + i), _mm_loadu_ps(in.sy + i), _mm_loadu_ps(in.sz + i), col);
+        detail::Store(col, _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i), out + i);
+    }
+#endif
+    ComposeAxisAngleScalar(in, i, count, out);
+}
+
+// sin a cos pole uhlu (radiany) - stejny polynom jako ComposeEuler, zbytek std::sin/cos
+inline void SinCos(const float* angles, size_t count, float* sinOut, float* cosOut) {
+    size_t i = 0;
+#ifdef GLBOX_TRANSFORM_BATCH_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 s, c;
+        detail::SinCos(_mm_loadu_ps(angles + i), s, c);
+        _mm_storeu_ps(sinOut + i, s);
+        _mm_storeu_ps(cosOut + i, c);
+    }
+#endif
+    for (; i < count; ++i) {
+        sinOut[i] = std::sin(angles[i]);
+        cosOut[i] = std::cos(angles[i]);
+    }
+}
+
+// =========================================================================================
+// Mikrobenchmark: count nahodnych transformaci, nejlepsi z 'iterations' behu (ms).
+// glm = puvodni translate * rotate * rotate * rotate * scale po jedne matici.
+// maxError = nejvetsi odchylka prvku matice: Euler (skalar i SSE) proti glm, quat a osa/uhel
+// SSE proti skalarni variante. Nad MaxErrorTolerance je davkova cesta rozbita.
+// =========================================================================================
+constexpr float MaxErrorTolerance = 1e-4f;
+
+struct BenchmarkResult {
+    size_t count = 0;
+    double glmMs = 0.0;
+    double eulerScalarMs = 0.0, eulerSimdMs = 0.0;
+    double quatScalarMs = 0.0, quatSimdMs = 0.0;
+    double axisAngleScalarMs = 0.0, axisAngleSimdMs = 0.0;
+    float maxError = 0.0f;
+
+    bool Passed() const { return maxError <= MaxErrorTolerance; }
+};
+
+inline BenchmarkResult Benchmark(size_t count = 100000, int iterations = 10) {
+    std::vector<float> data[14];
+    uint32_t seed = 12345u;
+    auto random = [&seed](float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<float>(seed >> 8) / 16777216.0f;
+    };
+    for (auto& d : data) d.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (int k = 0; k < 3; ++k) data[k][i] = random(-100.0f, 100.0f);          // pozice
+        for (int k = 3; k < 6; ++k) data[k][i] = random(-360.0f, 360.0f);          // Euler
+        for (int k = 6; k < 9; ++k) data[k][i] = random(0.1f, 3.0f);               // meritko
+        glm::vec4 q(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f));
+        q = glm::normalize(q + glm::vec4(0.0f, 0.0f, 0.0f, 1e-3f));
+        for (int k = 0; k < 4; ++k) data[9 + k][i] = q[k];
+        data[13][i] = random(-6.2831853f, 6.2831853f);                          // uhel osa/uhel
+    }
+    const EulerSoA euler = {data[0].data(), data[1].data(), data[2].data(), data[3].data(), data[4].data(),
+                            data[5].data(), data[6].data(), data[7].data(), data[8].data()};
+    const QuatSoA quat = {data[0].data(), data[1].data(), data[2].data(), data[9].data(), data[10].data(),
+                          data[11].data(), data[12].data(), data[6].data(), data[7].data(), data[8].data()};
+    const AxisAngleSoA axisAngle = {data[0].data(), data[1].data(), data[2].data(), data[9].data(), data[10].data(),
+                                    data[11].data(), data[13].data(), data[6].data(), data[7].data(), data[8].data()};
+
+    std::vector<glm::mat4> reference(count), result(count);
+    auto best = [iterations](auto&& fn) {
+        double ms = 1e30;
+        for (int it = 0; it < iterations; ++it) {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            ms = std::min(ms, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+        }
+        return ms;
+    };
+    auto maxDiff = [&]() {
+        float diff = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+            for (int c = 0; c < 4; ++c)
+                for (int r = 0; r < 4; ++r)
+                    diff = std::max(diff, std::abs(result[i][c][r] - reference[i][c][r]));
+        return diff;
+    };
+
+    BenchmarkResult b;
+    b.count = count;
+    b.glmMs = best([&]() {
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(euler.px[i], euler.py[i], euler.pz[i]));
+            m = glm::rotate(m, glm::radians(euler.rx[i]), glm::vec3(1.0f, 0.0f, 0.0f));
+            m = glm::rotate(m, glm::radians(euler.ry[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+            m = glm::rotate(m, glm::radians(euler.rz[i]), glm::vec3(0.0f, 0.0f, 1.0f));
+            reference[i] = glm::scale(m, glm::vec3(euler.sx[i], euler.sy[i], euler.sz[i]));
+        }
+    });
+    b.eulerScalarMs = best([&]() { ComposeEulerScalar(euler, 0, count, result.data()); });
+    b.maxError = maxDiff();
+    b.eulerSimdMs = best([&]() { ComposeEuler(euler, count, result.data()); });
+    b.maxError = std::max(b.maxError, maxDiff());
+    b.quatScalarMs = best([&]() { ComposeQuatScalar(quat, 0, count, reference.data()); });
+    b.quatSimdMs = best([&]() { ComposeQuat(quat, count, result.data()); });
+    b.maxError = std::max(b.maxError, maxDiff());
+    b.axisAngleScalarMs = best([&]() { ComposeAxisAngleScalar(axisAngle, 0, count, reference.data()); });
+    b.axisAngleSimdMs = best([&]() { ComposeAxisAngle(axisAngle, count, result.data()); });
+    b.maxError = std::max(b.maxError, maxDiff());
+    if (!b.Passed())
+        std::cerr << "err: TransformBatch: max error " << b.maxError << " over tolerance" << std::endl;
+    return b;
+}
+
+} // namespace TransformBatch
+
+#endif // TRANSFORMBATCH_H
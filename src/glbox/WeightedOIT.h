@@ -0,0 +1,246 @@
+#ifndef WEIGHTEDOIT_H
+#define WEIGHTEDOIT_H
+
+#include <glad/glad.h>
+#include <iostream>
+
+#include "GLStateCache.h"
+#include "ProgramCache.h"
+#include "ShaderReflection.h"
+
+// =========================================================================================
+// Weighted blended order-independent transparency (McGuire & Bavoil 2013).
+// Pruhledne fragmenty se nescitaji v poradi kresleni, ale do dvou cilu:
+//   accum  (RGBA16F) += (color * alpha, alpha) * w(z, alpha)     blend ONE, ONE
+//   reveal (R8)      *= (1 - alpha)                              blend ZERO, ONE_MINUS_SRC_COLOR
+// Obe operace jsou komutativni, takze pruhledne objekty netreba radit. Composite jeden
+// full-screen trojuhelnik: color = accum.rgb / accum.a, coverage = 1 - reveal.
+// Depth opaque sceny: cilovy FBO se sdili primo (attachment), default framebuffer se blituje.
+// =========================================================================================
+class WeightedOIT {
+
+public:
+    bool enabled = true;
+
+    static WeightedOIT& Get() {
+        static WeightedOIT instance;
+        return instance;
+    }
+
+    WeightedOIT(const WeightedOIT&) = delete;
+    WeightedOIT& operator=(const WeightedOIT&) = delete;
+
+    // glBlendFunci (GL 4.0 / ARB_draw_buffers_blend) - kazdy cil ma jiny blend
+    static bool Supported() {
+        return GLAD_GL_VERSION_4_0 || GLAD_GL_ARB_draw_buffers_blend;
+    }
+
+    // Pruhledny pruchod prave bezi do OIT cilu (PbrMaterial vybira OIT variantu)
+    bool Active() const { return active; }
+
+    // Presmeruje kresleni do accum/reveal; cil a viewport = aktualne navazany draw framebuffer
+    bool Begin() {
+        if (!enabled || !Supported() || active) return false;
+        GLint framebuffer = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        target = static_cast<GLuint>(framebuffer);
+        if (!EnsureTargets(viewport[2], viewport[3])) return false;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        static const GLfloat zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        static const GLfloat one[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glClearBufferfv(GL_COLOR, 0, zero);
+        glClearBufferfv(GL_COLOR, 1, one);
+
+        // depth test proti opaque scene, ale bez zapisu - vsechny vrstvy se akumuluji
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glEnable(GL_BLEND);
+        glBlendFunci(0, GL_ONE, GL_ONE);
+        glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+        active = true;
+        return true;
+    }
+
+    // Slozi akumulaci do puvodniho framebufferu (jeden full-screen pruchod)
+    void Composite() {
+        if (!active) return;
+        active = false;
+        glDepthMask(GL_TRUE);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);   // vsechny cile zpet na default repa
+
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glDisable(GL_DEPTH_TEST);
+
+        GLStateCache& cache = GLStateCache::Get();
+        cache.Invalidate();
+        cache.SetBlend(true);
+        GLuint program = CompositeProgram();
+        cache.UseProgram(program);
+        ProgramReflection& r = ProgramReflection::For(program);
+        cache.BindTexture(0, GL_TEXTURE_2D, accumTexture);
+        cache.BindTexture(1, GL_TEXTURE_2D, revealTexture);
+        r.Set(r.Handle<int>("accum"_u), 0);
+        r.Set(r.Handle<int>("reveal"_u), 1);
+        cache.BindVertexArray(emptyVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        cache.BindVertexArray(0);
+        cache.UseProgram(0);
+        cache.SetBlend(false);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    // Volat pred znicenim GL kontextu
+    void Release() {
+        ReleaseTargets();
+        if (emptyVAO) glDeleteVertexArrays(1, &emptyVAO);
+        emptyVAO = 0;
+        program.reset();
+        active = false;
+    }
+
+private:
+    GLuint fbo = 0, accumTexture = 0, revealTexture = 0, depthBuffer = 0, emptyVAO = 0;
+    GLsizei width = 0, height = 0;
+    GLuint target = 0;
+    GLuint sharedDepth = 0;       // depth attachment ciloveho FBO navazany do OIT FBO
+    GLint viewport[4] = {0, 0, 0, 0};
+    ProgramHandle program;
+    bool active = false;
+
+    WeightedOIT() = default;
+
+    void ReleaseTargets() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (accumTexture) glDeleteTextures(1, &accumTexture);
+        if (revealTexture) glDeleteTextures(1, &revealTexture);
+        if (depthBuffer) glDeleteRenderbuffers(1, &depthBuffer);
+        fbo = accumTexture = revealTexture = depthBuffer = 0;
+        width = height = 0;
+        sharedDepth = 0;
+    }
+
+    bool EnsureTargets(GLsizei w, GLsizei h) {
+        if (w <= 0 || h <= 0) return false;
+        if (w != width || h != height) {
+            ReleaseTargets();
+            width = w;
+            height = h;
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            accumTexture = CreateTarget(GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+            revealTexture = CreateTarget(GL_R8, GL_RED, GL_UNSIGNED_BYTE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTexture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, revealTexture, 0);
+            const GLenum buffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+            glDrawBuffers(2, buffers);
+        }
+        if (!emptyVAO) glGenVertexArrays(1, &emptyVAO);
+        return AttachDepth();
+    }
+
+    GLuint CreateTarget(GLenum internalFormat, GLenum format, GLenum type) const {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        return texture;
+    }
+
+    // Depth opaque sceny: cilovy FBO sdili svuj attachment (bez kopie),
+    // default framebuffer (nejde pripojit) se kopiruje blitem do vlastniho bufferu
+    bool AttachDepth() {
+        GLint type = GL_NONE, name = 0;
+        if (target != 0) {
+            glBindFramebuffer(GL_FRAMEBUFFER, target);
+            glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                                  GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+            if (type != GL_NONE)
+                glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                                      GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &name);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        if (type == GL_TEXTURE || type == GL_RENDERBUFFER) {
+            if (sharedDepth != static_cast<GLuint>(name)) {
+                if (type == GL_TEXTURE)
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, name, 0);
+                else
+                    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, name);
+                sharedDepth = static_cast<GLuint>(name);
+            }
+        } else {
+            if (!depthBuffer) {
+                // format depth musi sedet s cilem, jinak blit selze
+                GLenum format = TargetDepthFormat();
+                glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+                glGenRenderbuffers(1, &depthBuffer);
+                glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+                glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+                glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            }
+            if (sharedDepth != depthBuffer) {
+                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+                sharedDepth = depthBuffer;
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, target);
+            glBlitFramebuffer(viewport[0], viewport[1], viewport[0] + width, viewport[1] + height,
+                              0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        }
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "WeightedOIT: framebuffer neni kompletni (0x" << std::hex << status << std::dec << ")" << std::endl;
+            glBindFramebuffer(GL_FRAMEBUFFER, target);
+            return false;
+        }
+        return true;
+    }
+
+    // Depth format default framebufferu (24/32 bitu, se stencilem nebo bez)
+    static GLenum TargetDepthFormat() {
+        GLint depthBits = 24, stencilBits = 0;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depthBits);
+        glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencilBits);
+        if (stencilBits > 0) return depthBits > 24 ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+        return depthBits > 24 ? GL_DEPTH_COMPONENT32F : GL_DEPTH_COMPONENT24;
+    }
+
+    GLuint CompositeProgram() {
+        if (!program) {
+            program = ProgramCache::Get().Acquire(R"glsl(#version 330 core
+void main()
+{
+    // full-screen trojuhelnik bez vertex bufferu
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)glsl", R"glsl(#version 330 core
+uniform sampler2D accum;
+uniform sampler2D reveal;
+out vec4 FragColor;
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(reveal, p, 0).r;
+    if (revealage >= 1.0) discard;               // zadny pruhledny fragment
+    vec4 a = texelFetch(accum, p, 0);
+    // pretekly half float (hodne vrstev s velkou vahou) - aspon prumer bez inf
+    if (isinf(max(max(abs(a.r), abs(a.g)), abs(a.b)))) a.rgb = vec3(a.a);
+    FragColor = vec4(a.rgb / max(a.a, 1e-5), 1.0 - revealage);
+}
+)glsl");
+        }
+        return program->id;
+    }
+};
+
+#endif // WEIGHTEDOIT_H
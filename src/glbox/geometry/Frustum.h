@@ -0,0 +1,61 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// =========================================================================================
+// View frustum (6 planes extracted from a view-projection matrix, Gribb/Hartmann)
+// Plane: xyz = normal pointing inside, w = distance
+// =========================================================================================
+class Frustum {
+
+public:
+    glm::vec4 planes[6];
+
+    Frustum() {
+        for (int i = 0; i < 6; ++i) planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    explicit Frustum(const glm::mat4& viewProj) { Update(viewProj); }
+
+    void Update(const glm::mat4& m) {
+        // glm je column-major: radek i = (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        planes[0] = row3 + row0; // left
+        planes[1] = row3 - row0; // right
+        planes[2] = row3 + row1; // bottom
+        planes[3] = row3 - row1; // top
+        planes[4] = row3 + row2; // near
+        planes[5] = row3 - row2; // far
+
+        for (int i = 0; i < 6; ++i) {
+            float len = glm::length(glm::vec3(planes[i]));
+            if (len > 0.0f) planes[i] /= len;
+        }
+    }
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const {
+        for (int i = 0; i < 6; ++i) {
+            if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius) return false;
+        }
+        return true;
+    }
+
+    bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+        for (int i = 0; i < 6; ++i) {
+            const glm::vec3 n(planes[i]);
+            // "positive vertex" - roh boxu nejdal ve smeru normaly
+            glm::vec3 p(n.x >= 0.0f ? max.x : min.x,
+                        n.y >= 0.0f ? max.y : min.y,
+                        n.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(n, p) + planes[i].w < 0.0f) return false;
+        }
+        return true;
+    }
+};
+
+#endif // FRUSTUM_H
@@ -22,6 +22,8 @@ public:
     {
         vertices.clear();
         indices.clear();
+        vertices.reserve(size_t(segX + 1) * (segZ + 1) * 8);
+        indices.reserve(size_t(segX) * segZ * 6);
 
         float halfW = width * 0.5f;
         float halfD = depth * 0.5f;
@@ -79,6 +81,8 @@ public:
     {
         vertices.clear();
         indices.clear();
+        vertices.reserve(size_t(rings) * sectors * 8);
+        indices.reserve(size_t(rings - 1) * (sectors - 1) * 6);
 
         const float R = 1.0f / (rings - 1);
         const float S = 1.0f / (sectors - 1);
@@ -132,6 +136,8 @@ public:
     {
         vertices.clear();
         indices.clear();
+        vertices.reserve(24 * 8);
+        indices.reserve(36);
 
         float h = size * 0.5f;
 
@@ -202,6 +208,8 @@ public:
     {
         vertices.clear();
         indices.clear();
+        vertices.reserve(24 * 8);
+        indices.reserve(36);
 
         glm::vec3 c[8] = {
             {-orthoSize, -orthoSize, -nearPlane}, // 0
@@ -0,0 +1,279 @@
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <glad/glad.h>
+#include "IndexData.h"
+
+// Umisteni jedne geometrie v arene (v jednotkach vertexu / indexu, ne bajtu)
+struct ArenaRange {
+    GLint baseVertex = 0;          // pricita se k indexum pri drawu (indexy zustavaji lokalni)
+    GLuint vertexCount = 0;
+    GLuint firstIndex = 0;
+    GLuint indexCount = 0;
+};
+
+// =========================================================================================
+// First-fit sub-alokator nad souvislym rozsahem [0, capacity); volne bloky se pri
+// uvolneni slucuji se sousedy, takze se arena nefragmentuje pri prestavbe meshlet variant
+// =========================================================================================
+class RangeAllocator {
+
+public:
+    GLuint Capacity() const { return capacity; }
+    GLuint Used() const { return used; }
+
+    bool Allocate(GLuint count, GLuint& offset) {
+        if (count == 0) { offset = 0; return true; }
+        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+            if (it->second < count) continue;
+            offset = it->first;
+            GLuint rest = it->second - count;
+            freeBlocks.erase(it);
+            if (rest > 0) freeBlocks.emplace(offset + count, rest);
+            used += count;
+            return true;
+        }
+        return false;
+    }
+
+    void Free(GLuint offset, GLuint count) {
+        if (count == 0) return;
+        used -= count;
+        auto next = freeBlocks.lower_bound(offset);
+        if (next != freeBlocks.end() && offset + count == next->first) {
+            count += next->second;
+            next = freeBlocks.erase(next);
+        }
+        if (next != freeBlocks.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += count;
+                return;
+            }
+        }
+        freeBlocks.emplace(offset, count);
+    }
+
+    // Prida volny blok na konec (po zvetseni bufferu)
+    void Grow(GLuint newCapacity) {
+        if (newCapacity <= capacity) return;
+        GLuint oldCapacity = capacity;
+        capacity = newCapacity;
+        used += newCapacity - oldCapacity;
+        Free(oldCapacity, newCapacity - oldCapacity);
+    }
+
+private:
+    std::map<GLuint, GLuint> freeBlocks;   // offset -> delka
+    GLuint capacity = 0;
+    GLuint used = 0;
+};
+
+// =========================================================================================
+// Geometry arena: jeden velky VBO + EBO pro kazdy format vertexu (a typ indexu) a jedno
+// sdilene VAO. Meshe dostanou jen rozsah (baseVertex / firstIndex), takze vsechny
+// draw cally jednoho formatu bezi nad stejnym VAO a daji se poslat jednim
+// glMultiDrawElementsIndirect. Pri zaplneni se buffer zdvojnasobi (glCopyNamedBufferSubData),
+// VAO zustava stejne - jen se do nej prepoji novy buffer. Vyzaduje DSA (GL 4.5).
+// =========================================================================================
+class GeometryArena {
+
+public:
+    struct Stats {
+        size_t vertexCapacity = 0, vertexUsed = 0;    // ve vertexech
+        size_t indexCapacity = 0, indexUsed = 0;      // v indexech
+        size_t bytes = 0;                             // velikost VBO + EBO
+        unsigned int allocations = 0;                 // zive rozsahy
+        unsigned int grows = 0;
+    };
+
+    static constexpr GLuint INITIAL_VERTICES = 1u << 16;
+    static constexpr GLuint INITIAL_INDICES = 1u << 18;
+
+    // vypnuto = kazda nova geometrie dostane vlastni VAO/VBO/EBO (puvodni cesta)
+    inline static bool enabled = true;
+
+    static bool Supported() { return GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access; }
+
+    // Arena pro dany layout (velikosti atributu ve floatech, location = poradi) a typ indexu.
+    // Areny se nikdy nerusi - GpuGeometry v nich uvolnuje rozsahy i pri statickem uklidu
+    static GeometryArena* For(const std::vector<GLint>& attribSizes, GLenum indexType) {
+        if (!enabled || !Supported()) return nullptr;
+        for (GeometryArena* a : All())
+            if (a->attribSizes == attribSizes && a->indexType == indexType) return a;
+        All().push_back(new GeometryArena(attribSizes, indexType));
+        return All().back();
+    }
+
+    // Layout StaticMesh / ParallelGeometry: P3 N3 UV2 T3
+    static GeometryArena* ForStaticMesh(GLenum indexType) {
+        return For({3, 3, 2, 3}, indexType);
+    }
+
+    GLuint VAO() const { return vao; }
+    GLenum IndexType() const { return indexType; }
+    int Stride() const { return stride; }
+    size_t IndexSize() const { return IndexData::TypeSize(indexType); }
+
+    // Rezervuje misto; pri nedostatku buffer zvetsi
+    ArenaRange Allocate(GLuint vertexCount, GLuint indexCount) {
+        ArenaRange r;
+        GLuint vertexOffset = 0, indexOffset = 0;
+        while (!vertexAlloc.Allocate(vertexCount, vertexOffset))
+            GrowVertices(vertexCount);
+        while (!indexAlloc.Allocate(indexCount, indexOffset))
+            GrowIndices(indexCount);
+        r.baseVertex = static_cast<GLint>(vertexOffset);
+        r.vertexCount = vertexCount;
+        r.firstIndex = indexOffset;
+        r.indexCount = indexCount;
+        stats.allocations++;
+        return r;
+    }
+
+    void Free(const ArenaRange& r) {
+        vertexAlloc.Free(static_cast<GLuint>(r.baseVertex), r.vertexCount);
+        indexAlloc.Free(r.firstIndex, r.indexCount);
+        if (stats.allocations > 0) stats.allocations--;
+    }
+
+    // vertices: vertexCount * Stride() floatu; indices: lokalni indexy typu IndexType()
+    void Upload(const ArenaRange& r, const float* vertices, const void* indices) {
+        glNamedBufferSubData(vbo, VertexOffset(r), VertexBytes(r), vertices);
+        glNamedBufferSubData(ebo, IndexOffset(r), IndexBytes(r), indices);
+    }
+
+    // Primy zapis rozsahu (ParallelGeometry); nullptr = mapovani selhalo
+    float* MapVertices(const ArenaRange& r) {
+        return static_cast<float*>(glMapNamedBufferRange(vbo, VertexOffset(r), VertexBytes(r), MAP_WRITE));
+    }
+    void* MapIndices(const ArenaRange& r) {
+        return glMapNamedBufferRange(ebo, IndexOffset(r), IndexBytes(r), MAP_WRITE);
+    }
+    // GL_FALSE pokud se obsah behem mapovani poskodil
+    bool UnmapVertices() { return glUnmapNamedBuffer(vbo) == GL_TRUE; }
+    bool UnmapIndices() { return glUnmapNamedBuffer(ebo) == GL_TRUE; }
+
+    // Zpetne cteni (EnsureCpuData)
+    void ReadVertices(const ArenaRange& r, float* out) const {
+        glGetNamedBufferSubData(vbo, VertexOffset(r), VertexBytes(r), out);
+    }
+    void ReadIndices(const ArenaRange& r, void* out) const {
+        glGetNamedBufferSubData(ebo, IndexOffset(r), IndexBytes(r), out);
+    }
+
+    Stats GetStats() const {
+        Stats s = stats;
+        s.vertexCapacity = vertexAlloc.Capacity();
+        s.vertexUsed = vertexAlloc.Used();
+        s.indexCapacity = indexAlloc.Capacity();
+        s.indexUsed = indexAlloc.Used();
+        s.bytes = static_cast<size_t>(vertexAlloc.Capacity()) * stride * sizeof(float)
+                + static_cast<size_t>(indexAlloc.Capacity()) * IndexSize();
+        return s;
+    }
+
+    // Souhrn vsech aren (ImGui)
+    static Stats TotalStats() {
+        Stats total;
+        for (const GeometryArena* a : All()) {
+            Stats s = a->GetStats();
+            total.vertexCapacity += s.vertexCapacity; total.vertexUsed += s.vertexUsed;
+            total.indexCapacity += s.indexCapacity; total.indexUsed += s.indexUsed;
+            total.bytes += s.bytes; total.allocations += s.allocations; total.grows += s.grows;
+        }
+        return total;
+    }
+
+private:
+    static constexpr GLbitfield STORAGE_FLAGS = GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT | GL_MAP_READ_BIT;
+    static constexpr GLbitfield MAP_WRITE = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+    std::vector<GLint> attribSizes;
+    GLenum indexType;
+    int stride = 0;
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    RangeAllocator vertexAlloc, indexAlloc;
+    Stats stats;
+
+    GeometryArena(const std::vector<GLint>& sizes, GLenum type)
+        : attribSizes(sizes), indexType(type)
+    {
+        for (GLint s : attribSizes) stride += s;
+
+        glCreateVertexArrays(1, &vao);
+        GLuint offset = 0;
+        for (GLuint i = 0; i < attribSizes.size(); ++i) {
+            glEnableVertexArrayAttrib(vao, i);
+            glVertexArrayAttribFormat(vao, i, attribSizes[i], GL_FLOAT, GL_FALSE, offset * sizeof(float));
+            glVertexArrayAttribBinding(vao, i, 0);
+            offset += attribSizes[i];
+        }
+
+        vbo = CreateStorage(static_cast<GLsizeiptr>(INITIAL_VERTICES) * stride * sizeof(float));
+        ebo = CreateStorage(static_cast<GLsizeiptr>(INITIAL_INDICES) * IndexSize());
+        glVertexArrayVertexBuffer(vao, 0, vbo, 0, stride * sizeof(float));
+        glVertexArrayElementBuffer(vao, ebo);
+        vertexAlloc.Grow(INITIAL_VERTICES);
+        indexAlloc.Grow(INITIAL_INDICES);
+    }
+
+    static std::vector<GeometryArena*>& All() {
+        static auto* arenas = new std::vector<GeometryArena*>();
+        return *arenas;
+    }
+
+    GLintptr VertexOffset(const ArenaRange& r) const {
+        return static_cast<GLintptr>(r.baseVertex) * stride * sizeof(float);
+    }
+    GLsizeiptr VertexBytes(const ArenaRange& r) const {
+        return static_cast<GLsizeiptr>(r.vertexCount) * stride * sizeof(float);
+    }
+    GLintptr IndexOffset(const ArenaRange& r) const {
+        return static_cast<GLintptr>(r.firstIndex) * IndexSize();
+    }
+    GLsizeiptr IndexBytes(const ArenaRange& r) const {
+        return static_cast<GLsizeiptr>(r.indexCount) * IndexSize();
+    }
+
+    static GLuint CreateStorage(GLsizeiptr bytes) {
+        GLuint buffer = 0;
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, bytes, nullptr, STORAGE_FLAGS);
+        return buffer;
+    }
+
+    // Novy (vetsi) buffer + kopie obsahu na GPU; stary se smaze
+    static GLuint Regrow(GLuint old, GLsizeiptr oldBytes, GLsizeiptr newBytes) {
+        GLuint buffer = CreateStorage(newBytes);
+        glCopyNamedBufferSubData(old, buffer, 0, 0, oldBytes);
+        glDeleteBuffers(1, &old);
+        return buffer;
+    }
+
+    void GrowVertices(GLuint needed) {
+        GLuint oldCap = vertexAlloc.Capacity();
+        GLuint newCap = std::max(oldCap * 2, oldCap + needed);
+        GLsizeiptr vertexSize = static_cast<GLsizeiptr>(stride) * sizeof(float);
+        vbo = Regrow(vbo, oldCap * vertexSize, newCap * vertexSize);
+        glVertexArrayVertexBuffer(vao, 0, vbo, 0, static_cast<GLsizei>(vertexSize));
+        vertexAlloc.Grow(newCap);
+        stats.grows++;
+    }
+
+    void GrowIndices(GLuint needed) {
+        GLuint oldCap = indexAlloc.Capacity();
+        GLuint newCap = std::max(oldCap * 2, oldCap + needed);
+        GLsizeiptr indexSize = static_cast<GLsizeiptr>(IndexSize());
+        ebo = Regrow(ebo, oldCap * indexSize, newCap * indexSize);
+        glVertexArrayElementBuffer(vao, ebo);
+        indexAlloc.Grow(newCap);
+        stats.grows++;
+    }
+};
+
+#endif // GEOMETRYARENA_H
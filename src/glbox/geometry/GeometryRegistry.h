@@ -0,0 +1,389 @@
+#ifndef GEOMETRYREGISTRY_H
+#define GEOMETRYREGISTRY_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <initializer_list>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <glad/glad.h>
+#include "../physics/Raycast.h"
+#include "Meshlet.h"
+#include "IndexData.h"
+#include "GeometryArena.h"
+
+// Co z geometrie zustava v RAM po uploadu
+enum class CpuResidency {
+    KeepAll,         // vertices + indices (default)
+    Release          // nic; data se na vyzadani prectou zpet z GPU (EnsureCpuData)
+};
+
+// Overeni obsahu pro klice z hashe dat: velikosti + druhy, na FNV nezavisly hash.
+// hash == 0 => klic z parametru generatoru, neoveruje se
+struct ContentCheck {
+    size_t vertexBytes = 0, indexBytes = 0;
+    uint64_t hash = 0;
+
+    bool operator==(const ContentCheck& o) const {
+        return vertexBytes == o.vertexBytes && indexBytes == o.indexBytes && hash == o.hash;
+    }
+    bool operator!=(const ContentCheck& o) const { return !(*this == o); }
+};
+
+// =========================================================================================
+// Sdilena GPU geometrie (VAO/VBO/EBO + CPU kopie dat)
+// Vlastni ji shared_ptr - GL objekty se smazou az s poslednim uzivatelem.
+// V arene (arena != nullptr) je VAO sdilene VAO areny, VBO/EBO jsou 0 a data lezi
+// v rozsahu arenaRange - draw cally musi pouzit IndexOffset() a BaseVertex()
+// =========================================================================================
+struct GpuGeometry {
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int indexCount = 0;          // 0 => glDrawArrays(vertexCount)
+    unsigned int vertexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t vertexBytes = 0, indexBytes = 0;
+    uint64_t key = 0;
+    ContentCheck content;                 // zdrojova data klice z obsahu (KeyFromContent)
+    int vertexStride = 0;                 // floatu na vertex ve VBO
+    bool instanceAttribs = false;         // VAO ma pripojene instancni atributy (InstanceBuffer)
+    GeometryArena* arena = nullptr;       // sdileny VBO/EBO (GeometryArena), jinak vlastni buffery
+    ArenaRange arenaRange;
+
+    // CPU data (StaticMesh: stride 11, indices preusporadane po meshletech)
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<Meshlet> meshlets;
+    BoxCollider localAABB;                // zustava vzdy (physics)
+
+    CpuResidency residency = CpuResidency::KeepAll;
+    size_t cpuBytesReleased = 0;          // kolik RAM policy uvolnila oproti KeepAll
+
+    GpuGeometry() = default;
+    GpuGeometry(const GpuGeometry&) = delete;
+    GpuGeometry& operator=(const GpuGeometry&) = delete;
+
+    ~GpuGeometry() {
+        if (arena) {
+            arena->Free(arenaRange);
+            return;
+        }
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+    }
+
+    size_t GpuBytes() const { return vertexBytes + indexBytes; }
+
+    // Offset prvniho indexu v EBO (pro glDraw*Elements) a posun vertexu; mimo arenu 0
+    const void* IndexOffset() const {
+        return reinterpret_cast<const void*>(static_cast<uintptr_t>(arenaRange.firstIndex) * IndexData::TypeSize(indexType));
+    }
+    GLint BaseVertex() const { return arenaRange.baseVertex; }
+
+    // Umisti geometrii (layout StaticMesh, stride 11) do areny; false = arena neni k dispozici
+    bool PlaceInArena(GLenum type) {
+        GeometryArena* a = GeometryArena::ForStaticMesh(type);
+        if (!a || vertexStride != a->Stride()) return false;
+        arena = a;
+        arenaRange = a->Allocate(vertexCount, indexCount);
+        indexType = type;
+        VAO = a->VAO();
+        return true;
+    }
+
+    size_t CpuBytes() const {
+        return vertices.capacity() * sizeof(float) + indices.capacity() * sizeof(unsigned int)
+             + meshlets.capacity() * sizeof(Meshlet);
+    }
+
+    bool HasCpuData() const { return !vertices.empty() || (vertexCount == 0 && indexCount == 0); }
+
+    // Uvolni CPU kopie podle policy. Geometrie je sdilena, plati posledni nastavena policy;
+    // ostatni uzivatele si data kdykoli obnovi pres EnsureCpuData()
+    void SetResidency(CpuResidency policy) {
+        residency = policy;
+        if (policy == CpuResidency::KeepAll) {
+            EnsureCpuData();
+            return;
+        }
+        if (vertices.empty() && indices.empty()) return;
+
+        size_t before = CpuBytes();
+        std::vector<float>().swap(vertices);
+        std::vector<unsigned int>().swap(indices);
+        cpuBytesReleased += before - CpuBytes();
+    }
+
+    // Pokud byla CPU data uvolnena, precte je zpet z VBO/EBO (GL_COPY_READ_BUFFER - bez zmeny VAO)
+    bool EnsureCpuData() {
+        if (HasCpuData()) return true;
+        if ((!VBO && !arena) || vertexStride <= 0) return false;
+
+        vertices.resize(static_cast<size_t>(vertexCount) * vertexStride);
+        if (arena) {
+            arena->ReadVertices(arenaRange, vertices.data());
+            indices.resize(indexCount);
+            if (indexType == GL_UNSIGNED_SHORT) {
+                std::vector<uint16_t> packed(indexCount);
+                arena->ReadIndices(arenaRange, packed.data());
+                for (size_t i = 0; i < packed.size(); ++i) indices[i] = packed[i];
+            } else {
+                arena->ReadIndices(arenaRange, indices.data());
+            }
+            cpuBytesReleased = 0;
+            return true;
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+
+        if (EBO && indices.size() != indexCount) {
+            indices.resize(indexCount);
+            glBindBuffer(GL_COPY_READ_BUFFER, EBO);
+            if (indexType == GL_UNSIGNED_SHORT) {
+                std::vector<uint16_t> packed(indexCount);
+                glGetBufferSubData(GL_COPY_READ_BUFFER, 0, packed.size() * sizeof(uint16_t), packed.data());
+                for (size_t i = 0; i < packed.size(); ++i) indices[i] = packed[i];
+            } else {
+                glGetBufferSubData(GL_COPY_READ_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        cpuBytesReleased = 0;
+        return true;
+    }
+};
+
+using GeometryHandle = std::shared_ptr<GpuGeometry>;
+
+// =========================================================================================
+// Registry: klic (parametry generatoru nebo hash obsahu) -> weak_ptr na GpuGeometry
+// Stejna data = jedna alokace, dalsi Acquire jen zvysi ref count
+// =========================================================================================
+class GeometryRegistry {
+
+public:
+    using Builder = std::function<void(GpuGeometry&)>;
+
+    struct Stats {
+        size_t uploads = 0;          // unikatni alokace
+        size_t hits = 0;             // Acquire vyrizene z cache
+        size_t collisions = 0;       // shodny klic, jiny obsah (ContentCheck)
+        size_t bytesUploaded = 0;
+        size_t bytesSaved = 0;       // bajty, ktere by se jinak nahraly znovu
+        double uploadMs = 0.0;       // cas builderu (vypocet + glBufferData)
+    };
+
+    static GeometryRegistry& Get() {
+        static GeometryRegistry instance;
+        return instance;
+    }
+
+    // Vrati existujici geometrii pro klic, jinak ji vytvori pres builder
+    GeometryHandle Acquire(uint64_t key, const Builder& build) {
+        return Acquire(key, ContentCheck(), build);
+    }
+
+    // Klic z obsahu: zasah se pouzije jen se shodnym ContentCheck, pri kolizi se klic
+    // presoli hashem obsahu a hleda se dal (kolidujici data tak dostanou vlastni zaznam).
+    // Expirovany zaznam retezec nekonci - ziva shoda muze lezet dal, jeho slot se pouzije
+    // az kdyz zadna neni.
+    GeometryHandle Acquire(uint64_t key, const ContentCheck& check, const Builder& build) {
+        const uint64_t salt = check.hash ^ check.vertexBytes ^ (static_cast<uint64_t>(check.indexBytes) << 32);
+        bool haveFreeSlot = false;
+        uint64_t freeSlot = 0;
+        for (auto it = entries.find(key); it != entries.end(); it = entries.find(key)) {
+            GeometryHandle existing = it->second.lock();
+            if (!existing) {
+                if (!haveFreeSlot) {
+                    haveFreeSlot = true;
+                    freeSlot = key;
+                }
+            } else if (existing->content == check) {
+                stats.hits++;
+                stats.bytesSaved += existing->GpuBytes();
+                return existing;
+            } else {
+                stats.collisions++;
+            }
+            key = Combine(key, salt);
+        }
+        if (haveFreeSlot) key = freeSlot;
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        GeometryHandle geo = std::make_shared<GpuGeometry>();
+        geo->key = key;
+        geo->content = check;
+        build(*geo);
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        stats.uploads++;
+        stats.bytesUploaded += geo->GpuBytes();
+        stats.uploadMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        entries[key] = geo;
+        return geo;
+    }
+
+    GeometryHandle Find(uint64_t key) const {
+        auto it = entries.find(key);
+        return it != entries.end() ? it->second.lock() : nullptr;
+    }
+
+    // Pocet zivych alokaci a jejich velikost na GPU (zaroven uklidi expirovane zaznamy)
+    size_t LiveCount() { Prune(); return entries.size(); }
+
+    size_t LiveBytes() {
+        Prune();
+        size_t total = 0;
+        for (auto& e : entries)
+            if (GeometryHandle g = e.second.lock()) total += g->GpuBytes();
+        return total;
+    }
+
+    // RAM drzena geometrii a kolik z ni uvolnily residency policy
+    size_t LiveCpuBytes() {
+        Prune();
+        size_t total = 0;
+        for (auto& e : entries)
+            if (GeometryHandle g = e.second.lock()) total += g->CpuBytes();
+        return total;
+    }
+
+    size_t ReleasedCpuBytes() {
+        Prune();
+        size_t total = 0;
+        for (auto& e : entries)
+            if (GeometryHandle g = e.second.lock()) total += g->cpuBytesReleased;
+        return total;
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    // =========================================================================================
+    // KLICE (FNV-1a 64)
+    // =========================================================================================
+    static constexpr uint64_t FNV_OFFSET = 1469598103934665603ull;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    static uint64_t Hash(const void* data, size_t bytes, uint64_t h = FNV_OFFSET) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            h ^= p[i];
+            h *= FNV_PRIME;
+        }
+        return h;
+    }
+
+    static uint64_t Hash(const char* str, uint64_t h = FNV_OFFSET) {
+        return Hash(str, std::strlen(str), h);
+    }
+
+    static uint64_t Combine(uint64_t h, uint64_t value) {
+        return Hash(&value, sizeof(value), h);
+    }
+
+    // Klic z generatoru: napr. KeyFromParams("sphere", {0.5f, 32, 32})
+    static uint64_t KeyFromParams(const char* generator, std::initializer_list<float> params) {
+        uint64_t h = Hash(generator);
+        for (float p : params) h = Hash(&p, sizeof(p), h);
+        return h;
+    }
+
+    // Klic z obsahu; layout rozlisuje stejna data s jinym formatem vertexu
+    static uint64_t KeyFromContent(const char* layout,
+                                   const std::vector<float>& vertices,
+                                   const std::vector<unsigned int>& indices) {
+        uint64_t h = Hash(layout);
+        h = Combine(h, vertices.size());
+        h = Hash(vertices.data(), vertices.size() * sizeof(float), h);
+        h = Combine(h, indices.size());
+        h = Hash(indices.data(), indices.size() * sizeof(unsigned int), h);
+        return h;
+    }
+
+    // Overeni ke KeyFromContent: velikosti dat + hash po 64bit slovech se splitmix64 mixem
+    // (jiny algoritmus nez FNV klice, kolize obou naraz je prakticky vyloucena)
+    static ContentCheck CheckFromContent(const std::vector<float>& vertices,
+                                         const std::vector<unsigned int>& indices) {
+        ContentCheck c;
+        c.vertexBytes = vertices.size() * sizeof(float);
+        c.indexBytes = indices.size() * sizeof(unsigned int);
+        c.hash = MixHash(indices.data(), c.indexBytes, MixHash(vertices.data(), c.vertexBytes, 0x9E3779B97F4A7C15ull));
+        if (c.hash == 0) c.hash = 1;
+        return c;
+    }
+
+    static uint64_t Mix64(uint64_t x) {
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27; x *= 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    static uint64_t MixHash(const void* data, size_t bytes, uint64_t h) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, p + i, 8);
+            h = Mix64(h ^ word) + i;
+        }
+        uint64_t tail = 0;
+        if (i < bytes) std::memcpy(&tail, p + i, bytes - i);
+        return Mix64(h ^ tail ^ bytes);
+    }
+
+    // =========================================================================================
+    // SDILENE PRIMITIVY
+    // =========================================================================================
+
+    // Kostka +-1, jen pozice (location 0), 36 vertexu bez indexu - skyboxy, cubemap capture
+    GeometryHandle SkyCube() {
+        return Acquire(KeyFromParams("skycube", {1.0f}), [](GpuGeometry& g) {
+            static const float skyboxVertices[] = {
+                -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
+                1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+                -1.0f, -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+                -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
+                1.0f, -1.0f, -1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,  1.0f,
+                1.0f,  1.0f,  1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
+                -1.0f, -1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,  1.0f,  1.0f,
+                1.0f,  1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
+                -1.0f,  1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f,  1.0f,  1.0f,
+                1.0f,  1.0f,  1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f, -1.0f,
+                -1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,
+                1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f,  1.0f
+            };
+
+            g.vertexCount = 36;
+            g.vertexStride = 3;
+            g.vertexBytes = sizeof(skyboxVertices);
+
+            glGenVertexArrays(1, &g.VAO);
+            glGenBuffers(1, &g.VBO);
+            glBindVertexArray(g.VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, g.VBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), skyboxVertices, GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            glBindVertexArray(0);
+        });
+    }
+
+private:
+    std::unordered_map<uint64_t, std::weak_ptr<GpuGeometry>> entries;
+    Stats stats;
+
+    GeometryRegistry() = default;
+
+    void Prune() {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.expired()) it = entries.erase(it);
+            else ++it;
+        }
+    }
+};
+
+#endif // GEOMETRYREGISTRY_H
@@ -0,0 +1,60 @@
+#ifndef INDEXDATA_H
+#define INDEXDATA_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+// =========================================================================================
+// Index buffer s automatickou sirkou: uint16 pokud vertexCount <= 65536, jinak uint32
+// =========================================================================================
+struct IndexData {
+    GLenum type = GL_UNSIGNED_INT;
+    std::vector<uint16_t> u16;
+    std::vector<uint32_t> u32;
+
+    static GLenum TypeFor(size_t vertexCount) {
+        return vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    static size_t TypeSize(GLenum indexType) {
+        return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    static IndexData FromIndices(const std::vector<unsigned int>& indices, size_t vertexCount) {
+        IndexData out;
+        out.Assign(indices, vertexCount);
+        return out;
+    }
+
+    void Assign(const std::vector<unsigned int>& indices, size_t vertexCount) {
+        type = TypeFor(vertexCount);
+        u16.clear(); u32.clear();
+        if (type == GL_UNSIGNED_SHORT) {
+            u16.resize(indices.size());
+            for (size_t i = 0; i < indices.size(); ++i) u16[i] = static_cast<uint16_t>(indices[i]);
+        } else {
+            u32.assign(indices.begin(), indices.end());
+        }
+    }
+
+    size_t Count() const { return type == GL_UNSIGNED_SHORT ? u16.size() : u32.size(); }
+    size_t ElementSize() const { return TypeSize(type); }
+    size_t Bytes() const { return Count() * ElementSize(); }
+    const void* Data() const {
+        return type == GL_UNSIGNED_SHORT ? static_cast<const void*>(u16.data()) : static_cast<const void*>(u32.data());
+    }
+
+    unsigned int operator[](size_t i) const {
+        return type == GL_UNSIGNED_SHORT ? u16[i] : u32[i];
+    }
+
+    std::vector<unsigned int> ToUInt() const {
+        std::vector<unsigned int> out(Count());
+        for (size_t i = 0; i < out.size(); ++i) out[i] = (*this)[i];
+        return out;
+    }
+};
+
+#endif // INDEXDATA_H
@@ -0,0 +1,328 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cfloat>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+
+// =========================================================================================
+// Meshlet = cluster max 64 unikatnich vertexu / 124 trojuhelniku
+// Trojuhelniky meshletu lezi souvisle v preusporadanem index bufferu
+// (firstIndex .. firstIndex + triangleCount * 3), takze jde kreslit pres glMultiDrawElements.
+// =========================================================================================
+struct Meshlet {
+    unsigned int firstIndex = 0;
+    unsigned int triangleCount = 0;
+    unsigned int vertexCount = 0;
+
+    // bounding sphere (local space)
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+
+    // normal cone (local space); coneCutoff >= 1.0 = kuzel se nepouziva
+    glm::vec3 coneApex = glm::vec3(0.0f);
+    glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    float coneCutoff = 1.0f;
+};
+
+// =========================================================================================
+// Vysledek cullingu: kompaktni seznam pro glMultiDrawElements
+// =========================================================================================
+struct MeshletDrawList {
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;      // glMultiDrawElementsBaseVertex (geometrie v arene)
+
+    unsigned int trianglesTotal = 0;
+    unsigned int trianglesSubmitted = 0;
+    unsigned int culledByFrustum = 0;
+    unsigned int culledByCone = 0;
+
+    void Clear() {
+        counts.clear(); offsets.clear(); baseVertices.clear();
+        trianglesTotal = trianglesSubmitted = 0;
+        culledByFrustum = culledByCone = 0;
+    }
+    GLsizei DrawCount() const { return static_cast<GLsizei>(counts.size()); }
+};
+
+// Globalni pocitadla (reset jednou za frame, zobrazeni v ImGui)
+struct MeshletStats {
+    inline static unsigned int trianglesTotal = 0;
+    inline static unsigned int trianglesSubmitted = 0;
+    inline static unsigned int meshletsTotal = 0;
+    inline static unsigned int meshletsCulled = 0;
+
+    static void Reset() { trianglesTotal = trianglesSubmitted = meshletsTotal = meshletsCulled = 0; }
+    static void Add(const MeshletDrawList& list, size_t meshletCount) {
+        trianglesTotal += list.trianglesTotal;
+        trianglesSubmitted += list.trianglesSubmitted;
+        meshletsTotal += static_cast<unsigned int>(meshletCount);
+        meshletsCulled += list.culledByFrustum + list.culledByCone;
+    }
+    // mesh kresleny bez meshletu (jedno glDrawElements)
+    static void AddUnclustered(unsigned int triangles) {
+        trianglesTotal += triangles;
+        trianglesSubmitted += triangles;
+    }
+};
+
+class MeshletBuilder {
+
+public:
+    static constexpr unsigned int MAX_VERTICES = 64;
+    static constexpr unsigned int MAX_TRIANGLES = 124;
+
+    // vertices: pozice na offsetu 0 (normala na offsetu 3 pokud stride >= 6), 'stride' floatu na vertex
+    // indices se preusporadaji do poradi meshletu (in-place)
+    static std::vector<Meshlet> Build(const std::vector<float>& vertices, int stride,
+                                      std::vector<unsigned int>& indices)
+    {
+        std::vector<Meshlet> meshlets;
+        if (stride < 3 || vertices.empty() || indices.size() < 3) return meshlets;
+
+        const size_t numVertices = vertices.size() / stride;
+        const size_t numTriangles = indices.size() / 3;
+
+        // adjacency vertex -> trojuhelniky (CSR)
+        std::vector<unsigned int> adjOffset(numVertices + 1, 0);
+        std::vector<unsigned int> adjTris;
+        std::vector<bool> emitted(numTriangles, false);
+        for (size_t t = 0; t < numTriangles; ++t) {
+            bool valid = true;
+            for (int k = 0; k < 3; ++k) valid = valid && indices[t * 3 + k] < numVertices;
+            if (!valid) { emitted[t] = true; continue; }
+            for (int k = 0; k < 3; ++k) adjOffset[indices[t * 3 + k] + 1]++;
+        }
+        for (size_t v = 0; v < numVertices; ++v) adjOffset[v + 1] += adjOffset[v];
+        adjTris.resize(adjOffset[numVertices]);
+        {
+            std::vector<unsigned int> fill(adjOffset.begin(), adjOffset.end() - 1);
+            for (size_t t = 0; t < numTriangles; ++t) {
+                if (emitted[t]) continue;
+                for (int k = 0; k < 3; ++k) adjTris[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+            }
+        }
+
+        // marker: do ktereho meshletu byl vertex naposled pridan
+        std::vector<unsigned int> vertexMark(numVertices, ~0u);
+        std::vector<unsigned int> meshletVerts;
+        std::vector<unsigned int> ordered;
+        ordered.reserve(numTriangles * 3);
+
+        Meshlet current;
+        unsigned int currentId = 0;
+        size_t seed = 0;
+
+        auto newVertexCount = [&](size_t t) {
+            unsigned int a = indices[t * 3 + 0], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+            unsigned int n = 0;
+            if (vertexMark[a] != currentId) ++n;
+            if (vertexMark[b] != currentId && b != a) ++n;
+            if (vertexMark[c] != currentId && c != a && c != b) ++n;
+            return n;
+        };
+
+        auto flush = [&]() {
+            if (current.triangleCount == 0) return;
+            ComputeBounds(current, vertices, stride, ordered);
+            meshlets.push_back(current);
+            current = Meshlet();
+            current.firstIndex = static_cast<unsigned int>(ordered.size());
+            meshletVerts.clear();
+            ++currentId;
+        };
+
+        for (;;) {
+            // 1) kandidat sousedici s aktualnim meshletem (nejmene novych vertexu)
+            size_t best = numTriangles;
+            unsigned int bestNew = 4;
+            for (unsigned int v : meshletVerts) {
+                for (unsigned int a = adjOffset[v]; a < adjOffset[v + 1]; ++a) {
+                    unsigned int t = adjTris[a];
+                    if (emitted[t]) continue;
+                    unsigned int n = newVertexCount(t);
+                    if (n < bestNew) { bestNew = n; best = t; }
+                }
+                if (bestNew == 0) break;
+            }
+            // 2) jinak dalsi nepouzity trojuhelnik v poradi
+            if (best == numTriangles) {
+                while (seed < numTriangles && emitted[seed]) ++seed;
+                if (seed == numTriangles) break;
+                best = seed;
+                bestNew = newVertexCount(best);
+            }
+
+            if (current.vertexCount + bestNew > MAX_VERTICES || current.triangleCount + 1 > MAX_TRIANGLES) {
+                flush();
+                continue; // znovu vybrat - novy meshlet zacina od seedu
+            }
+
+            emitted[best] = true;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int vi = indices[best * 3 + k];
+                if (vertexMark[vi] != currentId) {
+                    vertexMark[vi] = currentId;
+                    meshletVerts.push_back(vi);
+                }
+                ordered.push_back(vi);
+            }
+            current.vertexCount += bestNew;
+            current.triangleCount++;
+        }
+        flush();
+
+        indices = std::move(ordered);
+        return meshlets;
+    }
+
+    // Bounding sphere + normalovy kuzel (apex/axis/cutoff jako v meshoptimizeru)
+    static void ComputeBounds(Meshlet& m, const std::vector<float>& vertices, int stride,
+                              const std::vector<unsigned int>& indices)
+    {
+        auto pos = [&](unsigned int i) { return glm::vec3(vertices[i * stride + 0], vertices[i * stride + 1], vertices[i * stride + 2]); };
+
+        const unsigned int first = m.firstIndex;
+        const unsigned int count = m.triangleCount * 3;
+
+        // --- sphere: stred AABB + max vzdalenost ---
+        glm::vec3 bmin(FLT_MAX), bmax(-FLT_MAX);
+        for (unsigned int i = first; i < first + count; ++i) {
+            glm::vec3 p = pos(indices[i]);
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+        m.center = (bmin + bmax) * 0.5f;
+        float r2 = 0.0f;
+        for (unsigned int i = first; i < first + count; ++i) {
+            glm::vec3 d = pos(indices[i]) - m.center;
+            r2 = std::max(r2, glm::dot(d, d));
+        }
+        m.radius = std::sqrt(r2);
+
+        // --- normal cone ---
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> corners;
+        normals.reserve(m.triangleCount);
+        corners.reserve(m.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (unsigned int t = 0; t < m.triangleCount; ++t) {
+            glm::vec3 p0 = pos(indices[first + t * 3 + 0]);
+            glm::vec3 p1 = pos(indices[first + t * 3 + 1]);
+            glm::vec3 p2 = pos(indices[first + t * 3 + 2]);
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len <= 0.0f) continue; // degenerovany trojuhelnik
+            n /= len;
+            // winding v generatorech neni jednotny -> orientace podle vertex normal (offset 3)
+            if (stride >= 6) {
+                glm::vec3 vn(0.0f);
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int vi = indices[first + t * 3 + k];
+                    vn += glm::vec3(vertices[vi * stride + 3], vertices[vi * stride + 4], vertices[vi * stride + 5]);
+                }
+                if (glm::dot(n, vn) < 0.0f) n = -n;
+            }
+            normals.push_back(n);
+            corners.push_back(p0);
+            axis += n;
+        }
+
+        m.coneCutoff = 1.0f;
+        m.coneApex = m.center;
+        float axisLen = glm::length(axis);
+        if (normals.empty() || axisLen <= 0.0f) return;
+        axis /= axisLen;
+        m.coneAxis = axis;
+
+        float minDot = 1.0f;
+        for (const auto& n : normals) minDot = std::min(minDot, glm::dot(n, axis));
+
+        // kuzel sirsi nez ~84 stupnu nema smysl testovat
+        if (minDot <= 0.1f) return;
+
+        float maxT = 0.0f;
+        for (size_t i = 0; i < normals.size(); ++i) {
+            float dc = glm::dot(m.center - corners[i], normals[i]);
+            float dn = glm::dot(axis, normals[i]);
+            float t = dc / dn;
+            maxT = std::max(maxT, t);
+        }
+        m.coneApex = m.center - axis * maxT;
+        m.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+};
+
+// =========================================================================================
+// CPU culling (bez GL - testovatelne samostatne)
+// =========================================================================================
+class MeshletCuller {
+
+public:
+    // Vraci true, pokud je meshlet viditelny (world space data na vstupu).
+    // normalMatrix = inverse-transpose(mat3(model)) - osa kuzele je smer normal, pri
+    // neuniformnim meritku ji mat3(model) natoci spatne.
+    static bool IsVisible(const Meshlet& m, const glm::mat4& model, const glm::mat3& normalMatrix,
+                          float maxScale, const Frustum& frustum, const glm::vec3& cameraPos,
+                          bool& culledByCone)
+    {
+        culledByCone = false;
+        glm::vec3 center = glm::vec3(model * glm::vec4(m.center, 1.0f));
+        float radius = m.radius * maxScale;
+
+        if (!frustum.IntersectsSphere(center, radius)) return false;
+
+        if (m.coneCutoff < 1.0f) {
+            glm::vec3 apex = glm::vec3(model * glm::vec4(m.coneApex, 1.0f));
+            glm::vec3 axis = glm::normalize(normalMatrix * m.coneAxis);
+            glm::vec3 toApex = apex - cameraPos;
+            float dist = glm::length(toApex);
+            if (dist > 0.0f && glm::dot(toApex / dist, axis) >= m.coneCutoff) {
+                culledByCone = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Naplni 'out' kompaktnim seznamem (count/offset) pro glMultiDrawElements; firstIndex = zacatek v EBO areny
+    static void Cull(const std::vector<Meshlet>& meshlets, const glm::mat4& model,
+                     const glm::mat4& viewProj, const glm::vec3& cameraPos,
+                     size_t indexSize, MeshletDrawList& out, size_t firstIndex = 0)
+    {
+        out.Clear();
+        Frustum frustum(viewProj);
+        const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+        float maxScale = std::max(glm::length(glm::vec3(model[0])),
+                                  std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+        for (const Meshlet& m : meshlets) {
+            out.trianglesTotal += m.triangleCount;
+            bool byCone = false;
+            if (!IsVisible(m, model, normalMatrix, maxScale, frustum, cameraPos, byCone)) {
+                if (byCone) out.culledByCone++; else out.culledByFrustum++;
+                continue;
+            }
+
+            // sousedni viditelne meshlety slijeme do jednoho rozsahu
+            uintptr_t offset = static_cast<uintptr_t>(firstIndex + m.firstIndex) * indexSize;
+            GLsizei count = static_cast<GLsizei>(m.triangleCount * 3);
+            if (!out.counts.empty() &&
+                reinterpret_cast<uintptr_t>(out.offsets.back()) + out.counts.back() * indexSize == offset) {
+                out.counts.back() += count;
+            } else {
+                out.counts.push_back(count);
+                out.offsets.push_back(reinterpret_cast<const void*>(offset));
+            }
+            out.trianglesSubmitted += m.triangleCount;
+        }
+    }
+};
+
+#endif // MESHLET_H
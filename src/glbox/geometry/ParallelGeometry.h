@@ -0,0 +1,359 @@
+#ifndef PARALLELGEOMETRY_H
+#define PARALLELGEOMETRY_H
+
+#include <vector>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "../../../libs/ThreadPool.h"
+#include "Geometry.h"
+#include "IndexData.h"
+#include "GeometryRegistry.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLBOX_PARALLEL_GEOMETRY_SSE 1
+#include <emmintrin.h>
+#endif
+
+// =========================================================================================
+// Procedural generatory s predem spoctenou velikosti vystupu
+// Radky (z / ring) se plni paralelne na ThreadPool, bez push_back a realokaci.
+// Vystup je shodny s Geometry::generate* (stride 8), volitelne stride 11 s analytickou tangentou.
+// Radek se sestavi v malem bufferu (L2) a do cile jde non-temporal store: vystup ma stovky MB
+// (4096^2 plane ~1.1 GB se stride 11), bez RFO cteni cile je zapis ~1.25x rychlejsi
+// a generovani je dal omezene jen propustnosti pameti.
+// =========================================================================================
+class ParallelGeometry
+{
+public:
+    static ThreadPool& Pool() {
+        static ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    // fn(rowBegin, rowEnd) pro bloky radku; posledni blok zpracuje volajici vlakno
+    template<class Fn>
+    static void ParallelRows(int rows, Fn&& fn, int minRowsPerTask = 16) {
+        if (rows <= 0) return;
+        ThreadPool& pool = Pool();
+        int tasks = static_cast<int>(pool.numWorkers() + 1) * 4;
+        tasks = std::max(1, std::min(tasks, rows / std::max(1, minRowsPerTask)));
+        if (tasks <= 1) { fn(0, rows); return; }
+
+        int chunk = (rows + tasks - 1) / tasks;
+        std::vector<std::future<void>> pending;
+        pending.reserve(tasks);
+        int begin = 0;
+        for (; begin + chunk < rows; begin += chunk) {
+            int end = begin + chunk;
+            pending.emplace_back(pool.enqueue([&fn, begin, end]() { fn(begin, end); }));
+        }
+        fn(begin, rows);
+        for (auto& f : pending) f.get();
+    }
+
+    // Kopie do cile bez cteni cilovych cache line (_mm_stream_si128); bez SSE2 memcpy
+    static void StreamCopy(void* dst, const void* src, size_t bytes) {
+        char* d = static_cast<char*>(dst);
+        const char* s = static_cast<const char*>(src);
+#ifdef GLBOX_PARALLEL_GEOMETRY_SSE
+        size_t head = std::min(bytes, (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15);
+        std::memcpy(d, s, head);
+        d += head; s += head; bytes -= head;
+        for (; bytes >= 16; bytes -= 16, d += 16, s += 16)
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+#endif
+        std::memcpy(d, s, bytes);
+    }
+
+    // Radky [rowBegin, rowEnd) po rowElems prvcich: fill(r, row) naplni radek, StreamCopy ho zapise
+    template<typename T, class FillFn>
+    static void StreamRows(T* dst, size_t rowElems, int rowBegin, int rowEnd, FillFn&& fill) {
+        std::vector<T> row(rowElems);
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            fill(r, row.data());
+            StreamCopy(dst + size_t(r) * rowElems, row.data(), rowElems * sizeof(T));
+        }
+#ifdef GLBOX_PARALLEL_GEOMETRY_SSE
+        _mm_sfence();   // streaming store musi byt viditelny pred dokoncenim tasku / unmapem
+#endif
+    }
+
+    // ===========================================
+    // EXACT SIZES
+    // ===========================================
+    static size_t PlaneVertexCount(int segX, int segZ) { return size_t(segX + 1) * (segZ + 1); }
+    static size_t PlaneIndexCount(int segX, int segZ) { return size_t(segX) * segZ * 6; }
+    static size_t SphereVertexCount(int rings, int sectors) { return size_t(rings) * sectors; }
+    static size_t SphereIndexCount(int rings, int sectors) { return size_t(rings - 1) * (sectors - 1) * 6; }
+
+    // ===========================================
+    // PLANE (stride 8 = P,N,UV nebo 11 = P,N,UV,T)
+    // ===========================================
+    template<typename Index>
+    static void WritePlane(float width, float depth, int segX, int segZ, float tileU, float tileV,
+                           int stride, float* vertices, Index* indices)
+    {
+        const float halfW = width * 0.5f;
+        const float halfD = depth * 0.5f;
+        const float stepX = width / segX;
+        const float stepZ = depth / segZ;
+        const float uvStepX = 1.0f / segX;
+        const float uvStepZ = 1.0f / segZ;
+        const size_t rowVerts = size_t(segX + 1);
+
+        // vertex radky z = 0..segZ
+        ParallelRows(segZ + 1, [=](int zBegin, int zEnd) {
+            StreamRows(vertices, rowVerts * stride, zBegin, zEnd, [=](int z, float* v) {
+                for (int x = 0; x <= segX; x++, v += stride) {
+                    v[0] = -halfW + x * stepX; v[1] = 0.0f; v[2] = -halfD + z * stepZ;
+                    v[3] = 0.0f; v[4] = 1.0f; v[5] = 0.0f;
+                    v[6] = x * uvStepX * tileU; v[7] = z * uvStepZ * tileV;
+                    if (stride >= 11) { v[8] = 1.0f; v[9] = 0.0f; v[10] = 0.0f; }
+                }
+            });
+        });
+
+        // index radky z = 0..segZ-1
+        ParallelRows(segZ, [=](int zBegin, int zEnd) {
+            StreamRows(indices, size_t(segX) * 6, zBegin, zEnd, [=](int z, Index* i) {
+                for (int x = 0; x < segX; x++, i += 6) {
+                    Index v1 = static_cast<Index>(z * rowVerts + x);
+                    Index v2 = v1 + 1;
+                    Index v3 = static_cast<Index>(v1 + rowVerts);
+                    Index v4 = v3 + 1;
+                    i[0] = v1; i[1] = v2; i[2] = v3;
+                    i[3] = v2; i[4] = v4; i[5] = v3;
+                }
+            });
+        });
+    }
+
+    // ===========================================
+    // SPHERE
+    // ===========================================
+    template<typename Index>
+    static void WriteSphere(float radius, int rings, int sectors, int stride, float* vertices, Index* indices)
+    {
+        const float R = 1.0f / (rings - 1);
+        const float S = 1.0f / (sectors - 1);
+
+        ParallelRows(rings, [=](int rBegin, int rEnd) {
+            StreamRows(vertices, size_t(sectors) * stride, rBegin, rEnd, [=](int r, float* v) {
+                for (int s = 0; s < sectors; ++s, v += stride) {
+                    float y = sin(-M_PI / 2 + M_PI * r * R);
+                    float x = cos(2 * M_PI * s * S) * sin(M_PI * r * R);
+                    float z = sin(2 * M_PI * s * S) * sin(M_PI * r * R);
+
+                    v[0] = x * radius; v[1] = y * radius; v[2] = z * radius;
+                    v[3] = x; v[4] = y; v[5] = z;
+                    v[6] = s * S; v[7] = r * R;
+                    if (stride >= 11) {
+                        // dP/du - definovana i na polech
+                        float phi = 2 * M_PI * s * S;
+                        v[8] = -sin(phi); v[9] = 0.0f; v[10] = cos(phi);
+                    }
+                }
+            });
+        }, 8);
+
+        ParallelRows(rings - 1, [=](int rBegin, int rEnd) {
+            StreamRows(indices, size_t(sectors - 1) * 6, rBegin, rEnd, [=](int r, Index* i) {
+                for (int s = 0; s < sectors - 1; ++s, i += 6) {
+                    Index v1 = static_cast<Index>(r * sectors + s);
+                    Index v2 = static_cast<Index>(r * sectors + (s + 1));
+                    Index v3 = static_cast<Index>((r + 1) * sectors + (s + 1));
+                    Index v4 = static_cast<Index>((r + 1) * sectors + s);
+                    i[0] = v1; i[1] = v3; i[2] = v4;
+                    i[3] = v1; i[4] = v2; i[5] = v3;
+                }
+            });
+        }, 8);
+    }
+
+    // ===========================================
+    // CPU VARIANTY (stejne rozhrani jako Geometry)
+    // ===========================================
+    static void generatePlane(float width, float depth, int segX, int segZ,
+                              float tileU, float tileV,
+                              std::vector<float>& vertices,
+                              std::vector<unsigned int>& indices)
+    {
+        vertices.resize(PlaneVertexCount(segX, segZ) * 8);
+        indices.resize(PlaneIndexCount(segX, segZ));
+        WritePlane(width, depth, segX, segZ, tileU, tileV, 8, vertices.data(), indices.data());
+    }
+
+    static void generatePlane(float width, float depth, int segX, int segZ,
+                              float tileU, float tileV,
+                              std::vector<float>& vertices,
+                              IndexData& indices)
+    {
+        size_t vertexCount = PlaneVertexCount(segX, segZ);
+        vertices.resize(vertexCount * 8);
+        indices.type = IndexData::TypeFor(vertexCount);
+        indices.u16.clear(); indices.u32.clear();
+        if (indices.type == GL_UNSIGNED_SHORT) {
+            indices.u16.resize(PlaneIndexCount(segX, segZ));
+            WritePlane(width, depth, segX, segZ, tileU, tileV, 8, vertices.data(), indices.u16.data());
+        } else {
+            indices.u32.resize(PlaneIndexCount(segX, segZ));
+            WritePlane(width, depth, segX, segZ, tileU, tileV, 8, vertices.data(), indices.u32.data());
+        }
+    }
+
+    static void generateSphere(float radius, int rings, int sectors,
+                               std::vector<float>& vertices,
+                               std::vector<unsigned int>& indices)
+    {
+        vertices.resize(SphereVertexCount(rings, sectors) * 8);
+        indices.resize(SphereIndexCount(rings, sectors));
+        WriteSphere(radius, rings, sectors, 8, vertices.data(), indices.data());
+    }
+
+    static void generateSphere(float radius, int rings, int sectors,
+                               std::vector<float>& vertices,
+                               IndexData& indices)
+    {
+        size_t vertexCount = SphereVertexCount(rings, sectors);
+        vertices.resize(vertexCount * 8);
+        indices.type = IndexData::TypeFor(vertexCount);
+        indices.u16.clear(); indices.u32.clear();
+        if (indices.type == GL_UNSIGNED_SHORT) {
+            indices.u16.resize(SphereIndexCount(rings, sectors));
+            WriteSphere(radius, rings, sectors, 8, vertices.data(), indices.u16.data());
+        } else {
+            indices.u32.resize(SphereIndexCount(rings, sectors));
+            WriteSphere(radius, rings, sectors, 8, vertices.data(), indices.u32.data());
+        }
+    }
+
+    // ===========================================
+    // GPU VARIANTY: zapis primo do namapovaneho VBO/EBO (stride 11, layout StaticMesh, GeometryArena)
+    // CPU kopie nevznika (CpuResidency::Release), geometrie je v GeometryRegistry podle parametru
+    // ===========================================
+    static GeometryHandle UploadPlane(float width, float depth, int segX, int segZ, float tileU, float tileV)
+    {
+        uint64_t key = GeometryRegistry::KeyFromParams("plane:P3N3UV2T3",
+                                                       {width, depth, float(segX), float(segZ), tileU, tileV});
+        return GeometryRegistry::Get().Acquire(key, [&](GpuGeometry& g) {
+            g.localAABB = BoxCollider(glm::vec3(-width * 0.5f, 0.0f, -depth * 0.5f),
+                                      glm::vec3(width * 0.5f, 0.0f, depth * 0.5f));
+            UploadMapped(g, PlaneVertexCount(segX, segZ), PlaneIndexCount(segX, segZ),
+                         [&](float* v, auto* i) { WritePlane(width, depth, segX, segZ, tileU, tileV, 11, v, i); });
+        });
+    }
+
+    static GeometryHandle UploadSphere(float radius, int rings, int sectors)
+    {
+        uint64_t key = GeometryRegistry::KeyFromParams("sphere:P3N3UV2T3", {radius, float(rings), float(sectors)});
+        return GeometryRegistry::Get().Acquire(key, [&](GpuGeometry& g) {
+            g.localAABB = BoxCollider(glm::vec3(-radius), glm::vec3(radius));
+            UploadMapped(g, SphereVertexCount(rings, sectors), SphereIndexCount(rings, sectors),
+                         [&](float* v, auto* i) { WriteSphere(radius, rings, sectors, 11, v, i); });
+        });
+    }
+
+private:
+    static constexpr int GPU_STRIDE = 11;
+
+    // Alokuje rozsah v GeometryArena (bez areny vlastni VBO/EBO), namapuje ho
+    // a necha write(float*, Index*) naplnit data (paralelne)
+    template<class WriteFn>
+    static void UploadMapped(GpuGeometry& g, size_t vertexCount, size_t indexCount, WriteFn&& write)
+    {
+        g.vertexStride = GPU_STRIDE;
+        g.vertexCount = static_cast<unsigned int>(vertexCount);
+        g.indexCount = static_cast<unsigned int>(indexCount);
+        g.indexType = IndexData::TypeFor(vertexCount);
+        g.vertexBytes = vertexCount * GPU_STRIDE * sizeof(float);
+        g.indexBytes = indexCount * IndexData::TypeSize(g.indexType);
+        g.residency = CpuResidency::Release;
+
+        if (g.PlaceInArena(g.indexType)) {
+            GeometryArena& arena = *g.arena;
+            float* v = arena.MapVertices(g.arenaRange);
+            void* i = arena.MapIndices(g.arenaRange);
+            bool mapped = v && i;
+            if (mapped) {
+                if (g.indexType == GL_UNSIGNED_SHORT) write(v, static_cast<uint16_t*>(i));
+                else write(v, static_cast<uint32_t*>(i));
+            }
+            if (v) mapped = arena.UnmapVertices() && mapped;
+            if (i) mapped = arena.UnmapIndices() && mapped;
+
+            if (!mapped) {
+                std::cerr << "warn: ParallelGeometry: arena map failed, uploading from RAM" << std::endl;
+                std::vector<float> cpuVertices(vertexCount * GPU_STRIDE);
+                if (g.indexType == GL_UNSIGNED_SHORT) {
+                    std::vector<uint16_t> cpuIndices(indexCount);
+                    write(cpuVertices.data(), cpuIndices.data());
+                    arena.Upload(g.arenaRange, cpuVertices.data(), cpuIndices.data());
+                } else {
+                    std::vector<uint32_t> cpuIndices(indexCount);
+                    write(cpuVertices.data(), cpuIndices.data());
+                    arena.Upload(g.arenaRange, cpuVertices.data(), cpuIndices.data());
+                }
+            }
+            return;
+        }
+
+        glGenVertexArrays(1, &g.VAO);
+        glGenBuffers(1, &g.VBO);
+        glGenBuffers(1, &g.EBO);
+        glBindVertexArray(g.VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, g.VBO);
+        glBufferData(GL_ARRAY_BUFFER, g.vertexBytes, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, g.indexBytes, nullptr, GL_STATIC_DRAW);
+
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+        float* v = static_cast<float*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, g.vertexBytes, access));
+        void* i = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, g.indexBytes, access);
+
+        bool mapped = v && i;
+        if (mapped) {
+            if (g.indexType == GL_UNSIGNED_SHORT) write(v, static_cast<uint16_t*>(i));
+            else write(v, static_cast<uint32_t*>(i));
+        }
+        // glUnmapBuffer vraci GL_FALSE pokud se obsah behem mapovani poskodil
+        if (v) mapped = (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE) && mapped;
+        if (i) mapped = (glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_TRUE) && mapped;
+
+        if (!mapped) {
+            std::cerr << "warn: ParallelGeometry: map failed, uploading from RAM" << std::endl;
+            std::vector<float> cpuVertices(vertexCount * GPU_STRIDE);
+            if (g.indexType == GL_UNSIGNED_SHORT) {
+                std::vector<uint16_t> cpuIndices(indexCount);
+                write(cpuVertices.data(), cpuIndices.data());
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, g.indexBytes, cpuIndices.data());
+            } else {
+                std::vector<uint32_t> cpuIndices(indexCount);
+                write(cpuVertices.data(), cpuIndices.data());
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, g.indexBytes, cpuIndices.data());
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, 0, g.vertexBytes, cpuVertices.data());
+        }
+
+        GLsizei stride = GPU_STRIDE * sizeof(float);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(8 * sizeof(float)));
+
+        glBindVertexArray(0);
+    }
+};
+
+#endif // PARALLELGEOMETRY_H
@@ -22,10 +22,15 @@
 #include <iostream>
 #include <algorithm>
 #include "Transform.h"
+#include "geometry/IndexData.h"
+#include "ShaderReflection.h"
+#include "FrameUniforms.h"
+#include "ProgramCache.h"
+#include "BonePalette.h"
 
 // ---------- shaders (main skinning VS + lighting FS) ----------
-static const char* kDefaultVS = R"GLSL(
-#version 330 core
+// kamera/svetlo z bloku FrameData (FrameUniforms.h), matice kosti z BonePalette (bone(i))
+static const char* kDefaultVS = "#version 330 core\n" FRAME_DATA_GLSL BONE_PALETTE_GLSL R"GLSL(
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
 layout(location=2) in vec2 aUV;
@@ -35,9 +40,10 @@ layout(location=5) in ivec4 aBoneIDs;
 layout(location=6) in vec4 aWeights;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
-uniform mat4 uBones[100];
+// BONE_INFLUENCES = max. pocet vah na vertex (ModelFBX ho nastavi podle dat, 0 = bez kostry)
+#ifndef BONE_INFLUENCES
+#define BONE_INFLUENCES 4
+#endif
 
 out vec3 vWorldPos;
 out vec2 vUV;
@@ -45,11 +51,20 @@ out mat3 vTBN;
 
 void main(){
     // skinning: compute skin matrix (blend of bone transforms)
-    mat4 skinMat = mat4(0.0);
-    skinMat += aWeights.x * uBones[aBoneIDs.x];
-    skinMat += aWeights.y * uBones[aBoneIDs.y];
-    skinMat += aWeights.z * uBones[aBoneIDs.z];
-    skinMat += aWeights.w * uBones[aBoneIDs.w];
+#if BONE_INFLUENCES == 0
+    mat4 skinMat = mat4(1.0);
+#else
+    mat4 skinMat = aWeights.x * bone(aBoneIDs.x);
+#endif
+#if BONE_INFLUENCES > 1
+    skinMat += aWeights.y * bone(aBoneIDs.y);
+#endif
+#if BONE_INFLUENCES > 2
+    skinMat += aWeights.z * bone(aBoneIDs.z);
+#endif
+#if BONE_INFLUENCES > 3
+    skinMat += aWeights.w * bone(aBoneIDs.w);
+#endif
 
     vec4 skinnedPos = skinMat * vec4(aPos, 1.0);
     vec3 skinnedNormal = mat3(skinMat) * aNormal;
@@ -65,12 +80,11 @@ void main(){
     vec3 N = normalize(mat3(uModel) * skinnedNormal);
     vTBN = mat3(T, B, N);
 
-    gl_Position = uProj * uView * worldPos;
+    gl_Position = frame.viewProjection * worldPos;
 }
 )GLSL";
 
-static const char* kDefaultFS = R"GLSL(
-#version 330 core
+static const char* kDefaultFS = "#version 330 core\n" FRAME_DATA_GLSL R"GLSL(
 out vec4 FragColor;
 
 in vec3 vWorldPos;
@@ -95,11 +109,6 @@ uniform vec3 uAlbedoColor;
 uniform float uMetallicFactor;
 uniform float uSmoothnessFactor;
 
-uniform vec3 uLightPos;
-uniform vec3 uLightColor;
-uniform float uAmbientStrength;
-uniform vec3 uCameraPos;
-
 vec3 getNormal(){
     vec3 N = normalize(vTBN[2]);
     if(uHasNormal){
@@ -116,8 +125,8 @@ void main(){
 
     vec3 N = getNormal();
 
-    vec3 L = normalize(uLightPos - vWorldPos);
-    vec3 V = normalize(uCameraPos - vWorldPos);
+    vec3 L = normalize(frame.lightPos.xyz - vWorldPos);
+    vec3 V = normalize(frame.cameraPos.xyz - vWorldPos);
     vec3 H = normalize(L+V);
 
     float NdotL = max(dot(N,L), 0.0);
@@ -128,34 +137,44 @@ void main(){
 
     vec3 diffuse = albedo * NdotL;
     vec3 specular = mix(vec3(0.04), albedo, metallic) * spec * NdotL;
-    vec3 ambient = albedo * uAmbientStrength;
+    vec3 ambient = albedo * frame.lightColor.a;
 
-    vec3 color = ambient + (diffuse + specular) * uLightColor;
+    vec3 color = ambient + (diffuse + specular) * frame.lightColor.rgb;
     color = pow(color, vec3(1.0/2.2));
     FragColor = vec4(color, 1.0);
 }
 )GLSL";
 
 // ---------- depth shader for shadow map (skinning) ----------
-static const char* kDepthVS = R"GLSL(
-#version 330 core
+static const char* kDepthVS = "#version 330 core\n" FRAME_DATA_GLSL SHADOW_CASTER_GLSL BONE_PALETTE_GLSL R"GLSL(
 layout(location=0) in vec3 aPos;
 layout(location=5) in ivec4 aBoneIDs;
 layout(location=6) in vec4 aWeights;
 
 uniform mat4 model;
-uniform mat4 lightSpaceMatrix;
-uniform mat4 uBones[100];
+// BONE_INFLUENCES = max. pocet vah na vertex (ModelFBX ho nastavi podle dat, 0 = bez kostry)
+#ifndef BONE_INFLUENCES
+#define BONE_INFLUENCES 4
+#endif
 
 void main() {
-    mat4 skinMat = mat4(0.0);
-    skinMat += aWeights.x * uBones[aBoneIDs.x];
-    skinMat += aWeights.y * uBones[aBoneIDs.y];
-    skinMat += aWeights.z * uBones[aBoneIDs.z];
-    skinMat += aWeights.w * uBones[aBoneIDs.w];
+#if BONE_INFLUENCES == 0
+    mat4 skinMat = mat4(1.0);
+#else
+    mat4 skinMat = aWeights.x * bone(aBoneIDs.x);
+#endif
+#if BONE_INFLUENCES > 1
+    skinMat += aWeights.y * bone(aBoneIDs.y);
+#endif
+#if BONE_INFLUENCES > 2
+    skinMat += aWeights.z * bone(aBoneIDs.z);
+#endif
+#if BONE_INFLUENCES > 3
+    skinMat += aWeights.w * bone(aBoneIDs.w);
+#endif
 
     vec4 skinnedPos = skinMat * vec4(aPos,1.0);
-    gl_Position = lightSpaceMatrix * model * skinnedPos;
+    gl_Position = shadowCasterMatrix() * model * skinnedPos;
 }
 )GLSL";
 
@@ -165,35 +184,7 @@ void main(){}
 )GLSL";
 
 
-static const int MAX_BONES = 100;
-
-static GLuint compileShader(GLenum type, const char* src){
-    GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, nullptr);
-    glCompileShader(s);
-    GLint ok = 0; glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
-    if(!ok){
-        GLint len=0; glGetShaderiv(s, GL_INFO_LOG_LENGTH, &len);
-        std::string log(len,'\0'); glGetShaderInfoLog(s,len,nullptr,log.data());
-        std::cerr << "Shader compile error (" << (type==GL_VERTEX_SHADER?"VS":"FS") << "):\n" << log << std::endl;
-    }
-    return s;
-}
-
-static GLuint linkProgram(GLuint vs, GLuint fs){
-    GLuint p = glCreateProgram();
-    glAttachShader(p, vs); glAttachShader(p, fs);
-    glLinkProgram(p);
-    GLint ok=0; glGetProgramiv(p, GL_LINK_STATUS, &ok);
-    if(!ok){
-        GLint len=0; glGetProgramiv(p, GL_INFO_LOG_LENGTH, &len);
-        std::string log(len,'\0'); glGetProgramInfoLog(p,len,nullptr,log.data());
-        std::cerr << "Program link error:\n" << log << std::endl;
-    }
-    glDetachShader(p,vs); glDetachShader(p,fs);
-    glDeleteShader(vs); glDeleteShader(fs);
-    return p;
-}
+static const int MAX_BONES = 1024;   // na model; celkovy limit dava GL_MAX_TEXTURE_BUFFER_SIZE (BonePalette)
 
 // ---------- data structures ----------
 
@@ -222,6 +213,7 @@ struct Mesh {
     GLuint vao=0, vbo=0, ebo=0;
     GLuint boneVBO = 0;
     GLsizei indexCount=0;
+    GLenum indexType=GL_UNSIGNED_INT;
 
     GLuint texAlbedo=0;
     GLuint texNormal=0;
@@ -236,8 +228,11 @@ class ModelFBX {
 private:
     std::vector<Mesh> meshes_;
     std::string directory_;
+    // programy z ProgramCache::AcquireAsync - id plati hned, kreslit az po ensurePrograms()
+    ProgramHandle programHandle_, depthProgramHandle_;
     GLuint program_ = 0;
     GLuint depthProgram_ = 0;
+    int boneInfluences_ = 0;      // nejvyssi pocet vah na vertex ze vsech meshu (permutace skinningu)
     float fallbackAlbedo_[3] = {0.8f, 0.8f, 0.85f};
     float fallbackMetallic_ = 0.0f;
     float fallbackSmoothness_ = 0.2f;
@@ -256,6 +251,21 @@ private:
     float loopEndTicks_ = 0.0f;   // Koncový čas v "ticích"
     bool loopRangeActive_ = false; // Zda se má použít rozsah
 
+    // uniform handles (resolvnute po linkovani program_)
+    ProgramReflection* reflection_ = nullptr;
+    struct Uniforms {
+        UniformHandle<glm::mat4> model;
+        UniformHandle<int> bonePalette, boneBase;
+        UniformHandle<glm::vec3> albedoColor;
+        UniformHandle<float> metallicFactor, smoothnessFactor;
+        UniformHandle<int> texAlbedo, texNormal, texMetallic, texSmoothness;
+        UniformHandle<int> hasAlbedo, hasNormal, hasMetallic, hasSmoothness;
+    } u_;
+    // usek v BonePalette - zapisuje se jednou za frame (po updateAnimation), cte shadow i barevny pruchod
+    GLint paletteBase_ = -1;
+    size_t paletteCount_ = 0;
+    bool paletteDirty_ = true;
+
 public:
     ModelFBX(const std::string& path, const std::string& vsSrc = kDefaultVS,const std::string& fsSrc = kDefaultFS,bool flipUVs = false)
     {
@@ -273,8 +283,7 @@ public:
             if(m.boneVBO) glDeleteBuffers(1, &m.boneVBO);
         }
         for(auto id : ownedTextures_){ glDeleteTextures(1, &id); }
-        if(program_) glDeleteProgram(program_);
-        if(depthProgram_) glDeleteProgram(depthProgram_);
+        BonePalette::Get().Free(paletteBase_, paletteCount_);
     }
 
     Transform transform;
@@ -342,70 +351,76 @@ public:
         vbd.weights[0] = 1.0f;
         return vbd;
     }
-    // draw (main shader)
-    void draw(const glm::mat4& view,const glm::mat4& proj,const glm::vec3& cameraPos){
+    // draw (main shader) - kamera a svetlo z FrameUniforms
+    void draw(){
+        ensurePrograms();
         glUseProgram(program_);
         glm::mat4 model = transform.GetModelMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(program_, "uModel"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(glGetUniformLocation(program_, "uView"),  1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(program_, "uProj"),  1, GL_FALSE, glm::value_ptr(proj));
-        glUniform3fv(glGetUniformLocation(program_, "uCameraPos"), 1, glm::value_ptr(cameraPos));
-
-        glUniform1i(glGetUniformLocation(program_, "uTex.albedo"), 0);
-        glUniform1i(glGetUniformLocation(program_, "uTex.normal"), 1);
-        glUniform1i(glGetUniformLocation(program_, "uTex.metallic"), 2);
-        glUniform1i(glGetUniformLocation(program_, "uTex.smoothness"), 3);
-
-        glUniform3fv(glGetUniformLocation(program_, "uAlbedoColor"), 1, fallbackAlbedo_);
-        glUniform1f(glGetUniformLocation(program_, "uMetallicFactor"), fallbackMetallic_);
-        glUniform1f(glGetUniformLocation(program_, "uSmoothnessFactor"), fallbackSmoothness_);
-        prepareBonesFallback();
-        // upload bones
-        size_t nBonesToSend = std::min<size_t>(bones_.size(), MAX_BONES);
-        for(size_t i=0;i<nBonesToSend;i++){
-            std::string name = "uBones[" + std::to_string(i) + "]";
-            glUniformMatrix4fv(glGetUniformLocation(program_, name.c_str()), 1, GL_FALSE, glm::value_ptr(bones_[i].finalTransform));
-        }
+        ProgramReflection& r = *reflection_;
+        r.Set(u_.model, model);
+
+        r.Set(u_.texAlbedo, 0);
+        r.Set(u_.texNormal, 1);
+        r.Set(u_.texMetallic, 2);
+        r.Set(u_.texSmoothness, 3);
+
+        r.Set(u_.albedoColor, glm::make_vec3(fallbackAlbedo_));
+        r.Set(u_.metallicFactor, fallbackMetallic_);
+        r.Set(u_.smoothnessFactor, fallbackSmoothness_);
+        // kosti z palety (zapis jednou za frame, upload jeden pro vsechny modely)
+        bindBones(r, u_.bonePalette, u_.boneBase);
 
         for(const auto& m : meshes_){
-            bindTextureWithFallback(m.texAlbedo, 0, "uHasAlbedo");
-            bindTextureWithFallback(m.texNormal, 1, "uHasNormal");
-            bindTextureWithFallback(m.texMetallic, 2, "uHasMetallic");
-            bindTextureWithFallback(m.texSmoothness, 3, "uHasSmoothness");
+            bindTextureWithFallback(m.texAlbedo, 0, u_.hasAlbedo);
+            bindTextureWithFallback(m.texNormal, 1, u_.hasNormal);
+            bindTextureWithFallback(m.texMetallic, 2, u_.hasMetallic);
+            bindTextureWithFallback(m.texSmoothness, 3, u_.hasSmoothness);
 
             glBindVertexArray(m.vao);
-            glDrawElements(GL_TRIANGLES, m.indexCount, GL_UNSIGNED_INT, 0);
+            glDrawElements(GL_TRIANGLES, m.indexCount, m.indexType, 0);
             glBindVertexArray(0);
         }
         glUseProgram(0);
     }
 
     // draw for shadow map (uses depthProgram_, supports skinning)
-    void DrawForShadow(unsigned int depthShaderID, const glm::mat4& lightSpaceMatrix)  {
+    void DrawForShadow(unsigned int depthShaderID)  {
         // either user-supplied depthShaderID or internal depthProgram_ could be used.
+        ensurePrograms();
         GLuint programToUse = depthShaderID ? depthShaderID : depthProgram_;
         glUseProgram(programToUse);
 
-        // keep compatibility with original uniform names: "lightSpaceMatrix" and "model"
-        glUniformMatrix4fv(glGetUniformLocation(programToUse, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+        // lightSpaceMatrix comes from the FrameData block, only "model" is per draw
+        ProgramReflection& r = ProgramReflection::For(programToUse);
         glm::mat4 model = transform.GetModelMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(programToUse, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        prepareBonesFallback();
-        // upload bones same as main draw
-        size_t nBonesToSend = std::min<size_t>(bones_.size(), MAX_BONES);
-        for(size_t i=0;i<nBonesToSend;i++){
-            std::string name = "uBones[" + std::to_string(i) + "]";
-            glUniformMatrix4fv(glGetUniformLocation(programToUse, name.c_str()), 1, GL_FALSE, glm::value_ptr(bones_[i].finalTransform));
-        }
+        r.Set(r.Handle<glm::mat4>("model"_u), model);
+        // stejny usek palety jako hlavni draw
+        bindBones(r, r.Handle<int>("uBonePalette"_u), r.Handle<int>("uBoneBase"_u));
 
         for(const auto& m : meshes_){
             glBindVertexArray(m.vao);
-            glDrawElements(GL_TRIANGLES, m.indexCount, GL_UNSIGNED_INT, 0);
+            glDrawElements(GL_TRIANGLES, m.indexCount, m.indexType, 0);
             glBindVertexArray(0);
         }
         glUseProgram(0);
     }
 
+    // Zapise aktualni pozu do BonePalette (jen po zmene). RenderQueue to vola pro vsechny
+    // modely pred kreslenim, takze se paleta nahraje jednou; jinak se zapise pri prvnim draw.
+    void writeBonePalette(){
+        if(!paletteDirty_ && paletteBase_ >= 0) return;
+        prepareBonesFallback();
+        BonePalette& palette = BonePalette::Get();
+        size_t count = std::min<size_t>(bones_.size(), MAX_BONES);
+        if(paletteBase_ < 0 || paletteCount_ != count){
+            palette.Free(paletteBase_, paletteCount_);
+            paletteBase_ = palette.Allocate(count);
+            paletteCount_ = paletteBase_ >= 0 ? count : 0;
+        }
+        for(size_t i=0;i<paletteCount_;i++) palette.Write(paletteBase_, i, bones_[i].finalTransform);
+        paletteDirty_ = false;
+    }
+
     GLuint program() const { return program_; }
     GLuint depthProgram() const { return depthProgram_; }
     size_t numBones() const { return bones_.size(); }
@@ -413,19 +428,59 @@ public:
 
 private:
     // ---------- helpers ----------
+    // vertex shader dostane BONE_INFLUENCES podle nactenych dat - nepouzite vahy se nepocitaji
+    std::string skinningVariant(const char* vs) const {
+        return ProgramCache::InjectDefines(vs, {"BONE_INFLUENCES " + std::to_string(boneInfluences_)});
+    }
+
+    // compile + link jen zadany - driver pracuje, zatimco se nacitaji textury a dalsi modely
     void createProgram(const char* vs, const char* fs){
-        GLuint v = compileShader(GL_VERTEX_SHADER, vs);
-        GLuint f = compileShader(GL_FRAGMENT_SHADER, fs);
-        program_ = linkProgram(v, f);
+        programHandle_ = ProgramCache::Get().AcquireAsync(skinningVariant(vs), fs);
+        program_ = programHandle_->id;
     }
     void createDepthProgram(const char* vs, const char* fs){
-        GLuint v = compileShader(GL_VERTEX_SHADER, vs);
-        GLuint f = compileShader(GL_FRAGMENT_SHADER, fs);
-        depthProgram_ = linkProgram(v, f);
-    }
-
-    void bindTextureWithFallback(GLuint tex, int unit, const char* hasName) const {
-        glUniform1i(glGetUniformLocation(program_, hasName), tex!=0);
+        depthProgramHandle_ = ProgramCache::Get().AcquireAsync(skinningVariant(vs), fs);
+        depthProgram_ = depthProgramHandle_->id;
+    }
+
+    // pri prvnim kresleni pocka na driver (vetsinou uz hotovo) a resolvne uniformy
+    void ensurePrograms(){
+        if(reflection_) return;
+        ProgramCache::Get().Wait(programHandle_);
+        ProgramCache::Get().Wait(depthProgramHandle_);
+        resolveUniforms();
+    }
+
+    void resolveUniforms(){
+        // reflexe obou programu navaze blok FrameData (svetlo a kamera se nastavuji jen tam)
+        ProgramReflection::For(depthProgram_);
+        reflection_ = &ProgramReflection::For(program_);
+        ProgramReflection& r = *reflection_;
+        u_.model = r.Handle<glm::mat4>("uModel"_u);
+        u_.bonePalette = r.Handle<int>("uBonePalette"_u);
+        u_.boneBase = r.Handle<int>("uBoneBase"_u);
+        u_.albedoColor = r.Handle<glm::vec3>("uAlbedoColor"_u);
+        u_.metallicFactor = r.Handle<float>("uMetallicFactor"_u);
+        u_.smoothnessFactor = r.Handle<float>("uSmoothnessFactor"_u);
+        u_.texAlbedo = r.Handle<int>("uTex.albedo"_u);
+        u_.texNormal = r.Handle<int>("uTex.normal"_u);
+        u_.texMetallic = r.Handle<int>("uTex.metallic"_u);
+        u_.texSmoothness = r.Handle<int>("uTex.smoothness"_u);
+        u_.hasAlbedo = r.Handle<int>("uHasAlbedo"_u);
+        u_.hasNormal = r.Handle<int>("uHasNormal"_u);
+        u_.hasMetallic = r.Handle<int>("uHasMetallic"_u);
+        u_.hasSmoothness = r.Handle<int>("uHasSmoothness"_u);
+    }
+
+    void bindBones(ProgramReflection& r, const UniformHandle<int>& paletteHandle, const UniformHandle<int>& baseHandle){
+        writeBonePalette();
+        BonePalette::Get().Bind();
+        r.Set(paletteHandle, BonePalette::TEXTURE_UNIT);
+        r.Set(baseHandle, paletteBase_);   // -1 = bez useku, shader kresli bez skinningu
+    }
+
+    void bindTextureWithFallback(GLuint tex, int unit, const UniformHandle<int>& hasFlag) const {
+        reflection_->Set(hasFlag, static_cast<int>(tex!=0));
         if(tex){
             glActiveTexture(GL_TEXTURE0 + unit);
             glBindTexture(GL_TEXTURE_2D, tex);
@@ -496,6 +551,12 @@ private:
                         boneData[v].addBoneData(boneIndex, w);
                 }
             }
+            // vahy se plni od slotu 0, pocet nenulovych = pocet vlivu
+            for(const VertexBoneData& vbd : boneData){
+                int n = 0;
+                while(n < 4 && vbd.weights[n] != 0.0f) n++;
+                boneInfluences_ = std::max(boneInfluences_, n);
+            }
         } else {
             for(size_t i=0;i<mesh->mNumVertices;i++){
                 boneData[i] = createDefaultBoneData();
@@ -509,8 +570,10 @@ private:
         glBindVertexArray(out.vao);
         glBindBuffer(GL_ARRAY_BUFFER, out.vbo);
         glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        IndexData packed = IndexData::FromIndices(indices, mesh->mNumVertices);
+        out.indexType = packed.type;
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, out.ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, packed.Bytes(), packed.Data(), GL_STATIC_DRAW);
 
         GLsizei stride = (3+3+2+3+3)*sizeof(float);
         glEnableVertexAttribArray(0); glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,stride,(void*)0);
@@ -665,20 +728,6 @@ private:
     void disableAnimationLoopRange() {
         loopRangeActive_ = false;
     }
-    // lighting
-    void setLightProperties(const glm::vec3& lightPos,
-                            const glm::vec3& lightColor,
-                            float ambientStrength,
-                            const glm::vec3& cameraPos)
-    {
-        glUseProgram(program_);
-        glUniform3fv(glGetUniformLocation(program_, "uLightPos"), 1, glm::value_ptr(lightPos));
-        glUniform3fv(glGetUniformLocation(program_, "uLightColor"), 1, glm::value_ptr(lightColor));
-        glUniform1f(glGetUniformLocation(program_, "uAmbientStrength"), ambientStrength);
-        glUniform3fv(glGetUniformLocation(program_, "uCameraPos"), 1, glm::value_ptr(cameraPos));
-        glUseProgram(0);
-    }
-
     // --- animation control ---
     void playAnimationByIndex(int idx) {
         if (!scene_ || idx < 0 || idx >= (int)scene_->mNumAnimations) {
@@ -717,6 +766,7 @@ private:
 
     // call each frame with current time in seconds to update skeleton
     void updateAnimation(float timeSec){
+        paletteDirty_ = true;
         if(!scene_ || !animPlaying_ || scene_->mNumAnimations == 0){
             // stávající fallback pro neanimované modely nebo zastavenou animaci
             for(auto &b : bones_){
@@ -10,6 +10,8 @@
 //#include <vector>
 #include <string>
 
+#include "../glbox/ShadowFilter.h"
+
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
 const unsigned int SHADOW_WIDTH = 2048, SHADOW_HEIGHT = 2048;
@@ -73,33 +75,26 @@ void main(){
 }
 )glsl";
 
-const char* sceneFS = R"glsl(
-#version 330 core
+const char* sceneFS = "#version 330 core\n" SHADOW_KERNELS_GLSL R"glsl(
 out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec4 FragPosLightSpace[3];
-uniform sampler2D shadowMap[3];
+uniform sampler2DShadow shadowMap[3];   // compare mode - 4-tap hardware PCF (ShadowPcf4)
 uniform vec3 lightDir;
 uniform vec3 viewPos;
 uniform float cascadeEnds[3];
 
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir){
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+float ShadowCalculation(int cascade, vec3 normal){
+    vec3 projCoords = FragPosLightSpace[cascade].xyz / FragPosLightSpace[cascade].w;
     projCoords = projCoords*0.5 + 0.5;
     if(projCoords.z > 1.0) return 0.0;
-    float closestDepth = texture(shadowMap[0], projCoords.xy).r; // will be overwritten by caller
-    float currentDepth = projCoords.z;
     float bias = max(0.005*(1.0-dot(normal,-lightDir)),0.0005);
-    float shadow = 0.0;
-    vec2 texelSize = 1.0/textureSize(shadowMap[0],0);
-    for(int x=-1;x<=1;x++)
-        for(int y=-1;y<=1;y++){
-            float pcfDepth = texture(shadowMap[0], projCoords.xy + vec2(x,y)*texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
-    shadow/=9.0;
-    return shadow;
+    vec3 coord = vec3(projCoords.xy, projCoords.z - bias);
+    // pole sampleru jen s konstantnim indexem (GLSL 3.30)
+    if(cascade == 0) return ShadowPcf4(shadowMap[0], coord);
+    if(cascade == 1) return ShadowPcf4(shadowMap[1], coord);
+    return ShadowPcf4(shadowMap[2], coord);
 }
 
 void main(){
@@ -116,18 +111,7 @@ void main(){
     else cascade=2;
 
     // PCF pro vybranou kaskádu
-    vec3 projCoords = FragPosLightSpace[cascade].xyz / FragPosLightSpace[cascade].w;
-    projCoords = projCoords*0.5+0.5;
-    float currentDepth = projCoords.z;
-    float shadow=0.0;
-    float bias = max(0.005*(1.0-dot(norm,-lightDir)),0.0005);
-    vec2 texelSize = 1.0/textureSize(shadowMap[cascade],0);
-    for(int x=-1;x<=1;x++)
-        for(int y=-1;y<=1;y++){
-            float pcfDepth = texture(shadowMap[cascade], projCoords.xy+vec2(x,y)*texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
-    shadow/=9.0;
+    float shadow = ShadowCalculation(cascade, norm);
 
     vec3 lighting = (0.2 + (1.0-shadow)*diff) * color;
     FragColor = vec4(lighting,1.0);
@@ -262,8 +246,11 @@ int main(){
     for(int i=0;i<CASCADE_COUNT;i++){
         glBindTexture(GL_TEXTURE_2D,depthMap[i]);
         glTexImage2D(GL_TEXTURE_2D,0,GL_DEPTH_COMPONENT,SHADOW_WIDTH,SHADOW_HEIGHT,0,GL_DEPTH_COMPONENT,GL_FLOAT,NULL);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+        // LINEAR + compare = bilinearni PCF v hardware (sampler2DShadow)
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_COMPARE_MODE,GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_COMPARE_FUNC,GL_LEQUAL);
         glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_BORDER);
         glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_BORDER);
         float border[]={1.0,1.0,1.0,1.0};
@@ -19,12 +19,16 @@
 #include "../glbox/StaticMesh.h"
 #include "../glbox/PbrMaterial.h"
 #include "../glbox/Transform.h"
+#include "../glbox/TransformBatch.h"
 #include "../glbox/Shader.h"
+#include "../glbox/FrameUniforms.h"
+#include "../glbox/RenderQueue.h"
 #include "../glbox/Texture.h"
 #include "../glbox/ProceduralSky.h"
 #include "../glbox/TexturedSky.h"
 #include "../glbox/HdriSky.h"
 #include "../glbox/geometry/Geometry.h"
+#include "../glbox/geometry/ParallelGeometry.h"
 #include "../glbox/physics/Raycast.h"
 #include "../glbox/physics/Physics.h"
 #include "../glbox/DebugDraw.h"
@@ -48,6 +52,7 @@ float lastFrame = 0.0f;
 
 int main() {
 
+    auto launchTime = std::chrono::steady_clock::now();
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
@@ -92,6 +97,9 @@ int main() {
 
     // --- DEPTH BUFFER SHADOWS ---
     DepthMap shadowMap = Trexture::createDepthMapFBO();
+    // kaskady: 4 x 2048^2 ve stejne pameti jako shadowMap (ta zustava pro vypnute kaskady)
+    CascadedShadowMaps& cascades = CascadedShadowMaps::Get();
+    cascades.Create(2048, 4);
     Shader depthShader("shaders/depth.vert", "shaders/depth.frag");
     Shader modelDepthShader("shaders/model/model_depth.vert", "shaders/model/model_depth.frag");
     //============================================================================
@@ -116,12 +124,9 @@ int main() {
 
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
-    std::vector<float> vertices1;
-    std::vector<unsigned int> indices1;
     std::vector<float> vertices2;
     std::vector<unsigned int> indices2;
 
-    Geometry::generatePlane(100.0f, 100.0f, 10, 10, 100.0f, 100.0f, vertices1,indices1);
     Geometry::generateCube(1.0f, vertices, indices);
     Geometry::generateSphere(0.5f, 32, 32, vertices2, indices2);
 
@@ -174,15 +179,30 @@ int main() {
     pbrcube.transform.scale = glm::vec3(1.5f);
     pbrcube.transform.position = glm::vec3(1.0f, 0.5f, 2.0f);
 
-    StaticMesh planeMesh(vertices1,indices1,&goldMaterial1,"floor");
+    // podlaha se generuje paralelne primo do namapovaneho VBO/EBO
+    StaticMesh planeMesh(ParallelGeometry::UploadPlane(100.0f, 100.0f, 10, 10, 100.0f, 100.0f), &goldMaterial1, "floor");
     SceneObject floor(&planeMesh);
     floor.transform.position = glm::vec3(0.0f, -0.5f, 0.0f);
+    // nehybne objekty drzi ShadowCache v ulozene shadow mape (pohyb se pozna podle matice)
+    floor.staticShadow = true;
+    pbrcube.staticShadow = true;
 
     StaticMesh cubeMesh1(vertices2,indices2,&goldMaterial1,"cube2");
     SceneObject cube(&cubeMesh1);
     cube.transform.position = glm::vec3(-1.0f, 0.5f, 2.0f);
     cube.transform.scale = glm::vec3(1.5f);
 
+    // meshlet culling (back-facing / mimo frustum clustery se nekresli)
+    bool useMeshlets = true;
+    staticmesh.EnableMeshlets(useMeshlets);
+    cubeMesh1.EnableMeshlets(useMeshlets);
+    planeMesh.EnableMeshlets(useMeshlets);
+
+    // CPU kopie geometrie: physics potrebuje jen localAABB, zbytek se po uploadu zahodi
+    int residencyMode = static_cast<int>(CpuResidency::Release);
+    for (StaticMesh* m : {&staticmesh, &cubeMesh1, &planeMesh})
+        m->SetResidency(static_cast<CpuResidency>(residencyMode));
+
     ModelFBX model("assets/models/Player/Player.fbx");
     unsigned int myAlbedoTex = Trexture::loadTexture("assets/models/Player/Textures/Player_D.tga");
     unsigned int myNormalTex = Trexture::loadTexture("assets/models/Player/Textures/Player_NRM.tga");
@@ -214,7 +234,7 @@ int main() {
     model1.setAlbedoTexture(m16,1);
     model1.setAlbedoTexture(Marine,0);
  //      model1.setAlbedoTexture(m16,1);
-    SceneObject soldier(&model);
+    SceneObject soldier(&model1);
     //for(int i=0;i<model.numAnimations();++i) std::cout << i << " anim " <<model.animationName(i)  << std::endl;
     //model1.stopAnimation();
     // model.stopAnimation();
@@ -240,6 +260,40 @@ int main() {
     const std::chrono::seconds updateInterval(10);
     bool sphere = true;
 
+    // draw pakety se kazdy frame seradi podle stavu (program/material/textury/VAO/hloubka)
+    RenderQueue renderQueue;
+    std::vector<const SceneObject*> sceneObjects = { &floor, &cube, &soldier1, &soldier, &pbrcube };
+
+    // mrizka stejnych kostek (sdileny mesh + material) - kresli se instancovane v shadow i color passu
+    // props visi v hierarchii pod spolecnym korenem - otoceni korene pohne celou mrizkou
+    SceneGraph sceneGraph;
+    Transform propsRoot(glm::vec3(0.0f, 0.0f, -8.0f));
+    SceneGraph::Node propsNode = sceneGraph.Create(SceneGraph::INVALID, &propsRoot);
+    TransformBatch::BenchmarkResult transformBench;
+
+    int propCount = 0;
+    std::vector<SceneObject> props;
+    auto rebuildProps = [&](int count) {
+        for (const SceneObject& prop : props) sceneGraph.Destroy(prop.node);
+        props.clear();
+        props.reserve(count);
+        int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+        for (int i = 0; i < count; ++i) {
+            SceneObject prop(&cubeMesh1);
+            float x = (i % side - side * 0.5f) * 0.9f;
+            float z = (i / side - side * 0.5f) * 0.9f;
+            prop.transform.position = glm::vec3(x, -0.3f, z);
+            prop.transform.scale = glm::vec3(0.3f);
+            prop.staticShadow = true;
+            prop.materialOverride = glm::vec4(0.6f + 0.4f * std::sin(i * 0.37f),
+                                              0.6f + 0.4f * std::sin(i * 0.61f),
+                                              0.6f + 0.4f * std::sin(i * 0.89f),
+                                              0.2f + 0.6f * ((i * 7) % 11) / 10.0f);
+            props.push_back(prop);
+            props.back().attach(sceneGraph, propsNode);   // zdroj = transform uz ve vektoru
+        }
+    };
+
     //===============================================================================================
     //!Physics
     //===============================================================================================
@@ -269,6 +323,10 @@ int main() {
     std::cout << "Initial Octree built!" << std::endl;
     DebugDraw debugDrawer;
 
+    // cold start (prazdny shader_cache/) vs warm start - rozdil je ve "from disk" / "compiled"
+    double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count();
+    std::cout << "Startup: " << startupMs << " ms, " << ProgramBinaryCache::Get().Report() << std::endl;
+
     ///===========================================================================main loop
     ///==================================================================================
 
@@ -314,7 +372,186 @@ int main() {
         ImGui::SliderFloat("Transmission", &transmission, 0.0f, 1.0f);
         ImGui::SliderFloat("Index of Refraction (IOR)", &ior, 1.0f, 2.5f);
 
+        ImGui::Separator();
+        ImGui::Text("Meshlets");
+        if (ImGui::Checkbox("Meshlet culling", &useMeshlets)) {
+            staticmesh.EnableMeshlets(useMeshlets);
+            cubeMesh1.EnableMeshlets(useMeshlets);
+            planeMesh.EnableMeshlets(useMeshlets);
+        }
+        ImGui::Text("Triangles: %u / %u", MeshletStats::trianglesSubmitted, MeshletStats::trianglesTotal);
+        ImGui::Text("Meshlets culled: %u / %u", MeshletStats::meshletsCulled, MeshletStats::meshletsTotal);
+
+        ImGui::Separator();
+        ImGui::Text("Geometry registry");
+        {
+            GeometryRegistry& registry = GeometryRegistry::Get();
+            const GeometryRegistry::Stats& gs = registry.GetStats();
+            ImGui::Text("Live: %zu buffers, %.1f KB", registry.LiveCount(), registry.LiveBytes() / 1024.0);
+            ImGui::Text("Uploads: %zu (%.2f ms), shared hits: %zu, key collisions: %zu", gs.uploads, gs.uploadMs, gs.hits, gs.collisions);
+            ImGui::Text("Saved: %.1f KB", gs.bytesSaved / 1024.0);
+
+            const char* residencyNames[] = { "Keep all", "Release" };
+            if (ImGui::Combo("CPU residency", &residencyMode, residencyNames, 2)) {
+                for (StaticMesh* m : {&staticmesh, &cubeMesh1, &planeMesh})
+                    m->SetResidency(static_cast<CpuResidency>(residencyMode));
+            }
+            ImGui::Text("CPU geometry: %.1f KB (released %.1f KB)",
+                        registry.LiveCpuBytes() / 1024.0, registry.ReleasedCpuBytes() / 1024.0);
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Uniforms: %u uploaded, %u skipped (%u by name)",
+                    ProgramReflection::stats.uploads, ProgramReflection::stats.skipped,
+                    ProgramReflection::stats.lookups);
+        ImGui::Text("Programs: %zu live, %zu compiled, %zu shared (%.1f ms)",
+                    ProgramCache::Get().LiveCount(), ProgramCache::Get().GetStats().compiles,
+                    ProgramCache::Get().GetStats().hits, ProgramCache::Get().GetStats().compileMs);
+        ImGui::Text("Async compile: %zu submitted, %zu in flight, %.1f ms waited (%s)",
+                    ProgramCache::Get().GetStats().asyncCompiles, ProgramCache::Get().PendingCount(),
+                    ProgramCache::Get().GetStats().asyncWaitMs,
+                    ProgramCache::ParallelSupported() ? "parallel" : "serial");
+        ImGui::Text("Startup: %.0f ms, %u programs from disk (%.1f ms), %u compiled (%.1f ms)", startupMs,
+                    ProgramBinaryCache::Get().GetStats().loaded, ProgramBinaryCache::Get().GetStats().loadMs,
+                    ProgramBinaryCache::Get().GetStats().compiled, ProgramBinaryCache::Get().GetStats().compileMs);
+        ImGui::Text("Frame UBO: %s, %u waits (%.2f ms)",
+                    FrameUniforms::Get().IsPersistent() ? "persistent" : "subdata",
+                    FrameUniforms::Get().GetStats().waits, FrameUniforms::Get().GetStats().waitMs);
+
+        ImGui::Separator();
+        {
+            ShaderPermutations& permutations = ShaderPermutations::Get();
+            ImGui::Text("Shader variants: %zu (%zu pending)", permutations.Variants().size(), permutations.PendingCount());
+            ImGui::Checkbox("Profile shader variants", &permutations.profiling);
+            if (ImGui::BeginTable("variants", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Variant");
+                ImGui::TableSetupColumn("Compile ms");
+                ImGui::TableSetupColumn("GPU ms");
+                ImGui::TableSetupColumn("ns/sample");
+                ImGui::TableSetupColumn("Draws");
+                ImGui::TableHeadersRow();
+                for (const auto& [program, v] : permutations.Variants()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(v.label.c_str());
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", v.compileMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", v.gpuMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", v.NsPerSample());
+                    ImGui::TableNextColumn(); ImGui::Text("%u", v.draws);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Render queue");
+        {
+            const RenderQueue::Stats& qs = renderQueue.GetStats();
+            const GLStateCache::Stats& cs = GLStateCache::Get().stats;
+            ImGui::Text("Packets: %u shadow, %u opaque, %u transparent",
+                        qs.packets[0], qs.packets[1], qs.packets[2]);
+            ImGui::Text("Sort: %.3f ms (%u radix passes)", qs.sortMs, qs.radixPasses);
+            ImGui::Text("Object matrices: %.3f ms", qs.matrixMs);
+            ImGui::Text("Bone palette: %zu bones, %u uploads (%.1f KB)", BonePalette::Get().Size(),
+                        BonePalette::Get().GetStats().uploads, BonePalette::Get().GetStats().uploadedBytes / 1024.0);
+            ImGui::Text("Draw calls: %u (%u instanced, %u instances)",
+                        qs.drawCalls, qs.instancedDraws, qs.instances);
+            ImGui::Text("Multi-draw indirect: %u calls, %u commands",
+                        qs.indirectDraws, qs.indirectCommands);
+            ImGui::Checkbox("Cascaded shadows", &cascades.enabled);
+            if (cascades.Active()) {
+                ImGui::SameLine();
+                if (CascadedShadowMaps::LayeredSupported())
+                    ImGui::Checkbox("Single pass (gl_Layer)", &cascades.layered);
+                else
+                    ImGui::TextDisabled("Single pass: needs ARB_shader_viewport_layer_array");
+                ImGui::SliderInt("Cascades", &cascades.cascadeCount, 1, CascadedShadowMaps::MAX_CASCADES);
+                ImGui::SliderFloat("Split lambda", &cascades.splitLambda, 0.0f, 1.0f);
+                ImGui::SliderFloat("Shadow distance", &cascades.maxDistance, 10.0f, 100.0f);
+                ImGui::Text("Cascade casters: %u / %u / %u / %u (%.0f MB)",
+                            qs.cascadeCasters[0], qs.cascadeCasters[1], qs.cascadeCasters[2], qs.cascadeCasters[3],
+                            cascades.MemoryBytes() / (1024.0 * 1024.0));
+            }
+            ShadowFilter& shadowFilter = ShadowFilter::Get();
+            {
+                const char* kernelNames[] = { ShadowFilter::Name(ShadowFilter::Kernel::Pcf4),
+                                              ShadowFilter::Name(ShadowFilter::Kernel::Poisson),
+                                              ShadowFilter::Name(ShadowFilter::Kernel::Pcss),
+                                              ShadowFilter::Name(ShadowFilter::Kernel::Evsm) };
+                int kernel = static_cast<int>(shadowFilter.kernel);
+                if (ImGui::Combo("Shadow filter", &kernel, kernelNames, 4))
+                    shadowFilter.kernel = static_cast<ShadowFilter::Kernel>(kernel);
+                if (shadowFilter.kernel == ShadowFilter::Kernel::Poisson || shadowFilter.kernel == ShadowFilter::Kernel::Pcss)
+                    ImGui::SliderFloat("Filter radius (texels)", &shadowFilter.radius, 1.0f, 8.0f);
+                if (shadowFilter.kernel == ShadowFilter::Kernel::Pcss)
+                    ImGui::SliderFloat("Light size (tan)", &shadowFilter.lightAngle, 0.001f, 0.1f, "%.3f");
+                if (shadowFilter.kernel == ShadowFilter::Kernel::Evsm) {
+                    EvsmShadow& evsm = EvsmShadow::Get();
+                    ImGui::SliderInt("EVSM downsample", &evsm.downsample, 1, 4);
+                    ImGui::SliderInt("EVSM blur radius", &evsm.blurRadius, 0, 8);
+                    ImGui::Text("EVSM: %u layers filtered (%.2f ms, %.0f MB)", evsm.GetStats().layers,
+                                evsm.GetStats().filterMs, evsm.MemoryBytes() / (1024.0 * 1024.0));
+                }
+                ImGui::Text("Shadow fetches / pixel: %d (PCF %d, Poisson %d, PCSS %d, EVSM %d)",
+                            ShadowFilter::Fetches(shadowFilter.kernel),
+                            ShadowFilter::Fetches(ShadowFilter::Kernel::Pcf4),
+                            ShadowFilter::Fetches(ShadowFilter::Kernel::Poisson),
+                            ShadowFilter::Fetches(ShadowFilter::Kernel::Pcss),
+                            ShadowFilter::Fetches(ShadowFilter::Kernel::Evsm));
+            }
+            ShadowCache& shadowCache = ShadowCache::Get();
+            if (ShadowCache::Supported()) {
+                ImGui::Checkbox("Static shadow cache", &shadowCache.enabled);
+                const ShadowCache::Stats& scs = shadowCache.GetStats();
+                ImGui::Text("Shadow cache: %u rebuilt, %u restored, %u casters skipped (%.0f MB)",
+                            scs.rebuilds, scs.restores, scs.skippedCasters, shadowCache.MemoryBytes() / (1024.0 * 1024.0));
+            } else {
+                ImGui::TextDisabled("Static shadow cache: needs GL 4.3");
+            }
+            DepthPrePass& prePass = DepthPrePass::Get();
+            ImGui::Text("Overdraw: %.2f fragments / pixel (%u auto toggles)",
+                        prePass.GetStats().overdraw, prePass.GetStats().toggles);
+            ImGui::Checkbox("Depth pre-pass", &prePass.enabled);
+            ImGui::SameLine();
+            ImGui::Checkbox("Auto (overdraw)", &prePass.autoToggle);
+            if (WeightedOIT::Supported())
+                ImGui::Checkbox("Order-independent transparency", &WeightedOIT::Get().enabled);
+            else
+                ImGui::TextDisabled("Order-independent transparency: needs GL 4.0");
+            if (IndirectDraw::Supported())
+                ImGui::Checkbox("Multi-draw indirect", &renderQueue.useIndirect);
+            else
+                ImGui::TextDisabled("Multi-draw indirect: needs GL 4.6");
+            GeometryArena::Stats as = GeometryArena::TotalStats();
+            ImGui::Text("Geometry arena: %zu / %zu vertices, %zu / %zu indices, %.2f MB, %u grows",
+                        as.vertexUsed, as.vertexCapacity, as.indexUsed, as.indexCapacity,
+                        as.bytes / (1024.0 * 1024.0), as.grows);
+            if (ImGui::SliderInt("Props", &propCount, 0, 10000))
+                rebuildProps(propCount);
+            ImGui::SliderFloat("Props yaw", &propsRoot.rotation.y, -180.0f, 180.0f);
+            const SceneGraph::Stats& sg = sceneGraph.GetStats();
+            ImGui::Text("Scene graph: %zu nodes, %zu levels, %zu updated (%.3f ms)",
+                        sg.nodes, sg.levels, sg.updated, sg.updateMs);
+            if (ImGui::Button("Matrix batch benchmark"))
+                transformBench = TransformBatch::Benchmark();
+            if (transformBench.count)
+                ImGui::Text("%zu matrices: glm %.2f ms, Euler %.2f / %.2f ms SSE, quat %.2f / %.2f ms SSE, "
+                            "axis-angle %.2f / %.2f ms SSE, max error %.1e%s",
+                            transformBench.count, transformBench.glmMs, transformBench.eulerScalarMs,
+                            transformBench.eulerSimdMs, transformBench.quatScalarMs, transformBench.quatSimdMs,
+                            transformBench.axisAngleScalarMs, transformBench.axisAngleSimdMs,
+                            transformBench.maxError, transformBench.Passed() ? "" : " (FAIL)");
+            ImGui::Text("Programs: %u / %u", cs.program.issued, cs.program.requested);
+            ImGui::Text("Textures: %u / %u", cs.texture.issued, cs.texture.requested);
+            ImGui::Text("VAOs: %u / %u", cs.vao.issued, cs.vao.requested);
+            ImGui::Text("Blend: %u / %u", cs.blend.issued, cs.blend.requested);
+        }
+
         ImGui::End();
+        MeshletStats::Reset();
+        BonePalette::Get().ResetStats();
+        ShadowCache::Get().ResetStats();
+        ProgramReflection::stats.Reset();
+        GLStateCache::Get().stats.Reset();
         //============================================================================input
         processInput(window);
 
@@ -338,41 +575,11 @@ int main() {
         // !OPRAVA: SYNCHRONIZACE FYZIKY S VYKRESLOVÁNÍM
         // ===============================================================================================
 
-        // Musíme vytvořit helper lambda funkci nebo to rozepsat ručně pro převod Transform -> Mat4
-        auto createModelMatrix = [](const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scale) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, pos);
-            // Předpokládám pořadí rotace Y -> X -> Z nebo podobně, upravte dle vaší implementace v SceneObject
-            model = glm::rotate(model, glm::radians(rot.x), glm::vec3(1, 0, 0));
-            model = glm::rotate(model, glm::radians(rot.y), glm::vec3(0, 1, 0));
-            model = glm::rotate(model, glm::radians(rot.z), glm::vec3(0, 0, 1));
-            model = glm::scale(model, scale);
-            return model;
-        };
-
-        // 1. Aktualizujeme matice pro fyziku podle aktuálních dat z SceneObject
-        // Pozor: Musíte správně spárovat Mesh s SceneObjectem!
-
-        // Pro 'cube' (která používá cubeMesh1)
-        modelMatrices[&cubeMesh1] = createModelMatrix(
-            cube.transform.position,
-            cube.transform.rotation,
-            cube.transform.scale
-            );
-
-        // Pro 'pbrcube' (která používá staticmesh)
-        modelMatrices[&staticmesh] = createModelMatrix(
-            pbrcube.transform.position,
-            pbrcube.transform.rotation,
-            pbrcube.transform.scale
-            );
-
-        // Pro 'floor' (která používá planeMesh)
-        modelMatrices[&planeMesh] = createModelMatrix(
-            floor.transform.position,
-            floor.transform.rotation,
-            floor.transform.scale // Pozor: floor nemá nastavený scale v kódu, je default 1.0?
-            );
+        // Matice z Transform cache - staticke objekty se neprepocitavaji, rotujici kostka
+        // jednou za frame (Draw / shadow / RenderQueue pak ctou stejnou matici)
+        modelMatrices[&cubeMesh1] = cube.transform.GetModelMatrix();
+        modelMatrices[&staticmesh] = pbrcube.transform.GetModelMatrix();
+        modelMatrices[&planeMesh] = floor.transform.GetModelMatrix();
 
 
         // --- 2. Update World AABB and rebuild Octree ---
@@ -416,8 +623,6 @@ int main() {
 
         const float IOR_GLASS = 1.0f / 1.52f;
         //  model1.transform.rotation.y = glfwGetTime() * rotationSpeed;
-        glm::mat4 invProjection = glm::inverse(projection);
-        glm::mat4 invView = glm::inverse(view);
         // ================================================================= //
         float time = static_cast<float>(glfwGetTime());
         glm::vec3 sunWorldPos = glm::vec3(
@@ -431,19 +636,44 @@ int main() {
 
         glm::vec3 directionToSun = glm::normalize(sunWorldPos);
 
+        // kamera + svetlo jednou za frame do FrameData (UBO ring), draw cally uz posilaji jen data objektu
+        FrameUniforms& frameUniforms = FrameUniforms::Get();
+        frameUniforms.data.SetCamera(view, projection, camera.Position, time);
+        frameUniforms.data.SetLight(lightPos, lightColor, ambientStrength, lightSpaceMatrix);
+        frameUniforms.data.sunDirection = glm::vec4(directionToSun, 0.0f);
+        cascades.Update(view, glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f,
+                        lightTarget - lightPos, frameUniforms.data);
+        ShadowFilter::Get().Apply(frameUniforms.data);
+        frameUniforms.Upload();
+
         cube.transform.rotation.y = glfwGetTime() * rotationSpeed;
+
+        unsigned int cubeMap = sky.getCubeMap();
+        sceneGraph.Update();
+        renderQueue.Clear();
+        for (const SceneObject* object : sceneObjects) {
+            renderQueue.AddShadowCaster(*object, object->getModel() ? modelDepthShader.ID : depthShader.ID);
+            renderQueue.Add(*object, cubeMap, shadowMap.texture);
+        }
+        for (const SceneObject& prop : props) {
+            renderQueue.AddShadowCaster(prop, depthShader.ID);
+            renderQueue.Add(prop, cubeMap, shadowMap.texture);
+        }
         // --- 1.pass depth map for shadow
         //============================================================================draw shadows
-        glViewport(0, 0, shadowMap.width, shadowMap.height);
-        glBindFramebuffer(GL_FRAMEBUFFER, shadowMap.fbo);
-        glClear(GL_DEPTH_BUFFER_BIT);
-
-        floor.DrawForShadow(depthShader.ID, lightSpaceMatrix);
-        cube.DrawForShadow(depthShader.ID, lightSpaceMatrix);
-        model.DrawForShadow(modelDepthShader.ID, lightSpaceMatrix);
-        model1.DrawForShadow(modelDepthShader.ID, lightSpaceMatrix);
-        pbrcube.DrawForShadow(depthShader.ID, lightSpaceMatrix);
-        //staticmesh.DrawForShadow(depthShader.ID,modelA, lightSpaceMatrix);
+        if (cascades.Active()) {
+            renderQueue.SubmitShadowCascades(cascades);
+        } else {
+            renderQueue.SubmitShadowMap(shadowMap.fbo, shadowMap.texture, shadowMap.width, shadowMap.height);
+        }
+        // EVSM: momenty z prave nakreslene depth mapy (blur + mipmapy jednou za frame)
+        if (ShadowFilter::Get().kernel == ShadowFilter::Kernel::Evsm) {
+            if (cascades.Active())
+                EvsmShadow::Get().Filter(cascades.Texture(), GL_TEXTURE_2D_ARRAY, cascades.Count());
+            else
+                EvsmShadow::Get().Filter(shadowMap.texture, GL_TEXTURE_2D);
+        }
+        //staticmesh.DrawForShadow(depthShader.ID,modelA);
 
         //============================================================================draw shadows
         // --- 2. pass color ---
@@ -451,8 +681,6 @@ int main() {
         glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        model.setLightProperties(lightPos, lightColor, ambientStrength,camera.Position);
-        model1.setLightProperties(lightPos, lightColor, ambientStrength,camera.Position);
         //  model.playAnimationByIndex(0);
         model.setAnimationLoopRange(3.5f, 3.55f);
         model.updateAnimation(t);
@@ -463,28 +691,17 @@ int main() {
         //============================================================================draw geometry
 
         glDisable(GL_DEPTH_TEST);
-        float time1 = static_cast<float>(glfwGetTime());
-        skydome.Draw(invView, invProjection, directionToSun,time1);
-        //skybox.Draw(view, projection);
-        //sky.draw(view, projection);
+        skydome.Draw();
+        //skybox.Draw();
+        //sky.draw();
         glEnable(GL_DEPTH_TEST);
 
-        glm::vec3 objPos;
-        glm::vec3 lightDir;
-        unsigned int cubeMap = sky.getCubeMap();
-
-        objPos = glm::vec3(floor.transform.position);
-        lightDir = glm::normalize(lightPos - objPos);
-
-        floor.Draw(view, projection, camera.Position, cubeMap, shadowMap.texture,lightSpaceMatrix, lightDir,lightColor);
-        cube.Draw(view, projection, camera.Position, cubeMap, shadowMap.texture,lightSpaceMatrix, lightDir,lightColor);
-        model.draw(view,projection, camera.Position);
-        model1.draw(view,projection, camera.Position);
-
-        objPos       = glm::vec3(pbrcube.transform.position);
-        lightDir     = glm::normalize(lightPos - objPos);
-
-        pbrcube.Draw(view, projection, camera.Position, cubeMap, shadowMap.texture,lightSpaceMatrix, lightDir,lightColor);
+        // smer ke svetlu se pocita v shaderu z FrameData.lightPos a pocatku objektu
+        if (DepthPrePass::Get().enabled) renderQueue.SubmitDepthPrePass(depthShader.ID);
+        renderQueue.Submit(RenderPass::Opaque);
+        renderQueue.Submit(RenderPass::Transparent);
+        // surova hloubka stinu uz neni potreba - sampler objekty pryc z jednotek 8/9
+        ShadowFilter::Get().UnbindDepth();
 
         glDepthMask(GL_FALSE);
         glEnable(GL_BLEND);
@@ -584,16 +801,33 @@ int main() {
 
         glEnable(GL_DEPTH_TEST); // Re-enable depth testing for subsequent rendering
 
+        frameUniforms.EndFrame();
+        ShaderPermutations::Get().EndFrame();
+        DepthPrePass::Get().EndFrame();
+
         //============================================================================draw imgui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         glfwSwapBuffers(window);
+        // jedna cekajici varianta shaderu za frame (mezitim kresli uber varianta)
+        ShaderPermutations::Get().Pump(1);
         glfwPollEvents();
     }
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
+    FrameUniforms::Get().Release();
+    InstanceBuffer::Get().Release();
+    IndirectDraw::Get().Release();
+    ShaderPermutations::Get().Release();
+    DepthPrePass::Get().Release();
+    WeightedOIT::Get().Release();
+    CascadedShadowMaps::Get().Release();
+    ShadowCache::Get().Release();
+    ShadowFilter::Get().Release();
+    EvsmShadow::Get().Release();
+    BonePalette::Get().Release();
     glfwTerminate();
     return 0;
 }
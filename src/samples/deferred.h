@@ -17,6 +17,7 @@
 #include "stb_image.h"
 #include "../glbox/Shader.h"
 #include "../glbox/Texture.h"
+#include "../glbox/ObjectMatrices.h"
 
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
@@ -55,15 +56,15 @@ out vec3 Normal;
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;   // transpose(inverse(mat3(model))) z CPU (ObjectMatrices)
+uniform mat4 mvp;
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = normalMatrix * aNormal;
     TexCoords = aTexCoords;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    gl_Position = mvp * vec4(aPos, 1.0);
 }
 )";
 
@@ -216,6 +217,7 @@ int main() {
     objectPositions.push_back(glm::vec3(0.0, 0.0, 0.0));
     objectPositions.push_back(glm::vec3(2.0, 0.0, -1.0));
     objectPositions.push_back(glm::vec3(-1.0, 0.0, 2.0));
+    std::vector<InstanceData> cubeObjects;
 
     glm::vec3 lightPos = glm::vec3(2.0, 2.0, 3.0);
     glm::vec3 lightColor = glm::vec3(1.0, 1.0, 1.0);
@@ -237,21 +239,26 @@ int main() {
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 
         gBufferShader.use();
-        gBufferShader.setMat4("projection", projection);
-        gBufferShader.setMat4("view", view);
         gBufferShader.setInt("texture_diffuse1", 0); // Nastavení sampleru
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, containerTexture);
 
-        // Renderování kostek
+        // Renderování kostek - normalove matice a MVP vsech kostek davkove (ObjectMatrices)
+        cubeObjects.resize(objectPositions.size());
         for (unsigned int i = 0; i < objectPositions.size(); i++) {
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, objectPositions[i]);
             // Přidání rotace (jen pro vizuální efekt)
             model = glm::rotate(model, (float)glfwGetTime() * glm::radians(50.0f * (i + 1) * 0.1f), glm::vec3(0.0f, 1.0f, 0.0f));
             model = glm::scale(model, glm::vec3(0.5f));
-            gBufferShader.setMat4("model", model);
+            cubeObjects[i].model = model;
+        }
+        ObjectMatrices::Compute(cubeObjects.data(), cubeObjects.size(), projection * view);
+        for (const InstanceData& cube : cubeObjects) {
+            gBufferShader.setMat4("model", cube.model);
+            gBufferShader.setMat3("normalMatrix", glm::mat3(cube.normalMatrix));
+            gBufferShader.setMat4("mvp", cube.mvp);
             renderCube();
         }
 
@@ -21,6 +21,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "../glbox/TransformBatch.h"
+#include "../glbox/ShaderReflection.h"
+
 // --- GLOBÁLNÍ DATA PRO KAMERU A VSTUPY ---
 
 // Rozměry okna
@@ -202,34 +205,55 @@ public:
         const float rotationSpeed = 0.5f;
         const float sineAmplitude = 5.0f;
 
-        for (size_t i = 0; i < em.entities.size(); ++i) {
+        const size_t count = em.entities.size();
+        if (matrices.size() != count) resize(count);
+        if (count == 0) return;
 
-            if (em.movementTypes[i].type == 1) { // Kruhová rotace
-                float initialAngle = (float)em.entities[i] * (2.0f * M_PI / em.entities.size());
-                float currentAngle = initialAngle + globalTime * rotationSpeed;
+        // faze pohybu do SoA, sin/cos pro vsechny entity jednim SSE pruchodem
+        const float step = 2.0f * (float)M_PI / count;
+        for (size_t i = 0; i < count; ++i) {
+            const MovementTypeComponent& m = em.movementTypes[i];
+            phase[i] = m.type == 1 ? (float)em.entities[i] * step + globalTime * rotationSpeed // Kruhová rotace
+                                   : globalTime * m.speed;                                   // Sinusový pohyb
+        }
+        TransformBatch::SinCos(phase.data(), count, sinPhase.data(), cosPhase.data());
 
-                em.positions[i].x = std::cos(currentAngle) * radius;
-                em.positions[i].z = std::sin(currentAngle) * radius;
+        for (size_t i = 0; i < count; ++i) {
+            PositionComponent& p = em.positions[i];
+            if (em.movementTypes[i].type == 1) {
+                p.x = cosPhase[i] * radius;
+                p.z = sinPhase[i] * radius;
             }
-            else if (em.movementTypes[i].type == 2) { // Sinusový pohyb
-                em.positions[i].y = std::sin(globalTime * em.movementTypes[i].speed) * sineAmplitude;
+            else if (em.movementTypes[i].type == 2) {
+                p.y = sinPhase[i] * sineAmplitude;
             }
 
             // Vlastní rotace krychle
-            em.rotations[i].angle += 2.0f * deltaTime;
+            RotationComponent& r = em.rotations[i];
+            r.angle += 2.0f * deltaTime;
 
-            // Vytvoření lokální matice (Model)
-            glm::mat4 model = glm::mat4(1.0f);
-
-            // 1. Posun
-            model = glm::translate(model, glm::vec3(em.positions[i].x, em.positions[i].y, em.positions[i].z));
+            px[i] = p.x; py[i] = p.y; pz[i] = p.z;
+            ax[i] = r.axisX; ay[i] = r.axisY; az[i] = r.axisZ; angle[i] = r.angle;
+        }
 
-            // 2. Rotace
-            model = glm::rotate(model, em.rotations[i].angle,
-                                glm::vec3(em.rotations[i].axisX, em.rotations[i].axisY, em.rotations[i].axisZ));
+        // osa/uhel -> translate * rotate pro vsechny entity najednou (normalizace i sin/cos v SSE)
+        TransformBatch::ComposeAxisAngle({px.data(), py.data(), pz.data(), ax.data(), ay.data(), az.data(), angle.data(),
+                                          ones.data(), ones.data(), ones.data()},
+                                         count, matrices.data());
+        for (size_t i = 0; i < count; ++i)
+            em.worldMatrices[i].matrix = matrices[i];
+    }
 
-            em.worldMatrices[i].matrix = model;
-        }
+private:
+    std::vector<float> px, py, pz, ax, ay, az, angle, ones;
+    std::vector<float> phase, sinPhase, cosPhase;
+    std::vector<glm::mat4> matrices;
+
+    void resize(size_t count) {
+        for (std::vector<float>* v : {&px, &py, &pz, &ax, &ay, &az, &angle, &phase, &sinPhase, &cosPhase})
+            v->resize(count);
+        ones.assign(count, 1.0f);
+        matrices.resize(count);
     }
 };
 
@@ -456,6 +480,7 @@ int main() {
     // Čištění
     glDeleteVertexArrays(1, &cubeVAO);
     glDeleteBuffers(1, &cubeVBO);
+    ProgramReflection::Forget(shaderProgram);
     glDeleteProgram(shaderProgram);
     glfwTerminate();
     return 0;
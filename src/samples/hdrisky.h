@@ -15,6 +15,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "../glbox/geometry/GeometryRegistry.h"
 
 // --- Prototypy funkcí ---
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -145,8 +146,7 @@ void main()
 }
 )glsl";
 
-unsigned int cubeVAO = 0;
-unsigned int cubeVBO = 0;
+GeometryHandle cubeGeometry;   // kostka P3N3 z GeometryRegistry (chromova kostka i skybox)
 
 int main()
 {
@@ -310,34 +310,40 @@ int main()
 
     glDeleteFramebuffers(1, &captureFBO);
     glDeleteRenderbuffers(1, &captureRBO);
+    cubeGeometry.reset();
     glfwTerminate();
     return 0;
 }
 
 void renderCube()
 {
-    if (cubeVAO == 0)
+    if (!cubeGeometry)
     {
-        float vertices[] = {
-            -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,
-            -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f,
-            -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,  1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f,
-            1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f,
-            -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, -1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f,
-            -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f , 1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, -1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f
-        };
-        glGenVertexArrays(1, &cubeVAO);
-        glGenBuffers(1, &cubeVBO);
-        glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-        glBindVertexArray(cubeVAO);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        cubeGeometry = GeometryRegistry::Get().Acquire(GeometryRegistry::KeyFromParams("cube:P3N3", {1.0f}), [](GpuGeometry& g) {
+            static const float vertices[] = {
+                -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,
+                -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f,
+                -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,  1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f,
+                1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f,
+                -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, -1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, -1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f,
+                -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f , 1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, -1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, -1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f
+            };
+            g.vertexCount = 36;
+            g.vertexStride = 6;
+            g.vertexBytes = sizeof(vertices);
+            glGenVertexArrays(1, &g.VAO);
+            glGenBuffers(1, &g.VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, g.VBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            glBindVertexArray(g.VAO);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        });
     }
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(cubeGeometry->VAO);
+    glDrawArrays(GL_TRIANGLES, 0, cubeGeometry->vertexCount);
     glBindVertexArray(0);
 }
 
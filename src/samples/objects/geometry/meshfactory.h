@@ -19,6 +19,8 @@ namespace MeshFactory {
    inline std::unique_ptr<Mesh> createSphere(float radius = 1.0f, int latSeg = 16, int longSeg = 16) {
         std::vector<float> vertices;
         std::vector<unsigned int> indices;
+        vertices.reserve(size_t(latSeg + 1) * (longSeg + 1) * 3);
+        indices.reserve(size_t(latSeg) * longSeg * 6);
         for (int y=0;y<=latSeg;y++){
             float theta = (float)y * glm::pi<float>() / latSeg;
             for (int x=0;x<=longSeg;x++){
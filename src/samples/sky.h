@@ -95,9 +95,6 @@ int main()
         glm::mat4 projection = glm::perspective(glm::radians(fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 
-        glm::mat4 invProjection = glm::inverse(projection);
-        glm::mat4 invView = glm::inverse(view);
-
         // ================================================================= //
         float time = static_cast<float>(glfwGetTime());
 
@@ -113,20 +110,29 @@ int main()
         // 2. Vypočítáme směr ke slunci z pozice.
         // Pro skydome je to jednoduše normalizovaný vektor pozice.
         glm::vec3 directionToSun = glm::normalize(sunWorldPos);
+
+        // kamera a slunce pro vsechny sky shadery (blok FrameData)
+        FrameUniforms& frameUniforms = FrameUniforms::Get();
+        frameUniforms.data.SetCamera(view, projection, cameraPos, time);
+        frameUniforms.data.sunDirection = glm::vec4(directionToSun, 0.0f);
+        frameUniforms.Upload();
+
         glDisable(GL_DEPTH_TEST);
-        // skydome.Draw(invView, invProjection, directionToSun);
-        //skybox.Draw(view, projection);
-        sky.draw(view, projection);
+        // skydome.Draw();
+        //skybox.Draw();
+        sky.draw();
         glEnable(GL_DEPTH_TEST);
-       //` skydome.Draw(invView, invProjection, directionToSun);
-        //sky.draw(view, projection);
-        // skybox.Draw(view, projection);
+       //` skydome.Draw();
+        //sky.draw();
+        // skybox.Draw();
+        frameUniforms.EndFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
     // glDeleteVertexArrays(1, &skyVAO);
     //  glDeleteProgram(skyShader);
+    FrameUniforms::Get().Release();
     glfwTerminate();
     return 0;
 }
@@ -1,10 +1,25 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 4) in mat4 iModel;   // instancovani (InstanceBuffer)
+layout (location = 12) in mat4 iMVP;
+
+#pragma include FrameData
+#pragma include ShadowCaster
 
-uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+uniform mat4 mvp;
+uniform bool instanced;
+uniform bool prePass;   // depth pre-pass kamerou - stejny vypocet jako PBR, aby prosel GL_EQUAL
+
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    if (prePass) {
+        mat4 MVP = instanced ? iMVP : mvp;
+        gl_Position = MVP * vec4(aPos, 1.0);
+    } else {
+        mat4 m = instanced ? iModel : model;
+        gl_Position = shadowCasterMatrix() * m * vec4(aPos, 1.0);
+    }
 }
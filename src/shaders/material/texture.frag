@@ -7,13 +7,15 @@ in vec3 FragPos;
 in vec4 FragPosLightSpace;
 
 uniform sampler2D diffuseTexture;
-uniform sampler2D shadowMap;
+uniform sampler2DShadow shadowMap;   // createDepthMapFBO: GL_TEXTURE_COMPARE_MODE
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 uniform float ambientStrength;
 
+#pragma include ShadowKernels
+
 float ShadowCalculation(vec4 fragPosLightSpace)
 {
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -26,19 +28,8 @@ float ShadowCalculation(vec4 fragPosLightSpace)
 
        float bias = max(0.005 * (1.0 - dot(Normal, normalize(lightPos - FragPos))), 0.0005);
 
-       float shadow = 0.0;
-       vec2 texelSize = 1.0 / textureSize(shadowMap, 0).xy;
-       for(int x = -1; x <= 1; ++x)
-       {
-           for(int y = -1; y <= 1; ++y)
-           {
-               float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-               shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-           }
-       }
-       shadow /= 9.0;
-
-       return shadow;
+       // 4 bilinearni compare = stanovy filtr 3x3 (sdilene jadro z glbox/ShadowFilter.h)
+       return ShadowPcf4(shadowMap, vec3(projCoords.xy, currentDepth - bias));
 }
 
 void main()
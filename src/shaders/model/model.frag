@@ -10,35 +10,25 @@ in vec3 Bitangent;
 
 uniform sampler2D texture_diffuse;
 uniform sampler2D texture_normal;
-uniform sampler2D shadowMap;
+uniform sampler2DShadow shadowMap;   // createDepthMapFBO: GL_TEXTURE_COMPARE_MODE
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 uniform float ambientStrength;
 
+#pragma include ShadowKernels
+
 float ShadowCalculation(vec4 fragPosLightSpace)
 {
-    // PCF filter (stejny kod jako predtim)
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords = projCoords * 0.5 + 0.5;
     if(projCoords.z > 1.0) return 0.0;
 
     float bias = max(0.005 * (1.0 - dot(Normal, normalize(lightPos - FragPos))), 0.0005);
 
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0).xy;
-    for(int x = -1; x <= 1; ++x)
-    {
-        for(int y = -1; y <= 1; ++y)
-        {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += projCoords.z - bias > pcfDepth ? 1.0 : 0.0;
-        }
-    }
-    shadow /= 9.0;
-
-    return shadow;
+    // hardware PCF: 4 bilinearni compare (sdilene jadro z glbox/ShadowFilter.h)
+    return ShadowPcf4(shadowMap, vec3(projCoords.xy, projCoords.z - bias));
 }
 
 void main()
@@ -13,6 +13,7 @@ out vec3 Tangent;
 out vec3 Bitangent;
 
 uniform mat4 model;
+uniform mat3 normalMatrix;   // transpose(inverse(mat3(model))) - pocita volajici na CPU
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;
@@ -20,9 +21,9 @@ uniform mat4 lightSpaceMatrix;
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    Tangent = mat3(transpose(inverse(model))) * aTangent;
-    Bitangent = mat3(transpose(inverse(model))) * aBitangent;
+    Normal = normalMatrix * aNormal;
+    Tangent = normalMatrix * aTangent;
+    Bitangent = normalMatrix * aBitangent;
     TexCoords = aTexCoords;
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -3,17 +3,21 @@ layout(location=0) in vec3 aPos;
 layout(location=5) in ivec4 aBoneIDs;
 layout(location=6) in vec4 aWeights;
 
+#pragma include FrameData
+#pragma include ShadowCaster
+
 uniform mat4 model;
-uniform mat4 lightSpaceMatrix;
-uniform mat4 uBones[100];
+
+// paleta kosti (BonePalette.h) - 4 texely na kost, uBoneBase = prvni kost modelu
+#pragma include BonePalette
 
 void main() {
     mat4 skinMat = mat4(0.0);
-    skinMat += aWeights.x * uBones[aBoneIDs.x];
-    skinMat += aWeights.y * uBones[aBoneIDs.y];
-    skinMat += aWeights.z * uBones[aBoneIDs.z];
-    skinMat += aWeights.w * uBones[aBoneIDs.w];
+    skinMat += aWeights.x * bone(aBoneIDs.x);
+    skinMat += aWeights.y * bone(aBoneIDs.y);
+    skinMat += aWeights.z * bone(aBoneIDs.z);
+    skinMat += aWeights.w * bone(aBoneIDs.w);
 
     vec4 skinnedPos = skinMat * vec4(aPos,1.0);
-    gl_Position = lightSpaceMatrix * model * skinnedPos;
+    gl_Position = shadowCasterMatrix() * model * skinnedPos;
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+// CPU test sdileni geometrie v GeometryRegistry (kolize klicu z obsahu), bez GL kontextu
+#include <cstdio>
+
+#include "../src/glbox/geometry/GeometryRegistry.h"
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static ContentCheck Content(uint64_t hash) {
+    ContentCheck c;
+    c.vertexBytes = 64;
+    c.indexBytes = 12;
+    c.hash = hash;
+    return c;
+}
+
+int main() {
+    GeometryRegistry& registry = GeometryRegistry::Get();
+    // builder bez GL: jen velikosti (VAO zustava 0, destruktor nic nemaze)
+    auto build = [](GpuGeometry& g) { g.vertexBytes = 64; g.indexBytes = 12; };
+    const uint64_t key = 0x1234u;
+
+    // dva ruzne obsahy se stejnym klicem: druhy jde do presoleneho slotu
+    GeometryHandle a = registry.Acquire(key, Content(1), build);
+    GeometryHandle b = registry.Acquire(key, Content(2), build);
+    Check(a != b, "colliding content gets its own geometry");
+    Check(registry.GetStats().collisions == 1, "collision is counted");
+
+    // prvni zaznam retezce expiruje - ziva shoda dal v retezci se musi najit
+    a.reset();
+    GeometryHandle again = registry.Acquire(key, Content(2), build);
+    Check(again == b, "live match behind an expired entry is reused");
+    Check(registry.GetStats().uploads == 2, "no second upload for the live match");
+
+    // novy obsah bez shody vezme expirovany slot misto prodlouzeni retezce
+    GeometryHandle c = registry.Acquire(key, Content(3), build);
+    Check(registry.GetStats().uploads == 3, "new content is uploaded once");
+    Check(registry.Find(key) == c, "new content reuses the expired slot");
+    Check(registry.Acquire(key, Content(3), build) == c, "reused slot is found again");
+    Check(registry.Acquire(key, Content(2), build) == b, "chain entry stays reachable");
+
+    if (failures == 0) std::printf("GeometryRegistryTest: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
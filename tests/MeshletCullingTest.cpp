@@ -0,0 +1,82 @@
+// CPU test culling predikatu meshletu (Frustum + normal cone), bez GL kontextu
+#include <cstdio>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../src/glbox/geometry/Meshlet.h"
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static glm::mat4 ViewProj(const glm::vec3& eye, const glm::vec3& target) {
+    return glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) *
+           glm::lookAt(eye, target, glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+static bool Visible(const Meshlet& m, const glm::mat4& model, const glm::vec3& eye, bool& byCone) {
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+    const float maxScale = std::max(glm::length(glm::vec3(model[0])),
+                                    std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    return MeshletCuller::IsVisible(m, model, normalMatrix, maxScale, Frustum(ViewProj(eye, glm::vec3(0.0f))), eye, byCone);
+}
+
+int main() {
+    Meshlet m;
+    m.center = glm::vec3(0.0f);
+    m.radius = 0.5f;
+    m.coneApex = glm::vec3(0.0f);
+    m.coneAxis = glm::vec3(1.0f, 0.0f, 0.0f);
+    m.coneCutoff = 0.5f;
+    const glm::mat4 identity(1.0f);
+    bool byCone = false;
+
+    // frustum: koule pred kamerou / za kamerou
+    Frustum frustum(ViewProj(glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(0.0f)));
+    Check(frustum.IntersectsSphere(glm::vec3(0.0f), 0.5f), "sphere in front of camera is inside frustum");
+    Check(!frustum.IntersectsSphere(glm::vec3(20.0f, 0.0f, 0.0f), 0.5f), "sphere behind camera is culled");
+    Check(!frustum.IntersectsSphere(glm::vec3(0.0f, 50.0f, 0.0f), 0.5f), "sphere far to the side is culled");
+
+    // cone: kamera na strane normal = viditelny, za meshletem = odvraceny
+    Check(Visible(m, identity, glm::vec3(10.0f, 0.0f, 0.0f), byCone) && !byCone, "front-facing meshlet is visible");
+    Check(!Visible(m, identity, glm::vec3(-10.0f, 0.0f, 0.0f), byCone) && byCone, "back-facing meshlet is culled by cone");
+
+    // frustum ma prednost: meshlet mimo zaber se nepocita jako cone cull
+    Meshlet outside = m;
+    outside.center = outside.coneApex = glm::vec3(0.0f, 60.0f, 0.0f);
+    Check(!Visible(outside, identity, glm::vec3(10.0f, 0.0f, 0.0f), byCone) && !byCone, "off-screen meshlet is culled by frustum");
+
+    // neuniformni meritko: normala roviny x + y = 0 po scale(4, 1, 1) je normalize(1/4, 1, 0)
+    // (inverse-transpose), mat3(model) by dal normalize(4, 1, 0)
+    Meshlet slanted = m;
+    slanted.coneAxis = glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f));
+    slanted.coneCutoff = 0.9f;
+    const glm::mat4 scaled = glm::scale(identity, glm::vec3(4.0f, 1.0f, 1.0f));
+    const glm::vec3 normal = glm::normalize(glm::vec3(0.25f, 1.0f, 0.0f));
+    Check(!Visible(slanted, scaled, -10.0f * normal, byCone) && byCone, "cone axis follows normal matrix (behind)");
+    Check(Visible(slanted, scaled, 10.0f * normal, byCone), "cone axis follows normal matrix (front)");
+
+    // Cull: viditelne sousedni meshlety se slouci do jednoho rozsahu
+    std::vector<Meshlet> meshlets(3, m);
+    for (unsigned int i = 0; i < 3; ++i) {
+        meshlets[i].firstIndex = i * 30;
+        meshlets[i].triangleCount = 10;
+    }
+    meshlets[1].coneAxis = glm::vec3(-1.0f, 0.0f, 0.0f);
+    MeshletDrawList list;
+    const glm::vec3 eye(10.0f, 0.0f, 0.0f);
+    MeshletCuller::Cull(meshlets, identity, ViewProj(eye, glm::vec3(0.0f)), eye, sizeof(unsigned int), list);
+    Check(list.culledByCone == 1 && list.culledByFrustum == 0, "Cull counts cone-culled meshlet");
+    Check(list.DrawCount() == 2 && list.trianglesSubmitted == 20, "Cull emits two ranges around the culled meshlet");
+
+    meshlets[1].coneAxis = m.coneAxis;
+    MeshletCuller::Cull(meshlets, identity, ViewProj(eye, glm::vec3(0.0f)), eye, sizeof(unsigned int), list);
+    Check(list.DrawCount() == 1 && list.counts[0] == 90, "Cull merges adjacent visible meshlets");
+
+    if (failures == 0) std::printf("MeshletCullingTest: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
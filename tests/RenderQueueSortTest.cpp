@@ -0,0 +1,60 @@
+// CPU test razeni render queue: meshe v GeometryArena se stejnym materialem, bez GL kontextu
+#include <cstdio>
+
+#include "../src/glbox/RenderQueue.h"
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+int main() {
+    // dva meshe v jedne arene = stejny VAO, ruzna geometrie
+    GpuGeometry plane, cube;
+    plane.VAO = cube.VAO = 7;
+
+    RenderQueue queue;
+    const uint32_t planeId = queue.GeometryId(&plane);
+    const uint32_t cubeId = queue.GeometryId(&cube);
+    Check(planeId != cubeId, "arena meshes get distinct geometry ids");
+    Check(queue.GeometryId(&plane) == planeId, "geometry id is stable between frames");
+
+    // stejny program/material/textury, hloubky se prokladaji (cube blize i dal nez plane)
+    std::vector<RenderQueue::SortEntry> entries, scratch;
+    const uint32_t depths[] = { 100, 5000, 200, 4000, 300, 3000, 400, 2000 };
+    for (uint32_t i = 0; i < 8; ++i) {
+        const uint32_t geometry = (i & 1) ? cubeId : planeId;
+        entries.push_back({ RenderQueue::MakeKey(RenderPass::Opaque, 3, 1, 2, geometry, depths[i]), i });
+    }
+    RenderQueue::RadixSort(entries, scratch);
+
+    // kazda geometrie jeden souvisly beh (= jedna instancovana davka), uvnitr front-to-back
+    unsigned int runs = 1;
+    for (size_t i = 1; i < entries.size(); ++i)
+        if ((entries[i].index & 1) != (entries[i - 1].index & 1)) runs++;
+    Check(runs == 2, "same-material arena meshes sort into contiguous runs");
+    bool frontToBack = true;
+    for (size_t i = 1; i < entries.size(); ++i)
+        if ((entries[i].index & 1) == (entries[i - 1].index & 1))
+            frontToBack &= depths[entries[i].index] > depths[entries[i - 1].index];
+    Check(frontToBack, "runs stay front-to-back");
+
+    // shadow klic: stejny program, geometrie drzi castery pohromade
+    entries.clear();
+    for (uint32_t i = 0; i < 8; ++i)
+        entries.push_back({ RenderQueue::MakeKey(RenderPass::Shadow, 4, 0, 0, (i & 1) ? cubeId : planeId, 0), i });
+    RenderQueue::RadixSort(entries, scratch);
+    runs = 1;
+    for (size_t i = 1; i < entries.size(); ++i)
+        if ((entries[i].index & 1) != (entries[i - 1].index & 1)) runs++;
+    Check(runs == 2, "shadow casters of arena meshes sort into contiguous runs");
+
+    plane.VAO = cube.VAO = 0;   // bez GL kontextu destruktor nic nemaze
+
+    if (failures == 0) std::printf("RenderQueueSortTest: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+// CPU test hierarchie transformaci (SceneGraph), bez GL kontextu
+#include <cstdio>
+
+#include "../src/glbox/SceneGraph.h"
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+int main() {
+    SceneGraph graph;
+    Transform rootTransform(glm::vec3(10.0f, 0.0f, 0.0f));
+    const SceneGraph::Node root = graph.Create(SceneGraph::INVALID, &rootTransform);
+    const SceneGraph::Node leaf = graph.Create(root);
+    graph.Update();
+    Check(graph.World(leaf)[3] == glm::vec4(10.0f, 0.0f, 0.0f, 1.0f), "leaf without source follows parent");
+
+    // zdroj na uroven, ktera zadny nemela (bez prestavby poradi)
+    Transform leafTransform(glm::vec3(0.0f, 1.0f, 0.0f));
+    graph.SetSource(leaf, &leafTransform);
+    graph.Update();
+    Check(graph.World(leaf)[3] == glm::vec4(10.0f, 1.0f, 0.0f, 1.0f), "attached source is picked up");
+    graph.Update();
+
+    // dalsi zmena zdroje se musi projevit i po prvnim prepoctu
+    leafTransform.position = glm::vec3(0.0f, 2.0f, 3.0f);
+    graph.Update();
+    Check(graph.World(leaf)[3] == glm::vec4(10.0f, 2.0f, 3.0f, 1.0f), "later source changes keep being polled");
+
+    // odpojeny zdroj: uroven zase bez zdroju, posledni lokalni matice zustava
+    graph.SetSource(leaf, nullptr);
+    leafTransform.position = glm::vec3(0.0f, 5.0f, 0.0f);
+    graph.Update();
+    Check(graph.World(leaf)[3] == glm::vec4(10.0f, 2.0f, 3.0f, 1.0f), "detached source is ignored");
+
+    // zmena rodice se propise do potomka
+    rootTransform.position = glm::vec3(-1.0f, 0.0f, 0.0f);
+    graph.Update();
+    Check(graph.World(leaf)[3] == glm::vec4(-1.0f, 2.0f, 3.0f, 1.0f), "parent change propagates to leaf");
+    Check(graph.GetStats().rebuilds == 1, "source changes do not rebuild the order");
+
+    if (failures == 0) std::printf("SceneGraphTest: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
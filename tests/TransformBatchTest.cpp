@@ -0,0 +1,81 @@
+// CPU test davkoveho skladani matic: SSE cesty proti glm reference, bez GL kontextu
+#include <cstdio>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../src/glbox/TransformBatch.h"
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static float MaxDiff(const glm::mat4& a, const glm::mat4& b) {
+    float diff = 0.0f;
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            diff = std::max(diff, std::abs(a[c][r] - b[c][r]));
+    return diff;
+}
+
+int main() {
+    // 7 objektu = jeden SSE blok + skalarni zbytek
+    const size_t count = 7;
+    std::vector<float> px(count), py(count), pz(count), rx(count), ry(count), rz(count), ones(count, 1.0f);
+    std::vector<float> ax(count), ay(count), az(count), angle(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        px[i] = f * 3.0f - 10.0f; py[i] = 2.0f - f; pz[i] = f * 0.5f;
+        rx[i] = -170.0f + f * 50.0f; ry[i] = 35.0f * f; rz[i] = 300.0f - f * 90.0f;
+        ax[i] = 1.0f + f; ay[i] = f - 3.0f; az[i] = 0.5f;                  // nenormalizovana osa
+        angle[i] = -6.0f + f * 2.1f;
+    }
+
+    // Euler: SSE proti glm translate * rotate(X) * rotate(Y) * rotate(Z)
+    std::vector<glm::mat4> out(count);
+    TransformBatch::ComposeEuler({px.data(), py.data(), pz.data(), rx.data(), ry.data(), rz.data(),
+                                  ones.data(), ones.data(), ones.data()}, count, out.data());
+    float eulerError = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(px[i], py[i], pz[i]));
+        m = glm::rotate(m, glm::radians(rx[i]), glm::vec3(1.0f, 0.0f, 0.0f));
+        m = glm::rotate(m, glm::radians(ry[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+        m = glm::rotate(m, glm::radians(rz[i]), glm::vec3(0.0f, 0.0f, 1.0f));
+        eulerError = std::max(eulerError, MaxDiff(out[i], m));
+    }
+    Check(eulerError <= TransformBatch::MaxErrorTolerance, "ComposeEuler matches glm");
+
+    // osa/uhel: SSE proti glm translate * rotate(angle, axis)
+    TransformBatch::ComposeAxisAngle({px.data(), py.data(), pz.data(), ax.data(), ay.data(), az.data(), angle.data(),
+                                      ones.data(), ones.data(), ones.data()}, count, out.data());
+    float axisError = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::mat4 m = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(px[i], py[i], pz[i])),
+                                        angle[i], glm::vec3(ax[i], ay[i], az[i]));
+        axisError = std::max(axisError, MaxDiff(out[i], m));
+    }
+    Check(axisError <= TransformBatch::MaxErrorTolerance, "ComposeAxisAngle matches glm");
+
+    // davkovy sin/cos proti std: prvni SSE blok jsou velke uhly z globalniho casu (redukce
+    // rozsahu), druhy blok male uhly - 8 prvku = oba bloky jdou pres SSE, bez skalarniho zbytku
+    std::vector<float> angles = {100.0f, -250.0f, 1000.0f, -1000.0f, 0.0f, 1.0f, -2.5f, 3.14159265f}, s(8), c(8);
+    TransformBatch::SinCos(angles.data(), angles.size(), s.data(), c.data());
+    float error[2] = {0.0f, 0.0f};   // [0] velke uhly, [1] male
+    for (size_t i = 0; i < angles.size(); ++i) {
+        const double x = angles[i];   // reference ze stejneho floatu v double
+        const double e = std::max(std::abs(s[i] - std::sin(x)), std::abs(c[i] - std::cos(x)));
+        error[i / 4] = std::max(error[i / 4], static_cast<float>(e));
+    }
+    Check(error[1] <= TransformBatch::MaxErrorTolerance, "SinCos matches std::sin / std::cos");
+    // trojdilna Cody-Waite redukce drzi i pri |x| ~ 1000 (637 * pi/2) presnost floatu vysledku
+    Check(error[0] <= 1e-6f, "SinCos range reduction holds for |x| ~ 1000");
+
+    // vestaveny benchmark sam hlida odchylku vsech cest
+    Check(TransformBatch::Benchmark(1003, 1).Passed(), "Benchmark max error within tolerance");
+
+    if (failures == 0) std::printf("TransformBatchTest: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}